@@ -44,11 +44,5 @@
 #define KIT_TO_PLATFORM_REV   0
 #define KIT_TO_INI_FILENAME   "/cf/kit_to_ini.json"
 
-/******************************************************************************
-** Packet Table Configurations
-*/
-
-#define PKTTBL_JSON_FILE_MAX_CHAR  16384
-
 
 #endif /* _kit_to_platform_cfg_ */
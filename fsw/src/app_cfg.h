@@ -50,10 +50,12 @@
 **       app level commands
 ** 2.1 - Added event log playback
 ** 3.0 - New baseline for separate OSK app repo compatible with cFE Bootes
+** 3.1 - Added output rate limiting, ground feedback rate control and a
+**       contact schedule
 */
 
 #define  KIT_TO_MAJOR_VER     3
-#define  KIT_TO_MINOR_VER     0
+#define  KIT_TO_MINOR_VER     1
 
 
 /******************************************************************************
@@ -67,17 +69,30 @@
 
 #define CFG_APP_CMD_PIPE_NAME      APP_CMD_PIPE_NAME
 #define CFG_APP_CMD_PIPE_DEPTH     APP_CMD_PIPE_DEPTH
+#define CFG_APP_CMD_PIPE_LIMIT     APP_CMD_PIPE_LIMIT       /* Max commands processed per main loop cycle */
 
 #define CFG_APP_RUN_LOOP_DELAY     APP_RUN_LOOP_DELAY       /* Delay in milliseconds for main loop */
 #define CFG_APP_RUN_LOOP_DELAY_MIN APP_RUN_LOOP_DELAY_MIN   /* Minimum command value to set delay  */
 #define CFG_APP_RUN_LOOP_DELAY_MAX APP_RUN_LOOP_DELAY_MAX   /* Maximum command value to set delay  */
 
+#define CFG_APP_STARTUP_DELAY        APP_STARTUP_DELAY         /* Main loop delay (ms) while in startup mode */
+#define CFG_APP_STARTUP_CALM_CYCLES  APP_STARTUP_CALM_CYCLES   /* Consecutive calm output cycles that end startup mode */
+#define CFG_APP_STARTUP_CALM_BACKLOG APP_STARTUP_CALM_BACKLOG  /* Max packets read in a cycle that still counts as calm */
+#define CFG_APP_STARTUP_TIMEOUT      APP_STARTUP_TIMEOUT       /* Max ms in startup mode, 0=No limit */
+
+#define CFG_APP_WAKEUP_ENA         APP_WAKEUP_ENA           /* 1=Main loop pends on wakeup msg, 0=Main loop uses run loop delay */
+#define CFG_APP_WAKEUP_PIPE_NAME   APP_WAKEUP_PIPE_NAME
+#define CFG_APP_WAKEUP_PIPE_DEPTH  APP_WAKEUP_PIPE_DEPTH
+
 #define CFG_KIT_TO_CMD_TOPICID          KIT_TO_CMD_TOPICID
 #define CFG_KIT_TO_SEND_HK_TOPICID      KIT_TO_SEND_HK_TOPICID
+#define CFG_KIT_TO_WAKEUP_TOPICID       KIT_TO_WAKEUP_TOPICID
 #define CFG_KIT_TO_HK_TLM_TOPICID       KIT_TO_HK_TLM_TOPICID
 #define CFG_KIT_TO_DATA_TYPES_TOPICID   KIT_TO_DATA_TYPES_TOPICID
 #define CFG_KIT_TO_PKT_TBL_TLM_TOPICID  KIT_TO_PKT_TBL_TLM_TOPICID
 #define CFG_KIT_TO_EVT_PLBK_TLM_TOPICID KIT_TO_EVT_PLBK_TLM_TOPICID
+#define CFG_KIT_TO_PLAN_TLM_TOPICID     KIT_TO_PLAN_TLM_TOPICID
+#define CFG_KIT_TO_CHANNEL_TLM_TOPICID  KIT_TO_CHANNEL_TLM_TOPICID
 
 #define CFG_PKTMGR_PIPE_NAME    PKTMGR_PIPE_NAME
 #define CFG_PKTMGR_PIPE_DEPTH   PKTMGR_PIPE_DEPTH
@@ -86,13 +101,55 @@
 #define CFG_PKTMGR_STATS_INIT_DELAY    PKTMGR_STATS_INIT_DELAY   /* ms after app initialized to start stats computations   */
 #define CFG_PKTMGR_STATS_CONFIG_DELAY  PKTMGR_STATS_CONFIG_DELAY /* ms after a reconfiguration to start stats computations */
 
+#define CFG_PKTMGR_OUTPUT_PKT_LIMIT    PKTMGR_OUTPUT_PKT_LIMIT   /* Max packets read from pipe per output cycle, 0=No limit */
+#define CFG_PKTMGR_OUTPUT_TIME_LIMIT   PKTMGR_OUTPUT_TIME_LIMIT  /* Max ms spent reading pipe per output cycle, 0=No limit  */
+#define CFG_PKTMGR_LINK_BUDGET         PKTMGR_LINK_BUDGET        /* Reject table loads predicted to exceed this many bytes/sec, 0=No limit */
+
+#define CFG_PKTMGR_FEEDBACK_PORT       PKTMGR_FEEDBACK_PORT      /* UDP port for ground feedback reports, 0=Feedback disabled    */
+#define CFG_PKTMGR_FEEDBACK_MIN_RATE   PKTMGR_FEEDBACK_MIN_RATE  /* Bytes/sec, initial rate and lower bound                      */
+#define CFG_PKTMGR_FEEDBACK_MAX_RATE   PKTMGR_FEEDBACK_MAX_RATE  /* Bytes/sec, upper bound                                       */
+#define CFG_PKTMGR_FEEDBACK_INCREASE   PKTMGR_FEEDBACK_INCREASE  /* Bytes/sec added per loss-free report                         */
+#define CFG_PKTMGR_FEEDBACK_DECREASE   PKTMGR_FEEDBACK_DECREASE  /* Percent of the rate kept after a loss report                 */
+#define CFG_PKTMGR_FEEDBACK_TIMEOUT    PKTMGR_FEEDBACK_TIMEOUT   /* Ms without a report before using the min rate, 0=No timeout */
+
+#define CFG_PKTMGR_SNAPSHOT_PKTS       PKTMGR_SNAPSHOT_PKTS       /* Cached packets sent per output cycle by a snapshot, 0=No limit */
+#define CFG_PKTMGR_SNAPSHOT_ON_ENABLE  PKTMGR_SNAPSHOT_ON_ENABLE  /* 1=Send a snapshot when output is enabled                       */
+
+#define CFG_PKTMGR_REORDER_WINDOW      PKTMGR_REORDER_WINDOW      /* Ms packets are held to send them in packet time order, 0=Disabled */
+
+#define CFG_PKTMGR_CHANNELS            PKTMGR_CHANNELS            /* Number of output channels, 1..PKTMGR_MAX_CHANNELS */
+
+#define CFG_PKTMGR_WORKERS             PKTMGR_WORKERS             /* Output worker tasks per channel, 0=Output on the app task */
+#define CFG_PKTMGR_WORKER_NAME         PKTMGR_WORKER_NAME         /* Channel and worker numbers are appended */
+#define CFG_PKTMGR_WORKER_STACK_SIZE   PKTMGR_WORKER_STACK_SIZE   /* Also used by the pipeline stage tasks */
+#define CFG_PKTMGR_WORKER_PRIORITY     PKTMGR_WORKER_PRIORITY     /* Also used by the pipeline stage tasks */
+#define CFG_PKTMGR_WORKER_TIMEOUT      PKTMGR_WORKER_TIMEOUT      /* Ms beyond the output time limit the app task waits for the workers, also the pipeline drain limit */
+#define CFG_PKTMGR_PIPELINE            PKTMGR_PIPELINE            /* 1=Pack and send on pipeline stage tasks, ignored with workers */
+
 #define CFG_PKTTBL_LOAD_FILE    PKTTBL_LOAD_FILE
 #define CFG_PKTTBL_DUMP_FILE    PKTTBL_DUMP_FILE
 
+#define CFG_PKTTBL_CHILD_NAME        PKTTBL_CHILD_NAME        /* Child task that performs table file I/O */
+#define CFG_PKTTBL_CHILD_STACK_SIZE  PKTTBL_CHILD_STACK_SIZE
+#define CFG_PKTTBL_CHILD_PRIORITY    PKTTBL_CHILD_PRIORITY    /* Should be a lower priority than the app */
+
 #define CFG_EVT_PLBK_HK_PERIOD  EVT_PLBK_HK_PERIOD  /* Number of HK request cycles between event tlm messages */
 #define CFG_EVT_PLBK_LOG_FILE   EVT_PLBK_LOG_FILE 
 
+#define CFG_CONTACT_SCH_LOAD_FILE  CONTACT_SCH_LOAD_FILE
+#define CFG_CONTACT_SCH_DUMP_FILE  CONTACT_SCH_DUMP_FILE
+#define CFG_CONTACT_SCH_ENABLE     CONTACT_SCH_ENABLE     /* 1=Execute the contact schedule at startup */
+
+#define CFG_TLM_REC_WINDOW       TLM_REC_WINDOW       /* Seconds of telemetry kept by the recorder, 0=Recorder disabled */
+#define CFG_TLM_REC_DUMP_PKTS    TLM_REC_DUMP_PKTS    /* Records dumped per output cycle, must be greater than 0       */
+#define CFG_TLM_REC_DUMP_FILE    TLM_REC_DUMP_FILE    /* Default dump file and the file used by the event trigger      */
+#define CFG_TLM_REC_PIPE_NAME    TLM_REC_PIPE_NAME
+#define CFG_TLM_REC_PIPE_DEPTH   TLM_REC_PIPE_DEPTH
+#define CFG_TLM_REC_TRIGGER_APP  TLM_REC_TRIGGER_APP  /* App that sends the trigger event, empty string=No event trigger */
+#define CFG_TLM_REC_TRIGGER_EID  TLM_REC_TRIGGER_EID
+
 #define CFG_EVS_CMD_TOPICID                 EVS_CMD_TOPICID                  /* Name must be identical to the EDS name */
+#define CFG_EVS_LONG_EVENT_TOPICID          EVS_LONG_EVENT_TOPICID           /* Name must be identical to the EDS name */
 #define CFG_CFE_EVS_WRITE_LOG_DATA_FILE_CC  CFE_EVS_WRITE_LOG_DATA_FILE_CC   /* Name must be identical to the EDS name */ 
 
 
@@ -101,25 +158,69 @@
    XX(APP_PERF_ID,uint32) \
    XX(APP_CMD_PIPE_NAME,char*) \
    XX(APP_CMD_PIPE_DEPTH,uint32) \
+   XX(APP_CMD_PIPE_LIMIT,uint32) \
    XX(APP_RUN_LOOP_DELAY,uint32) \
    XX(APP_RUN_LOOP_DELAY_MIN,uint32) \
    XX(APP_RUN_LOOP_DELAY_MAX,uint32) \
+   XX(APP_STARTUP_DELAY,uint32) \
+   XX(APP_STARTUP_CALM_CYCLES,uint32) \
+   XX(APP_STARTUP_CALM_BACKLOG,uint32) \
+   XX(APP_STARTUP_TIMEOUT,uint32) \
+   XX(APP_WAKEUP_ENA,uint32) \
+   XX(APP_WAKEUP_PIPE_NAME,char*) \
+   XX(APP_WAKEUP_PIPE_DEPTH,uint32) \
    XX(KIT_TO_CMD_TOPICID,uint32) \
    XX(KIT_TO_SEND_HK_TOPICID,uint32) \
+   XX(KIT_TO_WAKEUP_TOPICID,uint32) \
    XX(KIT_TO_HK_TLM_TOPICID,uint32) \
    XX(KIT_TO_DATA_TYPES_TOPICID,uint32) \
    XX(KIT_TO_PKT_TBL_TLM_TOPICID,uint32) \
    XX(KIT_TO_EVT_PLBK_TLM_TOPICID,uint32) \
+   XX(KIT_TO_PLAN_TLM_TOPICID,uint32) \
+   XX(KIT_TO_CHANNEL_TLM_TOPICID,uint32) \
    XX(PKTMGR_PIPE_NAME,char*) \
    XX(PKTMGR_PIPE_DEPTH,uint32) \
    XX(PKTMGR_UDP_TLM_PORT,uint32) \
    XX(PKTMGR_STATS_INIT_DELAY,uint32) \
    XX(PKTMGR_STATS_CONFIG_DELAY,uint32) \
+   XX(PKTMGR_OUTPUT_PKT_LIMIT,uint32) \
+   XX(PKTMGR_OUTPUT_TIME_LIMIT,uint32) \
+   XX(PKTMGR_LINK_BUDGET,uint32) \
+   XX(PKTMGR_FEEDBACK_PORT,uint32) \
+   XX(PKTMGR_FEEDBACK_MIN_RATE,uint32) \
+   XX(PKTMGR_FEEDBACK_MAX_RATE,uint32) \
+   XX(PKTMGR_FEEDBACK_INCREASE,uint32) \
+   XX(PKTMGR_FEEDBACK_DECREASE,uint32) \
+   XX(PKTMGR_FEEDBACK_TIMEOUT,uint32) \
+   XX(PKTMGR_SNAPSHOT_PKTS,uint32) \
+   XX(PKTMGR_SNAPSHOT_ON_ENABLE,uint32) \
+   XX(PKTMGR_REORDER_WINDOW,uint32) \
+   XX(PKTMGR_CHANNELS,uint32) \
+   XX(PKTMGR_WORKERS,uint32) \
+   XX(PKTMGR_WORKER_NAME,char*) \
+   XX(PKTMGR_WORKER_STACK_SIZE,uint32) \
+   XX(PKTMGR_WORKER_PRIORITY,uint32) \
+   XX(PKTMGR_WORKER_TIMEOUT,uint32) \
+   XX(PKTMGR_PIPELINE,uint32) \
    XX(PKTTBL_LOAD_FILE,char*) \
    XX(PKTTBL_DUMP_FILE,char*) \
+   XX(PKTTBL_CHILD_NAME,char*) \
+   XX(PKTTBL_CHILD_STACK_SIZE,uint32) \
+   XX(PKTTBL_CHILD_PRIORITY,uint32) \
    XX(EVT_PLBK_HK_PERIOD,uint32) \
    XX(EVT_PLBK_LOG_FILE,char*) \
+   XX(CONTACT_SCH_LOAD_FILE,char*) \
+   XX(CONTACT_SCH_DUMP_FILE,char*) \
+   XX(CONTACT_SCH_ENABLE,uint32) \
+   XX(TLM_REC_WINDOW,uint32) \
+   XX(TLM_REC_DUMP_PKTS,uint32) \
+   XX(TLM_REC_DUMP_FILE,char*) \
+   XX(TLM_REC_PIPE_NAME,char*) \
+   XX(TLM_REC_PIPE_DEPTH,uint32) \
+   XX(TLM_REC_TRIGGER_APP,char*) \
+   XX(TLM_REC_TRIGGER_EID,uint32) \
    XX(EVS_CMD_TOPICID,uint32) \
+   XX(EVS_LONG_EVENT_TOPICID,uint32) \
    XX(CFE_EVS_WRITE_LOG_DATA_FILE_CC,uint32) \
 
 DECLARE_ENUM(Config,APP_CONFIG)
@@ -144,6 +245,22 @@ DECLARE_ENUM(Config,APP_CONFIG)
 #define KIT_TO_EVT_PLBK_START_CMD_FC     (CMDMGR_APP_START_FC + 10)
 #define KIT_TO_EVT_PLBK_STOP_CMD_FC      (CMDMGR_APP_START_FC + 11)
 
+#define KIT_TO_PLAN_TBL_CMD_FC           (CMDMGR_APP_START_FC + 12)
+#define KIT_TO_BULK_ADD_PKT_CMD_FC       (CMDMGR_APP_START_FC + 13)
+#define KIT_TO_BULK_REMOVE_PKT_CMD_FC    (CMDMGR_APP_START_FC + 14)
+#define KIT_TO_BULK_UPDATE_FILTER_CMD_FC (CMDMGR_APP_START_FC + 15)
+#define KIT_TO_SWITCH_PROFILE_CMD_FC     (CMDMGR_APP_START_FC + 16)
+
+#define KIT_TO_CONTACT_SCH_START_CMD_FC  (CMDMGR_APP_START_FC + 17)
+#define KIT_TO_CONTACT_SCH_STOP_CMD_FC   (CMDMGR_APP_START_FC + 18)
+
+#define KIT_TO_SNAPSHOT_CMD_FC           (CMDMGR_APP_START_FC + 19)
+
+#define KIT_TO_TLM_REC_FREEZE_CMD_FC     (CMDMGR_APP_START_FC + 20)
+#define KIT_TO_TLM_REC_RESUME_CMD_FC     (CMDMGR_APP_START_FC + 21)
+
+#define KIT_TO_SELECT_CHANNEL_CMD_FC     (CMDMGR_APP_START_FC + 22)
+
 
 /******************************************************************************
 ** Event Macros
@@ -157,6 +274,8 @@ DECLARE_ENUM(Config,APP_CONFIG)
 #define PKTTBL_BASE_EID      (OSK_C_FW_APP_BASE_EID + 100)
 #define PKTMGR_BASE_EID      (OSK_C_FW_APP_BASE_EID + 200)
 #define EVT_PLBK_BASE_EID    (OSK_C_FW_APP_BASE_EID + 300)
+#define CONTACT_SCH_BASE_EID (OSK_C_FW_APP_BASE_EID + 400)
+#define TLM_REC_BASE_EID     (OSK_C_FW_APP_BASE_EID + 500)
 
 /*
 ** One event ID is used for all initialization debug messages. Uncomment one of
@@ -181,4 +300,93 @@ DECLARE_ENUM(Config,APP_CONFIG)
 #define EVT_PLBK_EVENTS_PER_TLM_MSG   4  
 
 
+/******************************************************************************
+** pktmgr.h Configurations
+**
+** - PKTMGR_RETRY_QUEUE_LEN is the number of packed datagrams that are held for
+**   retransmission after a transient socket send failure. Each entry holds a
+**   maximum size packed telemetry packet so keep the queue small.
+** - PKTMGR_SEND_ERR_LIMIT is the number of consecutive OS_ERROR send
+**   failures that are retried before the error is treated as hard and
+**   output is suppressed. OSAL returns OS_ERROR for every network stack
+**   failure so a persistent failure is the only sign of a hard one.
+** - PKTMGR_PLAN_ENTRY_MAX is the number of under-sized BufLim entries that
+**   are reported in the table plan telemetry packet.
+** - PKTMGR_BULK_ENTRY_MAX is the number of entries carried by the bulk add,
+**   remove and update filter commands.
+** - PKTMGR_COALESCE_SLOTS is the number of coalescing packets that can be
+**   held in one output cycle and PKTMGR_COALESCE_MSG_MAX_LEN is the largest
+**   packet that can be held. Coalescing packets that don't fit are sent
+**   normally.
+** - PKTMGR_LVC_POOL_SIZE is the number of bytes shared by the packed last
+**   values of all packet table entries.
+** - PKTMGR_REORDER_LEN is the number of packed datagrams the time ordering
+**   stage can hold. Like the retry queue each entry holds a maximum size
+**   packed telemetry packet. The oldest packet is released early when it's
+**   full so size it for the reorder window at the peak output packet rate.
+** - PKTMGR_MAX_CHANNELS is the number of independent output channels that
+**   can be configured. Each channel has its own copy of the queues and pools
+**   above.
+** - PKTMGR_MAX_WORKERS is the number of output worker tasks a channel can
+**   have. Each worker has its own pipe, socket and packing buffer.
+** - PKTMGR_PIPELINE_LEN is the number of slots in each output pipeline ring
+**   and must be a power of 2. PKTMGR_PIPELINE_MSG_MAX_LEN is the largest
+**   packet a receive ring slot holds. Larger packets wait for the pipeline
+**   to empty and are packed and sent by the app task.
+*/
+
+#define PKTMGR_RETRY_QUEUE_LEN         8
+#define PKTMGR_SEND_ERR_LIMIT         16
+#define PKTMGR_PLAN_ENTRY_MAX         16
+#define PKTMGR_BULK_ENTRY_MAX         32
+#define PKTMGR_COALESCE_SLOTS         16
+#define PKTMGR_COALESCE_MSG_MAX_LEN  512
+#define PKTMGR_LVC_POOL_SIZE       32768
+#define PKTMGR_REORDER_LEN            32
+#define PKTMGR_MAX_CHANNELS            4
+#define PKTMGR_MAX_WORKERS             4
+#define PKTMGR_PIPELINE_LEN           16
+#define PKTMGR_PIPELINE_MSG_MAX_LEN 1024
+
+
+/******************************************************************************
+** contact_sch.h Configurations
+**
+** - CONTACT_SCH_MAX_WINDOWS is the number of contact windows in a schedule
+**   table. Schedules are expected to be reloaded as contacts are planned.
+*/
+
+#define CONTACT_SCH_MAX_WINDOWS          16
+#define CONTACT_SCH_JSON_FILE_MAX_CHAR 4000
+
+
+/******************************************************************************
+** tlm_rec.h Configurations
+**
+** - TLM_REC_BUF_SIZE is the number of bytes in the recorder's ring. It bounds
+**   the recorder's memory regardless of the configured window so size it for
+**   the window at the peak subscribed packet rate. Each record has an 8 byte
+**   header and is padded to a 4 byte boundary.
+*/
+
+#define TLM_REC_BUF_SIZE  131072
+
+
+/******************************************************************************
+** Shared Utilities
+*/
+
+/*
+** Return the number of milliseconds from StartTime to the current time.
+*/
+static inline uint32 KIT_TO_ElapsedMilliSecs(CFE_TIME_SysTime_t StartTime)
+{
+
+   CFE_TIME_SysTime_t DeltaTime = CFE_TIME_Subtract(CFE_TIME_GetTime(), StartTime);
+   
+   return (DeltaTime.Seconds*1000 + CFE_TIME_Sub2MicroSecs(DeltaTime.Subseconds)/1000);
+
+}
+
+
 #endif /* _app_cfg_ */
@@ -0,0 +1,706 @@
+/*
+**  Copyright 2022 bitValence, Inc.
+**  All Rights Reserved.
+**
+**  This program is free software; you can modify and/or redistribute it
+**  under the terms of the GNU Affero General Public License
+**  as published by the Free Software Foundation; version 3 with
+**  attribution addendums as found in the LICENSE.txt
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Affero General Public License for more details.
+**
+**  Purpose:
+**    Implement KIT_TO's contact schedule.
+**
+**  Notes:
+**    None
+**
+**  References:
+**    1. OpenSatKit Object-based Application Developer's Guide
+**    2. cFS Application Developer's Guide
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "contact_sch.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define NO_EVENT_TIME  0xFFFFFFFF
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+/* See LoadJsonData() prologue for details */
+
+typedef CJSON_IntObj_t JsonStart_t;
+typedef CJSON_IntObj_t JsonStop_t;
+typedef CJSON_IntObj_t JsonPreQueue_t;
+typedef CJSON_IntObj_t JsonRateLimit_t;
+
+typedef struct
+{
+   CJSON_Obj_t  Obj;
+   char         Value[PKTMGR_IP_STR_LEN];
+} JsonDestIp_t;
+
+typedef struct
+{
+   CJSON_Obj_t  Obj;
+   char         Value[PKTTBL_PROFILE_NAME_LEN];
+} JsonProfile_t;
+
+typedef struct
+{
+   JsonStart_t      Start;
+   JsonStop_t       Stop;
+   JsonPreQueue_t   PreQueue;
+   JsonRateLimit_t  RateLimit;
+   JsonDestIp_t     DestIp;
+   JsonProfile_t    Profile;
+
+} JsonWindow_t;
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static CONTACT_SCH_Class_t  *Instance[CONTACT_SCH_MAX_INSTANCES];
+static uint16               InstanceCnt = 0;
+
+/* CJSON_ProcessFile()'s callback has no context so the instance is saved for the load */
+static CONTACT_SCH_Class_t  *LoadInstance = NULL;
+
+static const char *StateStr[] = { "UNDEF", "DISABLED", "LOS", "PRE-QUEUE", "AOS" };
+
+
+/******************************/
+/** File Function Prototypes **/
+/******************************/
+
+static void ConstructJsonWindow(JsonWindow_t *JsonWindow, uint16 WindowArrayIdx);
+static void EnterState(CONTACT_SCH_Class_t *ContactSch, uint8 NewState, uint32 Now);
+static CONTACT_SCH_Class_t *GetInstance(const TBLMGR_Tbl_t *Tbl);
+static bool LoadJsonData(size_t JsonFileLen);
+static bool ValidProfiles(CONTACT_SCH_Class_t *ContactSch, const CONTACT_SCH_Data_t *TblData);
+static bool ValidWindow(const CONTACT_SCH_Window_t *Window, const CONTACT_SCH_Window_t *PrevWindow, uint16 WindowIdx);
+
+
+/******************************************************************************
+** Function: CONTACT_SCH_Constructor
+**
+*/
+void CONTACT_SCH_Constructor(CONTACT_SCH_Class_t *ContactSch, INITBL_Class_t *IniTbl,
+                             uint8 TblId, PKTMGR_Class_t *PktMgr)
+{
+
+   memset((void*)ContactSch, 0, sizeof(CONTACT_SCH_Class_t));
+
+   ContactSch->TblId          = TblId;
+   ContactSch->PktMgr         = PktMgr;
+   ContactSch->Enabled        = (INITBL_GetIntConfig(IniTbl, CFG_CONTACT_SCH_ENABLE) != 0);
+   ContactSch->Reevaluate     = true;
+   ContactSch->State          = CONTACT_SCH_STATE_DISABLED;
+   ContactSch->LastLoadStatus = TBLMGR_STATUS_UNDEF;
+
+   if (InstanceCnt < CONTACT_SCH_MAX_INSTANCES)
+   {
+      Instance[InstanceCnt++] = ContactSch;
+   }
+   else
+   {
+      CFE_EVS_SendEvent(CONTACT_SCH_INSTANCE_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Contact schedule instance limit %d exceeded. Table ID %d can't be loaded or dumped",
+                        CONTACT_SCH_MAX_INSTANCES, TblId);
+   }
+
+} /* End CONTACT_SCH_Constructor() */
+
+
+/******************************************************************************
+** Function: CONTACT_SCH_DumpCmd
+**
+** Notes:
+**  1. Can assume valid table file name because this is a callback from
+**     the app framework table manager that has verified the file.
+**  2. DumpType is unused.
+**  3. Creates a new dump file, overwriting anything that may have existed
+**     previously
+*/
+bool CONTACT_SCH_DumpCmd(TBLMGR_Tbl_t *Tbl, uint8 DumpType, const char *Filename)
+{
+
+   bool          RetStatus = false;
+   osal_id_t     FileHandle;
+   int32         OsStatus;
+   uint16        i;
+   const CONTACT_SCH_Window_t *Window;
+   char          DumpRecord[256];
+   char          SysTimeStr[256];
+   os_err_name_t OsErrStr;
+   CONTACT_SCH_Class_t *ContactSch = GetInstance(Tbl);
+
+   if (ContactSch == NULL) return false;
+
+   OsStatus = OS_OpenCreate(&FileHandle, Filename, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_READ_WRITE);
+
+   if (OsStatus == OS_SUCCESS)
+   {
+
+      sprintf(DumpRecord,"\n{\n\"name\": \"Kit Telemetry Output (KIT_TO) Contact Schedule\",\n");
+      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+      CFE_TIME_Print(SysTimeStr, CFE_TIME_GetTime());
+
+      sprintf(DumpRecord,"\"description\": \"KIT_TO dumped at %s\",\n",SysTimeStr);
+      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+      sprintf(DumpRecord,"\"window-array\": [\n");
+      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+      for (i=0; i < ContactSch->Data.WindowCnt; i++)
+      {
+
+         Window = &(ContactSch->Data.Window[i]);
+
+         sprintf(DumpRecord,"%s\"window\": {\n   \"start\": %u,\n   \"stop\": %u,\n   \"pre-queue\": %u,\n   \"rate-limit\": %u,\n",
+                 (i == 0 ? "" : ",\n"), (unsigned int)Window->Start, (unsigned int)Window->Stop,
+                 (unsigned int)Window->PreQueue, (unsigned int)Window->RateLimit);
+         OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+         sprintf(DumpRecord,"   \"dest-ip\": \"%s\",\n   \"profile\": \"%s\"\n}", Window->DestIp, Window->Profile);
+         OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+      } /* End window loop */
+
+      sprintf(DumpRecord,"\n]}\n");
+      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+      RetStatus = true;
+
+      OS_close(FileHandle);
+
+   } /* End if file create */
+   else
+   {
+      OS_GetErrorName(OsStatus, &OsErrStr);
+      CFE_EVS_SendEvent(CONTACT_SCH_CREATE_FILE_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating contact schedule dump file '%s', Status = %s",
+                        Filename, OsErrStr);
+
+   } /* End if file create error */
+
+   return RetStatus;
+
+} /* End of CONTACT_SCH_DumpCmd() */
+
+
+/******************************************************************************
+** Function: CONTACT_SCH_Execute
+**
+** Notes:
+**   1. WindowIdx only moves forward so ended windows are skipped once. A
+**      backwards time change restarts the search from the first window.
+**   2. A window with an empty profile leaves the active profile unchanged.
+**   3. A schedule loaded before the packet table isn't run until its
+**      profiles have been checked against the packet table.
+*/
+void CONTACT_SCH_Execute(CONTACT_SCH_Class_t *ContactSch)
+{
+
+   const CONTACT_SCH_Window_t *Window;
+   uint32  Now;
+   uint16  PrevWindowIdx;
+   uint8   NewState;
+
+   if (!ContactSch->Enabled || !ContactSch->Loaded) return;
+
+   if (!ContactSch->ProfilesChecked)
+   {
+      if (!ContactSch->PktMgr->PktTbl.Loaded) return;
+      if (!ValidProfiles(ContactSch, &ContactSch->Data))
+      {
+         ContactSch->Loaded = false;
+         ContactSch->LastLoadStatus = TBLMGR_STATUS_INVALID;
+         return;
+      }
+      ContactSch->ProfilesChecked = true;
+   }
+
+   Now = CFE_TIME_GetTime().Seconds;
+
+   if (!ContactSch->Reevaluate && (Now >= ContactSch->LastEvalTime) &&
+       (Now < ContactSch->NextEventTime)) return;
+
+   if (Now < ContactSch->LastEvalTime) ContactSch->WindowIdx = 0;
+   ContactSch->LastEvalTime = Now;
+
+   PrevWindowIdx = ContactSch->WindowIdx;
+   while ((ContactSch->WindowIdx < ContactSch->Data.WindowCnt) &&
+          (Now >= ContactSch->Data.Window[ContactSch->WindowIdx].Stop))
+   {
+      ContactSch->WindowIdx++;
+   }
+
+   if (ContactSch->WindowIdx >= ContactSch->Data.WindowCnt)
+   {
+      NewState = CONTACT_SCH_STATE_LOS;
+      ContactSch->NextEventTime = NO_EVENT_TIME;
+   }
+   else
+   {
+      Window = &(ContactSch->Data.Window[ContactSch->WindowIdx]);
+      if (Now >= Window->Start)
+      {
+         NewState = CONTACT_SCH_STATE_AOS;
+         ContactSch->NextEventTime = Window->Stop;
+      }
+      else if (Now >= (Window->Start - Window->PreQueue))
+      {
+         NewState = CONTACT_SCH_STATE_PREQUEUE;
+         ContactSch->NextEventTime = Window->Start;
+      }
+      else
+      {
+         NewState = CONTACT_SCH_STATE_LOS;
+         ContactSch->NextEventTime = Window->Start - Window->PreQueue;
+      }
+   }
+
+   /* Back-to-back windows change the window without changing the state */
+   if (ContactSch->Reevaluate || (NewState != ContactSch->State) ||
+       ((NewState != CONTACT_SCH_STATE_LOS) && (ContactSch->WindowIdx != PrevWindowIdx)))
+   {
+      EnterState(ContactSch, NewState, Now);
+   }
+
+   ContactSch->Reevaluate = false;
+
+} /* End CONTACT_SCH_Execute() */
+
+
+/******************************************************************************
+** Function: CONTACT_SCH_LoadCmd
+**
+** Notes:
+**  1. Can assume valid table file name because this is a callback from
+**     the app framework table manager that has verified the file.
+**  2. Loads are performed on the app task so only one instance is loaded
+**     at a time.
+*/
+bool CONTACT_SCH_LoadCmd(TBLMGR_Tbl_t *Tbl, uint8 LoadType, const char *Filename)
+{
+
+   bool  RetStatus = false;
+   CONTACT_SCH_Class_t *ContactSch = GetInstance(Tbl);
+
+   if (ContactSch == NULL) return false;
+
+   LoadInstance = ContactSch;
+   RetStatus = CJSON_ProcessFile(Filename, ContactSch->JsonBuf, CONTACT_SCH_JSON_FILE_MAX_CHAR, LoadJsonData);
+   LoadInstance = NULL;
+
+   if (RetStatus)
+   {
+      ContactSch->Loaded = true;
+      ContactSch->LastLoadStatus = TBLMGR_STATUS_VALID;
+   }
+   else
+   {
+      ContactSch->LastLoadStatus = TBLMGR_STATUS_INVALID;
+   }
+
+   return RetStatus;
+
+} /* End CONTACT_SCH_LoadCmd() */
+
+
+/******************************************************************************
+** Function: CONTACT_SCH_ResetStatus
+**
+*/
+void CONTACT_SCH_ResetStatus(CONTACT_SCH_Class_t *ContactSch)
+{
+
+   ContactSch->LastLoadStatus = TBLMGR_STATUS_UNDEF;
+   ContactSch->LastLoadCnt = 0;
+
+} /* End CONTACT_SCH_ResetStatus() */
+
+
+/******************************************************************************
+** Function: CONTACT_SCH_StartCmd
+**
+*/
+bool CONTACT_SCH_StartCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   CONTACT_SCH_Class_t *ContactSch = (CONTACT_SCH_Class_t *)ObjDataPtr;
+
+   ContactSch->Enabled    = true;
+   ContactSch->Reevaluate = true;
+   ContactSch->WindowIdx  = 0;
+
+   CFE_EVS_SendEvent(CONTACT_SCH_START_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                     "Contact schedule started with %d windows%s", ContactSch->Data.WindowCnt,
+                     (ContactSch->Loaded ? "" : ", waiting for a table load"));
+
+   return true;
+
+} /* End CONTACT_SCH_StartCmd() */
+
+
+/******************************************************************************
+** Function: CONTACT_SCH_StopCmd
+**
+*/
+bool CONTACT_SCH_StopCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   CONTACT_SCH_Class_t *ContactSch = (CONTACT_SCH_Class_t *)ObjDataPtr;
+
+   ContactSch->Enabled = false;
+   ContactSch->State   = CONTACT_SCH_STATE_DISABLED;
+
+   PKTMGR_HoldOutput(ContactSch->PktMgr, false);
+   PKTMGR_SetRateLimit(ContactSch->PktMgr, 0);
+
+   CFE_EVS_SendEvent(CONTACT_SCH_STOP_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                     "Contact schedule stopped, telemetry output state unchanged");
+
+   return true;
+
+} /* End CONTACT_SCH_StopCmd() */
+
+
+/******************************************************************************
+** Function: ConstructJsonWindow
+**
+*/
+static void ConstructJsonWindow(JsonWindow_t *JsonWindow, uint16 WindowArrayIdx)
+{
+
+   char KeyStr[64];
+
+   sprintf(KeyStr,"window-array[%d].window.start", WindowArrayIdx);
+   CJSON_ObjConstructor(&JsonWindow->Start.Obj, KeyStr, JSONNumber, &JsonWindow->Start.Value, 4);
+
+   sprintf(KeyStr,"window-array[%d].window.stop", WindowArrayIdx);
+   CJSON_ObjConstructor(&JsonWindow->Stop.Obj, KeyStr, JSONNumber, &JsonWindow->Stop.Value, 4);
+
+   sprintf(KeyStr,"window-array[%d].window.pre-queue", WindowArrayIdx);
+   CJSON_ObjConstructor(&JsonWindow->PreQueue.Obj, KeyStr, JSONNumber, &JsonWindow->PreQueue.Value, 4);
+
+   sprintf(KeyStr,"window-array[%d].window.rate-limit", WindowArrayIdx);
+   CJSON_ObjConstructor(&JsonWindow->RateLimit.Obj, KeyStr, JSONNumber, &JsonWindow->RateLimit.Value, 4);
+
+   sprintf(KeyStr,"window-array[%d].window.dest-ip", WindowArrayIdx);
+   CJSON_ObjConstructor(&JsonWindow->DestIp.Obj, KeyStr, JSONString, JsonWindow->DestIp.Value, PKTMGR_IP_STR_LEN);
+
+   sprintf(KeyStr,"window-array[%d].window.profile", WindowArrayIdx);
+   CJSON_ObjConstructor(&JsonWindow->Profile.Obj, KeyStr, JSONString, JsonWindow->Profile.Value, PKTTBL_PROFILE_NAME_LEN);
+
+} /* ConstructJsonWindow() */
+
+
+/******************************************************************************
+** Function: EnterState
+**
+** Notes:
+**   1. Output is enabled before the hold is released so the pre-queued
+**      packets are sent to the window's destination.
+**   2. The profile was already switched if the window had a pre-queue period.
+**   3. Releasing the hold at LOS lets PKTMGR drain packets queued for a
+**      cancelled or missed window without sending them.
+*/
+static void EnterState(CONTACT_SCH_Class_t *ContactSch, uint8 NewState, uint32 Now)
+{
+
+   const CONTACT_SCH_Window_t *Window = &(ContactSch->Data.Window[ContactSch->WindowIdx]);
+
+   switch (NewState)
+   {
+
+      case CONTACT_SCH_STATE_PREQUEUE:
+         if (Window->Profile[0] != '\0') PKTMGR_SwitchProfile(ContactSch->PktMgr, Window->Profile);
+         PKTMGR_HoldOutput(ContactSch->PktMgr, true);
+         break;
+
+      case CONTACT_SCH_STATE_AOS:
+         if ((Window->Profile[0] != '\0') && (ContactSch->State != CONTACT_SCH_STATE_PREQUEUE))
+         {
+            PKTMGR_SwitchProfile(ContactSch->PktMgr, Window->Profile);
+         }
+         PKTMGR_SetRateLimit(ContactSch->PktMgr, Window->RateLimit);
+         PKTMGR_EnableOutput(ContactSch->PktMgr, Window->DestIp);
+         PKTMGR_HoldOutput(ContactSch->PktMgr, false);
+         break;
+
+      default:
+         PKTMGR_DisableOutput(ContactSch->PktMgr);
+         PKTMGR_HoldOutput(ContactSch->PktMgr, false);
+         PKTMGR_SetRateLimit(ContactSch->PktMgr, 0);
+         break;
+
+   } /* End state switch */
+
+   CFE_EVS_SendEvent(CONTACT_SCH_TRANSITION_EID, CFE_EVS_EventType_INFORMATION,
+                     "Contact schedule %s to %s at %u, window %d of %d, next transition %u",
+                     StateStr[ContactSch->State], StateStr[NewState], (unsigned int)Now,
+                     ContactSch->WindowIdx, ContactSch->Data.WindowCnt,
+                     (unsigned int)ContactSch->NextEventTime);
+
+   ContactSch->State = NewState;
+
+} /* End EnterState() */
+
+
+/******************************************************************************
+** Function: GetInstance
+**
+** Return the schedule instance registered with the table manager as Tbl,
+** NULL if there isn't one.
+*/
+static CONTACT_SCH_Class_t *GetInstance(const TBLMGR_Tbl_t *Tbl)
+{
+
+   uint16 i;
+
+   for (i=0; i < InstanceCnt; i++)
+   {
+      if (Instance[i]->TblId == Tbl->Id) return Instance[i];
+   }
+
+   CFE_EVS_SendEvent(CONTACT_SCH_INSTANCE_ERR_EID, CFE_EVS_EventType_ERROR,
+                     "No contact schedule instance has table ID %d", Tbl->Id);
+
+   return NULL;
+
+} /* End GetInstance() */
+
+
+/******************************************************************************
+** Function: LoadJsonData
+**
+** Notes:
+**  1. The JSON file can contain 0 to CONTACT_SCH_MAX_WINDOWS entries. An
+**     empty schedule keeps output disabled while the schedule is enabled.
+**  2. JSON "window-array" contains the following "window" object entries
+**       {"window": {
+**          "start": 1000,             # AOS, spacecraft time seconds
+**          "stop": 1600,              # LOS, spacecraft time seconds
+**          "pre-queue": 60,           # Optional, seconds before start
+**          "rate-limit": 20000,       # Optional, bytes per second
+**          "dest-ip": "127.0.0.1",
+**          "profile": "contact"       # Optional packet table profile
+**       }},
+**  3. The instance being loaded is LoadInstance, see CONTACT_SCH_LoadCmd().
+**
+*/
+static bool LoadJsonData(size_t JsonFileLen)
+{
+
+   CONTACT_SCH_Class_t *ContactSch = LoadInstance;
+   CONTACT_SCH_Data_t  *TblData    = &(LoadInstance->Stage);
+
+   bool    RetStatus = true;
+   bool    ReadWindow = true;
+   uint16  AttributeCnt;
+   uint16  WindowArrayIdx;
+
+   JsonWindow_t          JsonWindow;
+   CONTACT_SCH_Window_t  *Window;
+
+   ContactSch->JsonFileLen = JsonFileLen;
+
+   /*
+   ** The whole schedule is replaced so the working buffer starts empty
+   */
+
+   memset(TblData, 0, sizeof(CONTACT_SCH_Data_t));
+
+   WindowArrayIdx = 0;
+   while (ReadWindow)
+   {
+
+      ConstructJsonWindow(&JsonWindow, WindowArrayIdx);
+      memset(JsonWindow.DestIp.Value, 0, PKTMGR_IP_STR_LEN);
+      memset(JsonWindow.Profile.Value, 0, PKTTBL_PROFILE_NAME_LEN);
+      JsonWindow.PreQueue.Value  = 0;
+      JsonWindow.RateLimit.Value = 0;
+
+      /*
+      ** Use 'start' field to determine whether processing the file is
+      ** complete. See the packet table's LoadJsonData() for details.
+      */
+
+      if (CJSON_LoadObjOptional(&JsonWindow.Start.Obj, ContactSch->JsonBuf, ContactSch->JsonFileLen))
+      {
+
+         if (WindowArrayIdx >= CONTACT_SCH_MAX_WINDOWS)
+         {
+            CFE_EVS_SendEvent(CONTACT_SCH_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "Contact schedule has more than the maximum %d windows",
+                              CONTACT_SCH_MAX_WINDOWS);
+            RetStatus = false;
+            break;
+         }
+
+         AttributeCnt = 0;
+         if (CJSON_LoadObj(&JsonWindow.Stop.Obj,   ContactSch->JsonBuf, ContactSch->JsonFileLen)) AttributeCnt++;
+         if (CJSON_LoadObj(&JsonWindow.DestIp.Obj, ContactSch->JsonBuf, ContactSch->JsonFileLen)) AttributeCnt++;
+         CJSON_LoadObjOptional(&JsonWindow.PreQueue.Obj,  ContactSch->JsonBuf, ContactSch->JsonFileLen);
+         CJSON_LoadObjOptional(&JsonWindow.RateLimit.Obj, ContactSch->JsonBuf, ContactSch->JsonFileLen);
+         CJSON_LoadObjOptional(&JsonWindow.Profile.Obj,   ContactSch->JsonBuf, ContactSch->JsonFileLen);
+
+         if (AttributeCnt != 2)
+         {
+            CFE_EVS_SendEvent(CONTACT_SCH_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "Window[%d] has missing attributes, stop and dest-ip are required",
+                              WindowArrayIdx);
+            RetStatus = false;
+            break;
+         }
+
+         Window = &TblData->Window[WindowArrayIdx];
+         Window->Start     = (uint32)JsonWindow.Start.Value;
+         Window->Stop      = (uint32)JsonWindow.Stop.Value;
+         Window->PreQueue  = (uint32)JsonWindow.PreQueue.Value;
+         Window->RateLimit = (uint32)JsonWindow.RateLimit.Value;
+         strncpy(Window->DestIp,  JsonWindow.DestIp.Value,  PKTMGR_IP_STR_LEN);
+         strncpy(Window->Profile, JsonWindow.Profile.Value, PKTTBL_PROFILE_NAME_LEN);
+         Window->DestIp[PKTMGR_IP_STR_LEN-1] = '\0';
+         Window->Profile[PKTTBL_PROFILE_NAME_LEN-1] = '\0';
+
+         if (!ValidWindow(Window, (WindowArrayIdx == 0 ? NULL : &TblData->Window[WindowArrayIdx-1]), WindowArrayIdx))
+         {
+            RetStatus = false;
+            break;
+         }
+
+         WindowArrayIdx++;
+
+      } /* End if 'start' */
+      else
+      {
+         ReadWindow = false;
+      }
+
+   } /* End ReadWindow */
+
+   /*
+   ** The packet table file load at startup may still be in progress so
+   ** profiles are checked by CONTACT_SCH_Execute() once it completes
+   */
+
+   TblData->WindowCnt = WindowArrayIdx;
+   if (RetStatus && ContactSch->PktMgr->PktTbl.Loaded)
+   {
+      RetStatus = ValidProfiles(ContactSch, TblData);
+   }
+
+   if (RetStatus == true)
+   {
+
+      memcpy(&ContactSch->Data, TblData, sizeof(CONTACT_SCH_Data_t));
+
+      ContactSch->ProfilesChecked = ContactSch->PktMgr->PktTbl.Loaded;
+      ContactSch->LastLoadCnt = WindowArrayIdx;
+      ContactSch->WindowIdx   = 0;
+      ContactSch->Reevaluate  = true;
+
+      CFE_EVS_SendEvent(CONTACT_SCH_LOAD_EID, CFE_EVS_EventType_INFORMATION,
+                        "Contact schedule loaded %d windows", WindowArrayIdx);
+   }
+
+   return RetStatus;
+
+} /* End LoadJsonData() */
+
+
+/******************************************************************************
+** Function: ValidProfiles
+**
+** Notes:
+**   1. Each non-empty window profile must be defined in the packet table.
+**      A later packet table load can still remove a profile so switching
+**      profiles is checked again at each transition.
+*/
+static bool ValidProfiles(CONTACT_SCH_Class_t *ContactSch, const CONTACT_SCH_Data_t *TblData)
+{
+
+   const CONTACT_SCH_Window_t *Window;
+   uint16 WindowIdx;
+
+   for (WindowIdx = 0; WindowIdx < TblData->WindowCnt; WindowIdx++)
+   {
+      Window = &(TblData->Window[WindowIdx]);
+      if ((Window->Profile[0] != '\0') &&
+          (PKTTBL_GetProfile(&(ContactSch->PktMgr->PktTbl.Data), Window->Profile) >= PKTTBL_PROFILE_MAX))
+      {
+         CFE_EVS_SendEvent(CONTACT_SCH_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Window[%d] profile '%s' is not defined in the packet table",
+                           WindowIdx, Window->Profile);
+         return false;
+      }
+   }
+
+   return true;
+
+} /* End ValidProfiles() */
+
+
+/******************************************************************************
+** Function: ValidWindow
+**
+*/
+static bool ValidWindow(const CONTACT_SCH_Window_t *Window, const CONTACT_SCH_Window_t *PrevWindow, uint16 WindowIdx)
+{
+
+   bool RetStatus = false;
+
+   if (Window->Start >= Window->Stop)
+   {
+      CFE_EVS_SendEvent(CONTACT_SCH_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Window[%d] start %u is not before stop %u",
+                        WindowIdx, (unsigned int)Window->Start, (unsigned int)Window->Stop);
+   }
+   else if (Window->PreQueue > Window->Start)
+   {
+      CFE_EVS_SendEvent(CONTACT_SCH_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Window[%d] pre-queue %u is greater than start %u",
+                        WindowIdx, (unsigned int)Window->PreQueue, (unsigned int)Window->Start);
+   }
+   else if ((PrevWindow != NULL) && ((Window->Start - Window->PreQueue) < PrevWindow->Stop))
+   {
+      CFE_EVS_SendEvent(CONTACT_SCH_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Window[%d] start %u minus pre-queue %u is before window[%d] stop %u. Windows must be sorted and not overlap",
+                        WindowIdx, (unsigned int)Window->Start, (unsigned int)Window->PreQueue,
+                        WindowIdx-1, (unsigned int)PrevWindow->Stop);
+   }
+   else if (Window->DestIp[0] == '\0')
+   {
+      CFE_EVS_SendEvent(CONTACT_SCH_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Window[%d] has an empty dest-ip", WindowIdx);
+   }
+   else
+   {
+      RetStatus = true;
+   }
+
+   return RetStatus;
+
+} /* End ValidWindow() */
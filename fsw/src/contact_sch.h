@@ -0,0 +1,261 @@
+/*
+**  Copyright 2022 bitValence, Inc.
+**  All Rights Reserved.
+**
+**  This program is free software; you can modify and/or redistribute it
+**  under the terms of the GNU Affero General Public License
+**  as published by the Free Software Foundation; version 3 with
+**  attribution addendums as found in the LICENSE.txt
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Affero General Public License for more details.
+**
+**  Purpose:
+**    Define the contact schedule that drives telemetry output from a
+**    table of ground contact windows.
+**
+**  Notes:
+**    1. Each window defines an acquisition of signal (AOS) and loss of
+**       signal (LOS) time in spacecraft time seconds, the destination IP
+**       address, an output rate limit and an optional packet table profile.
+**    2. During a window's pre-queue period the window's profile is made
+**       active and output is held so the profile's packets are queued on
+**       the telemetry pipe and sent first at AOS.
+**    3. The schedule only changes PKTMGR state at window transitions so
+**       ground commands can still override output within a window.
+**    4. Each instance controls one output channel and is registered with
+**       the table manager under its own table ID.
+**
+**  References:
+**    1. OpenSatKit Object-based Application Developer's Guide
+**    2. cFS Application Developer's Guide
+**
+*/
+#ifndef _contact_sch_
+#define _contact_sch_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "pktmgr.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define CONTACT_SCH_MAX_INSTANCES  PKTMGR_MAX_CHANNELS  /* One schedule per output channel */
+
+/*
+** Event Message IDs
+*/
+
+#define CONTACT_SCH_CREATE_FILE_ERR_EID  (CONTACT_SCH_BASE_EID + 0)
+#define CONTACT_SCH_LOAD_EID             (CONTACT_SCH_BASE_EID + 1)
+#define CONTACT_SCH_LOAD_ERR_EID         (CONTACT_SCH_BASE_EID + 2)
+#define CONTACT_SCH_TRANSITION_EID       (CONTACT_SCH_BASE_EID + 3)
+#define CONTACT_SCH_START_CMD_EID        (CONTACT_SCH_BASE_EID + 4)
+#define CONTACT_SCH_STOP_CMD_EID         (CONTACT_SCH_BASE_EID + 5)
+#define CONTACT_SCH_INSTANCE_ERR_EID     (CONTACT_SCH_BASE_EID + 6)
+
+/*
+** Schedule states reported in telemetry
+*/
+
+#define CONTACT_SCH_STATE_DISABLED  1
+#define CONTACT_SCH_STATE_LOS       2   /* Between windows, output disabled      */
+#define CONTACT_SCH_STATE_PREQUEUE  3   /* Before AOS, output held in the pipe   */
+#define CONTACT_SCH_STATE_AOS       4   /* In a window, output enabled           */
+
+#define CONTACT_SCH_NO_WINDOW  0xFFFF
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** Command Packets
+*/
+
+typedef struct
+{
+
+   CFE_MSG_CommandHeader_t  CmdHeader;
+
+} CONTACT_SCH_NoParamCmdMsg_t;
+#define CONTACT_SCH_NO_PARAM_CMD_DATA_LEN  (sizeof(CONTACT_SCH_NoParamCmdMsg_t) - sizeof(CFE_MSG_CommandHeader_t))
+#define CONTACT_SCH_START_CMD_DATA_LEN (CONTACT_SCH_NO_PARAM_CMD_DATA_LEN)
+#define CONTACT_SCH_STOP_CMD_DATA_LEN  (CONTACT_SCH_NO_PARAM_CMD_DATA_LEN)
+
+
+/******************************************************************************
+** Table - Local table copy used for table loads
+**
+** - Windows are sorted by start time and don't overlap
+** - PreQueue is the number of seconds before Start that output is held
+** - RateLimit is in bytes per second, 0 means no limit
+** - An empty Profile leaves the active packet table profile unchanged
+*/
+
+typedef struct
+{
+
+   uint32  Start;
+   uint32  Stop;
+   uint32  PreQueue;
+   uint32  RateLimit;
+   char    DestIp[PKTMGR_IP_STR_LEN];
+   char    Profile[PKTTBL_PROFILE_NAME_LEN];
+
+} CONTACT_SCH_Window_t;
+
+
+typedef struct
+{
+
+   uint16  WindowCnt;
+   CONTACT_SCH_Window_t Window[CONTACT_SCH_MAX_WINDOWS];
+
+} CONTACT_SCH_Data_t;
+
+
+/******************************************************************************
+** Class
+*/
+
+typedef struct
+{
+
+   /*
+   ** Output channel controlled by the schedule
+   */
+
+   PKTMGR_Class_t  *PktMgr;
+
+   /*
+   ** Table parameter data
+   */
+
+   CONTACT_SCH_Data_t Data;
+   CONTACT_SCH_Data_t Stage;     /* Working buffer for loads */
+
+   /*
+   ** Schedule state
+   **
+   ** The evaluator is called every main loop cycle and returns immediately
+   ** until NextEventTime so the cost between transitions is one compare.
+   */
+
+   bool    Enabled;
+   bool    Reevaluate;      /* Apply the current state even if unchanged */
+   uint8   State;
+   uint16  WindowIdx;       /* Current or next window, WindowCnt when none remain */
+   uint32  NextEventTime;   /* Spacecraft time seconds */
+   uint32  LastEvalTime;
+   bool    ProfilesChecked; /* Window profiles are defined in the packet table */
+
+   /*
+   ** Standard CJSON table data
+   */
+
+   uint8       TblId;    /* Table manager ID used to route load and dump commands */
+   bool        Loaded;
+   uint8       LastLoadStatus;
+   uint16      LastLoadCnt;
+
+   char        JsonBuf[CONTACT_SCH_JSON_FILE_MAX_CHAR];
+   size_t      JsonFileLen;
+
+} CONTACT_SCH_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: CONTACT_SCH_Constructor
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**   2. The schedule starts enabled if the ini file enables it, but it has no
+**      effect until a table has been loaded.
+**   3. PktMgr is the output channel the schedule controls.
+**   4. TblId must be the ID the table manager assigns when the schedule's
+**      table is registered. See PKTTBL_Constructor().
+**
+*/
+void CONTACT_SCH_Constructor(CONTACT_SCH_Class_t *ContactSch, INITBL_Class_t *IniTbl,
+                             uint8 TblId, PKTMGR_Class_t *PktMgr);
+
+
+/******************************************************************************
+** Function: CONTACT_SCH_DumpCmd
+**
+** Notes:
+**  1. Function signature must match TBLMGR_DumpTblFuncPtr_t.
+**  2. File is formatted so it can be used as a load file.
+*/
+bool CONTACT_SCH_DumpCmd(TBLMGR_Tbl_t *Tbl, uint8 DumpType, const char *Filename);
+
+
+/******************************************************************************
+** Function: CONTACT_SCH_Execute
+**
+** Evaluate the schedule against the current spacecraft time and apply any
+** window transition to PKTMGR.
+**
+** Notes:
+**   1. Must be called before PKTMGR_OutputTelemetry() each main loop cycle
+**      so an AOS transition takes effect in the same cycle.
+**
+*/
+void CONTACT_SCH_Execute(CONTACT_SCH_Class_t *ContactSch);
+
+
+/******************************************************************************
+** Function: CONTACT_SCH_LoadCmd
+**
+** Notes:
+**  1. Function signature must match TBLMGR_LoadTblFuncPtr_t.
+**  2. The entire schedule is replaced and re-evaluated on the next
+**     execution cycle.
+*/
+bool CONTACT_SCH_LoadCmd(TBLMGR_Tbl_t *Tbl, uint8 LoadType, const char *Filename);
+
+
+/******************************************************************************
+** Function: CONTACT_SCH_ResetStatus
+**
+*/
+void CONTACT_SCH_ResetStatus(CONTACT_SCH_Class_t *ContactSch);
+
+
+/******************************************************************************
+** Function: CONTACT_SCH_StartCmd
+**
+** Start executing the contact schedule. The current state is applied on the
+** next execution cycle.
+**
+*/
+bool CONTACT_SCH_StartCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: CONTACT_SCH_StopCmd
+**
+** Stop executing the contact schedule. A held pipe is released and the rate
+** limit is removed, otherwise the output state is left unchanged.
+**
+*/
+bool CONTACT_SCH_StopCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+#endif /* _contact_sch_ */
@@ -32,8 +32,6 @@
 #include <string.h>
 #include <unistd.h>
 
-#include "cfe_evs_extern_typedefs.h"
-
 #include "evt_plbk.h"
 
 
@@ -41,28 +39,17 @@
 /** File Function Prototypes **/
 /******************************/
 
-static void SendEventTlmMsg(void);
-static bool LoadLogFile(void);
-
-
-/**********************/
-/** Global File Data **/
-/**********************/
-
-static EVT_PLBK_Class_t *EvtPlbk = NULL;
-
-static CFE_EVS_WriteLogDataFileCmd_t WriteEvsLogFileCmd;
+static void SendEventTlmMsg(EVT_PLBK_Class_t *EvtPlbk);
+static bool LoadLogFile(EVT_PLBK_Class_t *EvtPlbk);
 
 
 /******************************************************************************
 ** Function: EVT_PLBK_Constructor
 **
 */
-void EVT_PLBK_Constructor(EVT_PLBK_Class_t *EvtPlbkPtr, INITBL_Class_t *IniTbl)
+void EVT_PLBK_Constructor(EVT_PLBK_Class_t *EvtPlbk, INITBL_Class_t *IniTbl)
 {
 
-   EvtPlbk = EvtPlbkPtr;
-
    memset ((void*)EvtPlbk, 0, sizeof(EVT_PLBK_Class_t));   /* Enabled set to FALSE */
    
    EvtPlbk->HkCyclePeriod = INITBL_GetIntConfig(IniTbl, CFG_EVT_PLBK_HK_PERIOD);
@@ -76,10 +63,10 @@ void EVT_PLBK_Constructor(EVT_PLBK_Class_t *EvtPlbkPtr, INITBL_Class_t *IniTbl)
    ** Initialize the static fields in the 'Write Log to File' command. The filename
    ** and checksum are set prior to sending the command
    */
-   CFE_MSG_Init(CFE_MSG_PTR(WriteEvsLogFileCmd.CommandBase),
+   CFE_MSG_Init(CFE_MSG_PTR(EvtPlbk->WriteEvsLogFileCmd.CommandBase),
                   CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_EVS_CMD_TOPICID)),
                   sizeof(CFE_EVS_WriteLogDataFileCmd_t));
-   CFE_MSG_SetFcnCode(CFE_MSG_PTR(WriteEvsLogFileCmd.CommandBase), INITBL_GetIntConfig(IniTbl, CFG_CFE_EVS_WRITE_LOG_DATA_FILE_CC));
+   CFE_MSG_SetFcnCode(CFE_MSG_PTR(EvtPlbk->WriteEvsLogFileCmd.CommandBase), INITBL_GetIntConfig(IniTbl, CFG_CFE_EVS_WRITE_LOG_DATA_FILE_CC));
                                                               
 } /* End EVT_PLBK_Constructor() */
 
@@ -88,7 +75,7 @@ void EVT_PLBK_Constructor(EVT_PLBK_Class_t *EvtPlbkPtr, INITBL_Class_t *IniTbl)
 ** Function: EVT_PLBK_ResetStatus
 **
 */
-void EVT_PLBK_ResetStatus(void)
+void EVT_PLBK_ResetStatus(EVT_PLBK_Class_t *EvtPlbk)
 {
 
    /* Nothing to do */
@@ -100,7 +87,7 @@ void EVT_PLBK_ResetStatus(void)
 ** Function: EVT_PLBK_Execute
 **
 */
-void EVT_PLBK_Execute(void)
+void EVT_PLBK_Execute(EVT_PLBK_Class_t *EvtPlbk)
 {
 
    CFE_TIME_SysTime_t  AttemptTime;
@@ -116,7 +103,7 @@ void EVT_PLBK_Execute(void)
          if (EvtPlbk->HkCycleCount >= EvtPlbk->HkCyclePeriod)
          {
             
-            SendEventTlmMsg();
+            SendEventTlmMsg(EvtPlbk);
             EvtPlbk->HkCycleCount = 0;
          
          }         
@@ -124,7 +111,7 @@ void EVT_PLBK_Execute(void)
       else
       {
 
-         if (LoadLogFile())
+         if (LoadLogFile(EvtPlbk))
          {
          
             EvtPlbk->LogFileCopied = true;
@@ -142,7 +129,7 @@ void EVT_PLBK_Execute(void)
                
                CFE_EVS_SendEvent(EVT_PLBK_LOG_READ_ERR_EID, CFE_EVS_EventType_ERROR, 
                                  "Failed to read event log file %s after %d attempts over %d seconds",
-                                 WriteEvsLogFileCmd.Payload.LogFilename, (EvtPlbk->EvsLogFileOpenAttempts-1), AttemptTime.Seconds);
+                                 EvtPlbk->WriteEvsLogFileCmd.Payload.LogFilename, (EvtPlbk->EvsLogFileOpenAttempts-1), AttemptTime.Seconds);
                                  
                EvtPlbk->Enabled = false;
        
@@ -169,6 +156,7 @@ void EVT_PLBK_Execute(void)
 bool EVT_PLBK_ConfigCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
 
+   EVT_PLBK_Class_t *EvtPlbk = (EVT_PLBK_Class_t *)ObjDataPtr;
    const EVT_PLBK_ConfigCmdMsg_t *ConfigCmd = (const EVT_PLBK_ConfigCmdMsg_t *) MsgPtr;
 
    bool  RetStatus = false;
@@ -182,7 +170,7 @@ bool EVT_PLBK_ConfigCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
    
       CFE_EVS_SendEvent(EVT_PLBK_CFG_CMD_EID, CFE_EVS_EventType_INFORMATION, 
                         "Config playback command accepted with log file %s and HK period %d",
-                        WriteEvsLogFileCmd.Payload.LogFilename, ConfigCmd->HkCyclesPerPkt);
+                        EvtPlbk->WriteEvsLogFileCmd.Payload.LogFilename, ConfigCmd->HkCyclesPerPkt);
 
       RetStatus = true;
       
@@ -192,7 +180,7 @@ bool EVT_PLBK_ConfigCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
       
       CFE_EVS_SendEvent(EVT_PLBK_CFG_CMD_ERR_EID, CFE_EVS_EventType_ERROR, 
                         "Config playback command rejected, invalid filename %s",
-                        WriteEvsLogFileCmd.Payload.LogFilename);
+                        EvtPlbk->WriteEvsLogFileCmd.Payload.LogFilename);
 
    
    }
@@ -211,6 +199,7 @@ bool EVT_PLBK_ConfigCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 bool EVT_PLBK_StartCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
 
+   EVT_PLBK_Class_t *EvtPlbk = (EVT_PLBK_Class_t *)ObjDataPtr;
    FileUtil_FileInfo_t FileInfo;
 
    FileInfo = FileUtil_GetFileInfo(EvtPlbk->EvsLogFilename, OS_MAX_PATH_LEN, false);
@@ -220,10 +209,10 @@ bool EVT_PLBK_StartCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
       OS_remove(EvtPlbk->EvsLogFilename);
    }
    
-   strncpy(WriteEvsLogFileCmd.Payload.LogFilename, EvtPlbk->EvsLogFilename, CFE_MISSION_MAX_PATH_LEN);
+   strncpy(EvtPlbk->WriteEvsLogFileCmd.Payload.LogFilename, EvtPlbk->EvsLogFilename, CFE_MISSION_MAX_PATH_LEN);
    
-   CFE_MSG_GenerateChecksum(CFE_MSG_PTR(WriteEvsLogFileCmd));
-   CFE_SB_TransmitMsg(CFE_MSG_PTR(WriteEvsLogFileCmd), true);
+   CFE_MSG_GenerateChecksum(CFE_MSG_PTR(EvtPlbk->WriteEvsLogFileCmd));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(EvtPlbk->WriteEvsLogFileCmd), true);
 
    EvtPlbk->StartTime = CFE_TIME_GetTime();   
 
@@ -235,7 +224,7 @@ bool EVT_PLBK_StartCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
    
    CFE_EVS_SendEvent(EVT_PLBK_SENT_WRITE_LOG_CMD_EID, CFE_EVS_EventType_INFORMATION, 
                      "Commanded CFE_EVS to write event log to %s. Event tlm HK period = %d",
-                     WriteEvsLogFileCmd.Payload.LogFilename, EvtPlbk->HkCyclePeriod);
+                     EvtPlbk->WriteEvsLogFileCmd.Payload.LogFilename, EvtPlbk->HkCyclePeriod);
    
    return true;
    
@@ -249,6 +238,7 @@ bool EVT_PLBK_StartCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 bool EVT_PLBK_StopCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
 
+   EVT_PLBK_Class_t *EvtPlbk = (EVT_PLBK_Class_t *)ObjDataPtr;
    EvtPlbk->Enabled = false;
    EvtPlbk->LogFileCopied = false;
    EvtPlbk->HkCycleCount = 0;
@@ -265,7 +255,7 @@ bool EVT_PLBK_StopCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 ** Function: LoadLogFile()
 **
 */
-static bool LoadLogFile(void)
+static bool LoadLogFile(EVT_PLBK_Class_t *EvtPlbk)
 {
 
    bool      RetStatus = false;
@@ -423,7 +413,7 @@ static bool LoadLogFile(void)
 **   1. The log filename and event count are loaded once when the playback is
 **      started.
 */
-static void SendEventTlmMsg(void)
+static void SendEventTlmMsg(EVT_PLBK_Class_t *EvtPlbk)
 {
 
    uint16 i;
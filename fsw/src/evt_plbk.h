@@ -32,6 +32,7 @@
 ** Includes
 */
 
+#include "cfe_evs_extern_typedefs.h"
 #include "app_cfg.h"
 
 
@@ -171,6 +172,8 @@ typedef struct
    CFE_TIME_SysTime_t  StartTime;
    
    char EvsLogFilename[CFE_MISSION_MAX_PATH_LEN];
+   
+   CFE_EVS_WriteLogDataFileCmd_t  WriteEvsLogFileCmd;
       
    EVT_PLBK_EventLog_t  EventLog;
    
@@ -191,7 +194,7 @@ typedef struct
 **   2. Disabled by default.
 **
 */
-void EVT_PLBK_Constructor(EVT_PLBK_Class_t *EvtPbPtr, INITBL_Class_t *IniTbl);
+void EVT_PLBK_Constructor(EVT_PLBK_Class_t *EvtPlbk, INITBL_Class_t *IniTbl);
 
 
 /******************************************************************************
@@ -204,7 +207,7 @@ void EVT_PLBK_Constructor(EVT_PLBK_Class_t *EvtPbPtr, INITBL_Class_t *IniTbl);
 **      change the functional behavior should be reset.
 **
 */
-void EVT_PLBK_ResetStatus(void);
+void EVT_PLBK_ResetStatus(EVT_PLBK_Class_t *EvtPlbk);
 
 
 /******************************************************************************
@@ -222,7 +225,7 @@ void EVT_PLBK_ResetStatus(void);
 **      through the log file. 
 **
 */
-void EVT_PLBK_Execute(void);
+void EVT_PLBK_Execute(EVT_PLBK_Class_t *EvtPlbk);
 
 
 /******************************************************************************
@@ -49,18 +49,26 @@
 #define  INITBL_OBJ   (&(KitTo.IniTbl))
 #define  CMDMGR_OBJ   (&(KitTo.CmdMgr))
 #define  TBLMGR_OBJ   (&(KitTo.TblMgr))
-#define  PKTMGR_OBJ   (&(KitTo.PktMgr))
+#define  PKTMGR_OBJ   (&(KitTo.PktMgr[KitTo.CmdChannel]))
 #define  EVTPLBK_OBJ  (&(KitTo.EvtPlbk))
+#define  CONTACTSCH_OBJ  (&(KitTo.ContactSch))
+#define  TLMREC_OBJ      (&(KitTo.TlmRec))
 
 
 /*******************************/
 /** Local Function Prototypes **/
 /*******************************/
 
-static int32 InitApp(void);
-static void  InitDataTypePkt(void);
-static int32 ProcessCommands(void);
-static void  SendHousekeepingPkt(void);
+static void   ChannelFilename(char *Filename, const char *BaseFilename, uint16 Channel);
+static int32  InitApp(void);
+static void   InitDataTypePkt(void);
+static void   PendForWakeup(uint32 Timeout);
+static int32  ProcessCommands(void);
+static void   RegisterPktMgrCmds(void);
+static void   SendChannelTlm(uint16 Channel);
+static void   SendHousekeepingPkt(void);
+static void   UpdateStartupMode(void);
+static void   UpdateCmdLatency(const CFE_MSG_Message_t *MsgPtr);
 
 
 /**********************/
@@ -88,7 +96,7 @@ KIT_TO_Class_t  KitTo;
 void KIT_TO_AppMain(void)
 {
 
-   uint32  StartupCnt;
+   uint16  i;
    uint16  NumPktsOutput;
    uint32  RunStatus = CFE_ES_RunStatus_APP_ERROR;
    
@@ -104,22 +112,39 @@ void KIT_TO_AppMain(void)
    */
    
    CFE_EVS_SendEvent(KIT_TO_INIT_DEBUG_EID, KIT_TO_INIT_EVS_TYPE, "KIT_TO: About to enter loop\n");
-   StartupCnt = 0;
+   KitTo.StartupTime = CFE_TIME_GetTime();
    while (CFE_ES_RunLoop(&RunStatus))
    {
    
       /* Use a short delay during startup to avoid event message pipe overflow */
-      if (StartupCnt < 200)
+      if (KitTo.StartupMode)
       { 
-         OS_TaskDelay(20);
-         ++StartupCnt;
+         PendForWakeup(KitTo.StartupDelay);
       }
       else
       {
-         OS_TaskDelay(KitTo.RunLoopDelay);
+         PendForWakeup(KitTo.RunLoopDelay);
       }
 
-      NumPktsOutput = PKTMGR_OutputTelemetry();
+      /* Apply table loads completed by the child task before the output cycle */
+      for (i=0; i < KitTo.ChannelCnt; i++)
+      {
+         PKTTBL_Execute(&KitTo.PktMgr[i].PktTbl);
+      }
+      
+      /* Apply contact window transitions before the output cycle */
+      CONTACT_SCH_Execute(CONTACTSCH_OBJ);
+      
+      /* Check the recorder's trigger and write file dump records */
+      TLM_REC_Execute(TLMREC_OBJ);
+      
+      NumPktsOutput = 0;
+      for (i=0; i < KitTo.ChannelCnt; i++)
+      {
+         NumPktsOutput += PKTMGR_OutputTelemetry(&KitTo.PktMgr[i]);
+      }
+      
+      if (KitTo.StartupMode) UpdateStartupMode();
       
       CFE_EVS_SendEvent(KIT_TO_DEMO_EID, CFE_EVS_EventType_DEBUG, 
                         "Output %d telemetry packets", NumPktsOutput);
@@ -167,11 +192,25 @@ bool KIT_TO_NoOpCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 bool KIT_TO_ResetAppCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
 
+   uint16 i;
+   
    CMDMGR_ResetStatus(CMDMGR_OBJ);
    TBLMGR_ResetStatus(TBLMGR_OBJ);
 
-   PKTMGR_ResetStatus();
-   EVT_PLBK_ResetStatus();
+   for (i=0; i < KitTo.ChannelCnt; i++)
+   {
+      PKTMGR_ResetStatus(&KitTo.PktMgr[i]);
+   }
+   EVT_PLBK_ResetStatus(EVTPLBK_OBJ);
+   CONTACT_SCH_ResetStatus(CONTACTSCH_OBJ);
+   TLM_REC_ResetStatus(TLMREC_OBJ);
+   
+   KitTo.CmdLatencyCnt = 0;
+   KitTo.CmdLatencySum = 0;
+   KitTo.CmdLatencyMax = 0;
+   
+   KitTo.WakeupCnt        = 0;
+   KitTo.WakeupTimeoutCnt = 0;
    
    return true;
 
@@ -196,6 +235,44 @@ bool KIT_TO_SendDataTypeTlmCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr
 } /* End KIT_TO_SendDataTypeTlmCmd() */
 
 
+/******************************************************************************
+** Function: KIT_TO_SelectChannelCmd
+**
+*/
+bool KIT_TO_SelectChannelCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const KIT_TO_SelectChannelCmdMsg_t *CmdMsg = (const KIT_TO_SelectChannelCmdMsg_t *) MsgPtr;
+   KIT_TO_Class_t *KitToPtr = (KIT_TO_Class_t *)ObjDataPtr;
+   bool RetStatus = false;
+   
+   if (CmdMsg->Channel < KitToPtr->ChannelCnt)
+   {
+   
+      CFE_EVS_SendEvent(KIT_TO_SELECT_CHANNEL_EID, CFE_EVS_EventType_INFORMATION,
+                        "Command channel changed from %d to %d", 
+                        KitToPtr->CmdChannel, CmdMsg->Channel);
+   
+      KitToPtr->CmdChannel = CmdMsg->Channel;
+      RegisterPktMgrCmds();
+
+      RetStatus = true;
+   
+   }   
+   else
+   {
+      
+      CFE_EVS_SendEvent(KIT_TO_SELECT_CHANNEL_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Invalid command channel %d. Valid inclusive range: [0,%d]", 
+                        CmdMsg->Channel, (KitToPtr->ChannelCnt-1));
+      
+   }
+   
+   return RetStatus;
+   
+} /* End KIT_TO_SelectChannelCmd() */
+
+
 /******************************************************************************
 ** Function: KIT_TO_SetRunLoopDelayCmd
 **
@@ -205,7 +282,8 @@ bool KIT_TO_SetRunLoopDelayCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr
 
    const KIT_TO_SetRunLoopDelayCmdMsg_t *CmdMsg = (const KIT_TO_SetRunLoopDelayCmdMsg_t *) MsgPtr;
    KIT_TO_Class_t *KitToPtr = (KIT_TO_Class_t *)ObjDataPtr;
-   bool RetStatus = false;
+   bool   RetStatus = false;
+   uint16 i;
    
    if ((CmdMsg->RunLoopDelay >= KitTo.RunLoopDelayMin) &&
        (CmdMsg->RunLoopDelay <= KitTo.RunLoopDelayMax))
@@ -217,7 +295,11 @@ bool KIT_TO_SetRunLoopDelayCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr
    
       KitToPtr->RunLoopDelay = CmdMsg->RunLoopDelay;
       
-      PKTMGR_InitStats(KitToPtr->RunLoopDelay,INITBL_GetIntConfig(INITBL_OBJ, CFG_PKTMGR_STATS_CONFIG_DELAY));
+      for (i=0; i < KitToPtr->ChannelCnt; i++)
+      {
+         PKTMGR_InitStats(&KitToPtr->PktMgr[i], KitToPtr->RunLoopDelay,
+                          INITBL_GetIntConfig(INITBL_OBJ, CFG_PKTMGR_STATS_CONFIG_DELAY));
+      }
 
       RetStatus = true;
    
@@ -332,7 +414,10 @@ bool KIT_TO_TestFilterCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 static int32 InitApp(void)
 {
 
-   int32 Status = CFE_SEVERITY_ERROR;
+   int32  Status = CFE_SEVERITY_ERROR;
+   uint16 i;
+   char   TblFilename[OS_MAX_PATH_LEN];
+   CFE_TIME_SysTime_t RestoreStartTime;
 
    /*
    ** Read JSON INI Table & Initialize contained objects
@@ -343,14 +428,50 @@ static int32 InitApp(void)
       
       KitTo.CmdMid     = CFE_SB_ValueToMsgId(INITBL_GetIntConfig(INITBL_OBJ, CFG_KIT_TO_CMD_TOPICID));
       KitTo.SendHkMid  = CFE_SB_ValueToMsgId(INITBL_GetIntConfig(INITBL_OBJ, CFG_KIT_TO_SEND_HK_TOPICID));
-
+      KitTo.WakeupMid  = CFE_SB_ValueToMsgId(INITBL_GetIntConfig(INITBL_OBJ, CFG_KIT_TO_WAKEUP_TOPICID));
+      KitTo.WakeupEna  = (INITBL_GetIntConfig(INITBL_OBJ, CFG_APP_WAKEUP_ENA) != 0);
+
+      KitTo.StartupMode        = true;
+      KitTo.StartupDelay       = INITBL_GetIntConfig(INITBL_OBJ, CFG_APP_STARTUP_DELAY);
+      KitTo.StartupCalmCycles  = INITBL_GetIntConfig(INITBL_OBJ, CFG_APP_STARTUP_CALM_CYCLES);
+      KitTo.StartupTimeout     = INITBL_GetIntConfig(INITBL_OBJ, CFG_APP_STARTUP_TIMEOUT);
+      KitTo.StartupCalmBacklog = INITBL_GetIntConfig(INITBL_OBJ, CFG_APP_STARTUP_CALM_BACKLOG);
+      KitTo.StartupCalmCnt     = 0;
+      KitTo.StartupBoundCycles = 0;
+      KitTo.StartupPeakBacklog = 0;
+      KitTo.StartupMs          = 0;
+      
       KitTo.RunLoopDelay    = INITBL_GetIntConfig(INITBL_OBJ, CFG_APP_RUN_LOOP_DELAY);
       KitTo.RunLoopDelayMin = INITBL_GetIntConfig(INITBL_OBJ, CFG_APP_RUN_LOOP_DELAY_MIN);
       KitTo.RunLoopDelayMax = INITBL_GetIntConfig(INITBL_OBJ, CFG_APP_RUN_LOOP_DELAY_MAX);
+      
+      KitTo.CmdPipeLimit     = INITBL_GetIntConfig(INITBL_OBJ, CFG_APP_CMD_PIPE_LIMIT);
+      KitTo.CmdPipeEmptyTime = CFE_TIME_GetTime();
 
-      PKTMGR_Constructor(PKTMGR_OBJ, INITBL_OBJ);
+      /*
+      ** Channel 0's packet table is table ID 0 and the contact schedule is
+      ** table ID 1 so the remaining channels' tables start at ID 2. The
+      ** flight recorder is fed and served by channel 0.
+      */
+      KitTo.ChannelCnt = INITBL_GetIntConfig(INITBL_OBJ, CFG_PKTMGR_CHANNELS);
+      KitTo.CmdChannel = 0;
+      if ((KitTo.ChannelCnt < 1) || (KitTo.ChannelCnt > PKTMGR_MAX_CHANNELS))
+      {
+         CFE_EVS_SendEvent(KIT_TO_APP_INIT_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Invalid PKTMGR_CHANNELS %d, valid inclusive range: [1,%d]. Using 1 channel", 
+                           KitTo.ChannelCnt, PKTMGR_MAX_CHANNELS);
+         KitTo.ChannelCnt = 1;
+      }
+      for (i=0; i < KitTo.ChannelCnt; i++)
+      {
+         PKTMGR_Constructor(&KitTo.PktMgr[i], INITBL_OBJ, i, (i == 0 ? 0 : i+1), (i == 0 ? TLMREC_OBJ : NULL));
+      }
 
       EVT_PLBK_Constructor(EVTPLBK_OBJ, INITBL_OBJ);
+      
+      CONTACT_SCH_Constructor(CONTACTSCH_OBJ, INITBL_OBJ, 1, &KitTo.PktMgr[0]);
+
+      TLM_REC_Constructor(TLMREC_OBJ, INITBL_OBJ);
 
       Status = CFE_SUCCESS;
    
@@ -384,6 +505,35 @@ static int32 InitApp(void)
                            INITBL_GetIntConfig(INITBL_OBJ, CFG_APP_CMD_PIPE_DEPTH), Status);
       }
    
+      if (KitTo.WakeupEna)
+      {
+         
+         Status = CFE_SB_CreatePipe(&KitTo.WakeupPipe,
+                                    INITBL_GetIntConfig(INITBL_OBJ, CFG_APP_WAKEUP_PIPE_DEPTH),
+                                    INITBL_GetStrConfig(INITBL_OBJ, CFG_APP_WAKEUP_PIPE_NAME)); 
+         if (Status == CFE_SUCCESS) 
+         {
+            Status = CFE_SB_Subscribe(KitTo.WakeupMid, KitTo.WakeupPipe);
+            if (Status != CFE_SUCCESS)
+            {
+               KitTo.WakeupEna = false;
+               CFE_SB_DeletePipe(KitTo.WakeupPipe);
+               CFE_EVS_SendEvent(KIT_TO_APP_INIT_ERR_EID, CFE_EVS_EventType_ERROR,
+                                 "Subscribe to wakeup topic 0x%04X failed. SB Status = 0x%04X. Using run loop delay",
+                                 CFE_SB_MsgIdToValue(KitTo.WakeupMid), Status);
+            }
+         }
+         else
+         {
+            KitTo.WakeupEna = false;
+            CFE_EVS_SendEvent(KIT_TO_APP_INIT_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "Create SB Wakeup Pipe %s with depth %d failed. SB Status = 0x%04X. Using run loop delay",
+                              INITBL_GetStrConfig(INITBL_OBJ, CFG_APP_WAKEUP_PIPE_NAME), 
+                              INITBL_GetIntConfig(INITBL_OBJ, CFG_APP_WAKEUP_PIPE_DEPTH), Status);
+         }
+      
+      } /* End if wakeup enabled */
+      
       CMDMGR_Constructor(CMDMGR_OBJ);
       CMDMGR_RegisterFunc(CMDMGR_OBJ, CMDMGR_NOOP_CMD_FC,     NULL,       KIT_TO_NoOpCmd,     0);
       CMDMGR_RegisterFunc(CMDMGR_OBJ, CMDMGR_RESET_CMD_FC,    NULL,       KIT_TO_ResetAppCmd, 0);
@@ -391,26 +541,69 @@ static int32 InitApp(void)
       CMDMGR_RegisterFunc(CMDMGR_OBJ, CMDMGR_LOAD_TBL_CMD_FC, TBLMGR_OBJ, TBLMGR_LoadTblCmd,  TBLMGR_LOAD_TBL_CMD_DATA_LEN);
       CMDMGR_RegisterFunc(CMDMGR_OBJ, CMDMGR_DUMP_TBL_CMD_FC, TBLMGR_OBJ, TBLMGR_DumpTblCmd,  TBLMGR_DUMP_TBL_CMD_DATA_LEN);
 
-      CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_ADD_PKT_CMD_FC,          PKTMGR_OBJ, PKTMGR_AddPktCmd,        PKKTMGR_ADD_PKT_CMD_DATA_LEN);
-      CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_ENABLE_OUTPUT_CMD_FC,    PKTMGR_OBJ, PKTMGR_EnableOutputCmd,  PKKTMGR_ENABLE_OUTPUT_CMD_DATA_LEN);
-      CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_REMOVE_ALL_PKTS_CMD_FC,  PKTMGR_OBJ, PKTMGR_RemoveAllPktsCmd, 0);
-      CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_REMOVE_PKT_CMD_FC,       PKTMGR_OBJ, PKTMGR_RemovePktCmd,     PKKTMGR_REMOVE_PKT_CMD_DATA_LEN);
-      CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_SEND_PKT_TBL_TLM_CMD_FC, PKTMGR_OBJ, PKTMGR_SendPktTblTlmCmd, PKKTMGR_SEND_PKT_TBL_TLM_CMD_DATA_LEN);
-      CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_UPDATE_FILTER_CMD_FC,    PKTMGR_OBJ, PKTMGR_UpdateFilterCmd,  PKKTMGR_UPDATE_FILTER_CMD_DATA_LEN);
+      RegisterPktMgrCmds();
       
       CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_SEND_DATA_TYPES_CMD_FC,    &KitTo, KIT_TO_SendDataTypeTlmCmd, 0);
       CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_SET_RUN_LOOP_DELAY_CMD_FC, &KitTo, KIT_TO_SetRunLoopDelayCmd, KIT_TO_SET_RUN_LOOP_DELAY_CMD_DATA_LEN);
       CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_TEST_FILTER_CMD_FC,        &KitTo, KIT_TO_TestFilterCmd,      KIT_TO_TEST_FILTER_CMD_DATA_LEN);
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_SELECT_CHANNEL_CMD_FC,     &KitTo, KIT_TO_SelectChannelCmd,   KIT_TO_SELECT_CHANNEL_CMD_DATA_LEN);
 
       CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_EVT_PLBK_CONFIG_CMD_FC,  EVTPLBK_OBJ, EVT_PLBK_ConfigCmd, EVT_PLBK_CONFIG_CMD_DATA_LEN);
       CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_EVT_PLBK_START_CMD_FC,   EVTPLBK_OBJ, EVT_PLBK_StartCmd,  EVT_PLBK_START_CMD_DATA_LEN);
       CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_EVT_PLBK_STOP_CMD_FC,    EVTPLBK_OBJ, EVT_PLBK_StopCmd,   EVT_PLBK_STOP_CMD_DATA_LEN);
 
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_CONTACT_SCH_START_CMD_FC, CONTACTSCH_OBJ, CONTACT_SCH_StartCmd, CONTACT_SCH_START_CMD_DATA_LEN);
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_CONTACT_SCH_STOP_CMD_FC,  CONTACTSCH_OBJ, CONTACT_SCH_StopCmd,  CONTACT_SCH_STOP_CMD_DATA_LEN);
+
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_TLM_REC_FREEZE_CMD_FC, TLMREC_OBJ, TLM_REC_FreezeCmd, TLM_REC_FREEZE_CMD_DATA_LEN);
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_TLM_REC_RESUME_CMD_FC, TLMREC_OBJ, TLM_REC_ResumeCmd, TLM_REC_RESUME_CMD_DATA_LEN);
+
       CFE_EVS_SendEvent(KIT_TO_INIT_DEBUG_EID, KIT_TO_INIT_EVS_TYPE, "KIT_TO_InitApp() Before TBLMGR calls\n");
       TBLMGR_Constructor(TBLMGR_OBJ);
-      TBLMGR_RegisterTblWithDef(TBLMGR_OBJ, PKTTBL_LoadCmd, PKTTBL_DumpCmd, INITBL_GetStrConfig(INITBL_OBJ, CFG_PKTTBL_LOAD_FILE));
+      
+      /*
+      ** After a processor reset the packet table is restored from the CDS
+      ** and the default table file is only loaded if the restore fails. The
+      ** file is loaded by the PKTTBL child task so its duration is reported
+      ** in the load completion event and PktTblLastLoadMs.
+      */
+      RestoreStartTime = CFE_TIME_GetTime();
+      if (PKTMGR_RestoreFromCds(&KitTo.PktMgr[0]))
+      {
+         KitTo.PktTblRestoreSrc = KIT_TO_PKT_TBL_SRC_CDS;
+         TBLMGR_RegisterTbl(TBLMGR_OBJ, PKTTBL_LoadCmd, PKTTBL_DumpCmd);
+      }
+      else
+      {
+         KitTo.PktTblRestoreSrc = KIT_TO_PKT_TBL_SRC_FILE;
+         TBLMGR_RegisterTblWithDef(TBLMGR_OBJ, PKTTBL_LoadCmd, PKTTBL_DumpCmd, INITBL_GetStrConfig(INITBL_OBJ, CFG_PKTTBL_LOAD_FILE));
+      }
+      KitTo.PktTblRestoreMs = KIT_TO_ElapsedMilliSecs(RestoreStartTime);
+      
+      CFE_EVS_SendEvent(KIT_TO_PKT_TBL_RESTORE_EID, CFE_EVS_EventType_INFORMATION,
+                        "Packet table %s in %d ms",
+                        (KitTo.PktTblRestoreSrc == KIT_TO_PKT_TBL_SRC_CDS ? "restored from CDS" : "file load started"),
+                        (int)KitTo.PktTblRestoreMs);
+
+      /* The contact schedule is table ID 1, after the packet table */
+      TBLMGR_RegisterTblWithDef(TBLMGR_OBJ, CONTACT_SCH_LoadCmd, CONTACT_SCH_DumpCmd, INITBL_GetStrConfig(INITBL_OBJ, CFG_CONTACT_SCH_LOAD_FILE));
+
+      /* Additional channels load the default table file with "_<channel>" before its extension */
+      for (i=1; i < KitTo.ChannelCnt; i++)
+      {
+         if (PKTMGR_RestoreFromCds(&KitTo.PktMgr[i]))
+         {
+            TBLMGR_RegisterTbl(TBLMGR_OBJ, PKTTBL_LoadCmd, PKTTBL_DumpCmd);
+         }
+         else
+         {
+            ChannelFilename(TblFilename, INITBL_GetStrConfig(INITBL_OBJ, CFG_PKTTBL_LOAD_FILE), i);
+            TBLMGR_RegisterTblWithDef(TBLMGR_OBJ, PKTTBL_LoadCmd, PKTTBL_DumpCmd, TblFilename);
+         }
+      }
 
       CFE_MSG_Init(CFE_MSG_PTR(KitTo.HkPkt), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(INITBL_OBJ, CFG_KIT_TO_HK_TLM_TOPICID)), KIT_TO_TLM_HK_LEN);
+      CFE_MSG_Init(CFE_MSG_PTR(KitTo.ChannelTlm), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(INITBL_OBJ, CFG_KIT_TO_CHANNEL_TLM_TOPICID)), KIT_TO_TLM_CHANNEL_LEN);
       InitDataTypePkt();
 
       /*
@@ -472,65 +665,229 @@ static void InitDataTypePkt(void)
 } /* End InitDataTypePkt() */
 
 
+/******************************************************************************
+** Function: ChannelFilename
+**
+** Insert "_<Channel>" before BaseFilename's extension, e.g. channel 1 of 
+** /cf/kit_to_pkt_tbl.json is /cf/kit_to_pkt_tbl_1.json.
+*/
+static void ChannelFilename(char *Filename, const char *BaseFilename, uint16 Channel)
+{
+
+   const char *Ext = strrchr(BaseFilename, '.');
+   const char *Dir = strrchr(BaseFilename, '/');
+   
+   if ((Ext == NULL) || ((Dir != NULL) && (Ext < Dir)))
+   {
+      Ext = BaseFilename + strlen(BaseFilename);
+   }
+   
+   snprintf(Filename, OS_MAX_PATH_LEN, "%.*s_%d%s", (int)(Ext - BaseFilename), BaseFilename, Channel, Ext);
+
+} /* End ChannelFilename() */
+
+
+/******************************************************************************
+** Function: PendForWakeup
+**
+** Notes:
+**   1. If wakeups are disabled this is a simple task delay. 
+**   2. Wakeups that queued while the app was busy are discarded so a late
+**      cycle doesn't cause back-to-back output cycles.
+**   3. Any pipe error other than a timeout falls back to a delay to prevent
+**      the main loop from spinning.
+**   4. Startup mode pends for less than the scheduler period so its
+**      timeouts aren't counted as missed wakeups.
+*/
+static void PendForWakeup(uint32 Timeout)
+{
+
+   int32 SbStatus;
+   CFE_SB_Buffer_t *SbBufPtr;
+   
+   if (KitTo.WakeupEna)
+   {
+      
+      SbStatus = CFE_SB_ReceiveBuffer(&SbBufPtr, KitTo.WakeupPipe, Timeout);
+      
+      if (SbStatus == CFE_SUCCESS)
+      {
+         
+         ++KitTo.WakeupCnt;
+         
+         while (CFE_SB_ReceiveBuffer(&SbBufPtr, KitTo.WakeupPipe, CFE_SB_POLL) == CFE_SUCCESS)
+         {
+            /* Discard stale wakeups */
+         }
+      
+      }
+      else if (SbStatus == CFE_SB_TIME_OUT)
+      {
+         if (!KitTo.StartupMode) ++KitTo.WakeupTimeoutCnt;
+      }
+      else
+      {
+         OS_TaskDelay(Timeout);
+      }
+   
+   } /* End if wakeup enabled */
+   else
+   {
+      OS_TaskDelay(Timeout);
+   }
+   
+} /* End PendForWakeup() */
+
+
 /******************************************************************************
 ** Function: ProcessCommands
 **
-** 
+** Process up to CmdPipeLimit commands so a burst of ground commands doesn't
+** take one main loop cycle per command. 
 */
 static int32 ProcessCommands(void)
 {
    
    int32  RetStatus = CFE_ES_RunStatus_APP_RUN;
    int32  SysStatus;
+   uint16 CmdCnt = 0;
 
    CFE_SB_Buffer_t* SbBufPtr;
    CFE_SB_MsgId_t   MsgId = CFE_SB_INVALID_MSG_ID;
 
-   SysStatus = CFE_SB_ReceiveBuffer(&SbBufPtr, KitTo.CmdPipe, CFE_SB_POLL);
-
-   if (SysStatus == CFE_SUCCESS)
+   do
    {
-      SysStatus = CFE_MSG_GetMsgId(&SbBufPtr->Msg, &MsgId);
+      
+      SysStatus = CFE_SB_ReceiveBuffer(&SbBufPtr, KitTo.CmdPipe, CFE_SB_POLL);
 
       if (SysStatus == CFE_SUCCESS)
       {
+         
+         ++CmdCnt;
+         UpdateCmdLatency(&SbBufPtr->Msg);
+
+         SysStatus = CFE_MSG_GetMsgId(&SbBufPtr->Msg, &MsgId);
+
+         if (SysStatus == CFE_SUCCESS)
+         {
 
-         if (CFE_SB_MsgId_Equal(MsgId, KitTo.CmdMid))
+            if (CFE_SB_MsgId_Equal(MsgId, KitTo.CmdMid))
+            {
+               CMDMGR_DispatchFunc(CMDMGR_OBJ, &SbBufPtr->Msg);
+            } 
+            else if (CFE_SB_MsgId_Equal(MsgId, KitTo.SendHkMid))
+            {   
+               SendHousekeepingPkt();
+            }
+            else
+            {   
+               CFE_EVS_SendEvent(KIT_TO_APP_INVALID_MID_EID, CFE_EVS_EventType_ERROR,
+                                 "Received invalid command packet, MID = 0x%08X", 
+                                 CFE_SB_MsgIdToValue(MsgId));
+            }
+
+         } /* End if got message ID */
+         
+         SysStatus = CFE_SUCCESS;
+         
+      } /* End if received buffer */
+      else
+      {
+         
+         if (SysStatus == CFE_SB_PIPE_RD_ERR)
          {
-            CMDMGR_DispatchFunc(CMDMGR_OBJ, &SbBufPtr->Msg);
-         } 
-         else if (CFE_SB_MsgId_Equal(MsgId, KitTo.SendHkMid))
-         {   
-            SendHousekeepingPkt();
+            RetStatus = CFE_ES_RunStatus_APP_ERROR;
          }
          else
-         {   
-            CFE_EVS_SendEvent(KIT_TO_APP_INVALID_MID_EID, CFE_EVS_EventType_ERROR,
-                              "Received invalid command packet, MID = 0x%08X", 
-                              CFE_SB_MsgIdToValue(MsgId));
+         {
+            KitTo.CmdPipeEmptyTime = CFE_TIME_GetTime();
          }
+      
+      } 
 
-      } /* End if got message ID */
-   } /* End if received buffer */
-   else
-   {
-      if (SysStatus == CFE_SB_PIPE_RD_ERR)
-         RetStatus = CFE_ES_RunStatus_APP_ERROR;
-   } 
-
+   } while ((SysStatus == CFE_SUCCESS) && (CmdCnt < KitTo.CmdPipeLimit));
+   
    return RetStatus;
    
 } /* End ProcessCommands() */
 
 
+/******************************************************************************
+** Function: RegisterPktMgrCmds
+**
+** Register the packet table and output commands with the command channel's
+** PKTMGR object.
+*/
+static void RegisterPktMgrCmds(void)
+{
+
+   CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_ADD_PKT_CMD_FC,          PKTMGR_OBJ, PKTMGR_AddPktCmd,        PKKTMGR_ADD_PKT_CMD_DATA_LEN);
+   CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_ENABLE_OUTPUT_CMD_FC,    PKTMGR_OBJ, PKTMGR_EnableOutputCmd,  PKKTMGR_ENABLE_OUTPUT_CMD_DATA_LEN);
+   CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_REMOVE_ALL_PKTS_CMD_FC,  PKTMGR_OBJ, PKTMGR_RemoveAllPktsCmd, 0);
+   CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_REMOVE_PKT_CMD_FC,       PKTMGR_OBJ, PKTMGR_RemovePktCmd,     PKKTMGR_REMOVE_PKT_CMD_DATA_LEN);
+   CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_SEND_PKT_TBL_TLM_CMD_FC, PKTMGR_OBJ, PKTMGR_SendPktTblTlmCmd, PKKTMGR_SEND_PKT_TBL_TLM_CMD_DATA_LEN);
+   CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_UPDATE_FILTER_CMD_FC,    PKTMGR_OBJ, PKTMGR_UpdateFilterCmd,  PKKTMGR_UPDATE_FILTER_CMD_DATA_LEN);
+   CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_PLAN_TBL_CMD_FC,         PKTMGR_OBJ, PKTMGR_PlanTblCmd,       PKKTMGR_PLAN_TBL_CMD_DATA_LEN);
+   CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_BULK_ADD_PKT_CMD_FC,       PKTMGR_OBJ, PKTMGR_BulkAddPktCmd,       PKKTMGR_BULK_ADD_PKT_CMD_DATA_LEN);
+   CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_BULK_REMOVE_PKT_CMD_FC,    PKTMGR_OBJ, PKTMGR_BulkRemovePktCmd,    PKKTMGR_BULK_REMOVE_PKT_CMD_DATA_LEN);
+   CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_BULK_UPDATE_FILTER_CMD_FC, PKTMGR_OBJ, PKTMGR_BulkUpdateFilterCmd, PKKTMGR_BULK_UPDATE_FILTER_CMD_DATA_LEN);
+   CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_SWITCH_PROFILE_CMD_FC,     PKTMGR_OBJ, PKTMGR_SwitchProfileCmd,    PKKTMGR_SWITCH_PROFILE_CMD_DATA_LEN);
+   CMDMGR_RegisterFunc(CMDMGR_OBJ, KIT_TO_SNAPSHOT_CMD_FC,           PKTMGR_OBJ, PKTMGR_SnapshotCmd,         0);
+
+} /* End RegisterPktMgrCmds() */
+
+
+/******************************************************************************
+** Function: SendChannelTlm
+**
+*/
+static void SendChannelTlm(uint16 Channel)
+{
+
+   KIT_TO_ChannelTlm_t  *ChannelTlm = &KitTo.ChannelTlm;
+   const PKTMGR_Class_t *PktMgr     = &KitTo.PktMgr[Channel];
+
+   ChannelTlm->Channel              = Channel;
+   ChannelTlm->DownlinkOn           = PktMgr->DownlinkOn;
+   ChannelTlm->SuppressSend         = PktMgr->SuppressSend;
+   ChannelTlm->StatsValid           = (PktMgr->Stats.State == PKTMGR_STATS_VALID);
+   ChannelTlm->PktTblLastLoadStatus = PktMgr->PktTbl.LastLoadStatus;
+   ChannelTlm->PktsPerSec           = round(PktMgr->Stats.AvgPktsPerSec);
+   ChannelTlm->BytesPerSec          = round(PktMgr->Stats.AvgBytesPerSec);
+   strncpy(ChannelTlm->TlmDestIp, PktMgr->TlmDestIp, PKTMGR_IP_STR_LEN);
+   ChannelTlm->ActiveProfile        = PktMgr->ActiveProfile;
+   ChannelTlm->RetryQueueCnt        = PktMgr->RetryQueueCnt;
+   ChannelTlm->OutputBoundCycles    = PktMgr->OutputBoundCycles;
+   ChannelTlm->RetryDropCnt         = PktMgr->RetryDropCnt;
+   ChannelTlm->SendTransientErrCnt  = PktMgr->SendTransientErrCnt;
+   ChannelTlm->RateLimitCycles      = PktMgr->RateLimitCycles;
+   ChannelTlm->FeedbackRate         = PktMgr->FeedbackEna ? PktMgr->FeedbackRate : 0;
+   ChannelTlm->StaleDropCnt         = PktMgr->StaleDropCnt;
+   ChannelTlm->ReorderLateCnt       = PktMgr->ReorderLateCnt;
+   ChannelTlm->PipeInlineCnt        = PktMgr->PipeInlineCnt;
+   ChannelTlm->PipePackErrCnt       = PktMgr->PipePackErrCnt;
+   ChannelTlm->PipeDropCnt          = PktMgr->PipeDropCnt;
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(ChannelTlm->TlmHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(ChannelTlm->TlmHeader), true);
+
+} /* End SendChannelTlm() */
+
+
 /******************************************************************************
 ** Function: SendHousekeepingPkt
 **
+** Notes:
+**   1. The PKTMGR and PKTTBL data is for the command channel. A channel
+**      telemetry packet is sent for every channel after the HK packet.
+**
 */
 static void SendHousekeepingPkt(void)
 {
 
-   KIT_TO_HkPkt_t *HkPkt = &KitTo.HkPkt;
+   uint16 i;
+   KIT_TO_HkPkt_t *HkPkt  = &KitTo.HkPkt;
+   PKTMGR_Class_t *PktMgr = &KitTo.PktMgr[KitTo.CmdChannel];
    
    /*
    ** KIT_TO Data
@@ -541,12 +898,25 @@ static void SendHousekeepingPkt(void)
 
    HkPkt->RunLoopDelay  = KitTo.RunLoopDelay;
 
+   HkPkt->CmdLatencyAvg = (KitTo.CmdLatencyCnt == 0) ? 0 : (uint16)(KitTo.CmdLatencySum/KitTo.CmdLatencyCnt);
+   HkPkt->CmdLatencyMax = (KitTo.CmdLatencyMax > 0xFFFF) ? 0xFFFF : (uint16)KitTo.CmdLatencyMax;
+   
+   HkPkt->WakeupCnt        = KitTo.WakeupCnt;
+   HkPkt->WakeupTimeoutCnt = KitTo.WakeupTimeoutCnt;
+   
+   HkPkt->StartupPeakBacklog = KitTo.StartupPeakBacklog;
+   HkPkt->StartupMs          = KitTo.StartupMs;
+
    /*
    ** PKTTBL Data
    */
 
-   HkPkt->PktTblLastLoadStatus  = KitTo.PktTbl.LastLoadStatus;
-   HkPkt->PktTblAttrErrCnt      = KitTo.PktTbl.LastLoadCnt;
+   HkPkt->PktTblLastLoadStatus  = PktMgr->PktTbl.LastLoadStatus;
+   HkPkt->PktTblRestoreSrc      = KitTo.PktTblRestoreSrc;
+   HkPkt->PktTblAttrErrCnt      = PktMgr->PktTbl.LastLoadCnt;
+   PKTTBL_GetHashStats(&(PktMgr->PktTbl.Data), &HkPkt->PktTblHashCollisions, &HkPkt->PktTblHashMaxProbe);
+   HkPkt->PktTblRestoreMs       = KitTo.PktTblRestoreMs;
+   HkPkt->PktTblLastLoadMs      = PktMgr->PktTbl.LastLoadMs;
 
    /*
    ** PKTMGR Data
@@ -555,18 +925,181 @@ static void SendHousekeepingPkt(void)
    **   separate diagnostic. Also easier for the user not to have to command it.
    */
 
-   HkPkt->StatsValid  = (KitTo.PktMgr.Stats.State == PKTMGR_STATS_VALID);
-   HkPkt->PktsPerSec  = round(KitTo.PktMgr.Stats.AvgPktsPerSec);
-   HkPkt->BytesPerSec = round(KitTo.PktMgr.Stats.AvgBytesPerSec);
-
-   HkPkt->TlmSockId = (uint16)KitTo.PktMgr.TlmSockId;
-   strncpy(HkPkt->TlmDestIp, KitTo.PktMgr.TlmDestIp, PKTMGR_IP_STR_LEN);
+   HkPkt->ChannelCnt    = KitTo.ChannelCnt;
+   HkPkt->CmdChannel    = KitTo.CmdChannel;
+   HkPkt->StatsValid    = (PktMgr->Stats.State == PKTMGR_STATS_VALID);
+   HkPkt->ActiveProfile = (uint8)PktMgr->ActiveProfile;
+   HkPkt->PktsPerSec  = round(PktMgr->Stats.AvgPktsPerSec);
+   HkPkt->BytesPerSec = round(PktMgr->Stats.AvgBytesPerSec);
+
+   HkPkt->TlmSockId = (uint16)PktMgr->TlmSockId;
+   strncpy(HkPkt->TlmDestIp, PktMgr->TlmDestIp, PKTMGR_IP_STR_LEN);
+   HkPkt->RetryQueueCnt     = PktMgr->RetryQueueCnt;
+   HkPkt->OutputBoundCycles = PktMgr->OutputBoundCycles;
+   HkPkt->RetryDropCnt        = PktMgr->RetryDropCnt;
+   HkPkt->SendTransientErrCnt = PktMgr->SendTransientErrCnt;
+   HkPkt->OutputRateLimit     = PktMgr->RateLimit;
+   HkPkt->RateLimitCycles     = PktMgr->RateLimitCycles;
+   HkPkt->FeedbackRate        = PktMgr->FeedbackEna ? PktMgr->FeedbackRate : 0;
+   HkPkt->FeedbackLossCnt     = PktMgr->FeedbackLossSum;
+   HkPkt->FeedbackRptCnt      = PktMgr->FeedbackRptCnt;
+   HkPkt->FeedbackTimeoutCnt  = PktMgr->FeedbackTimeoutCnt;
+   HkPkt->StaleDropCnt        = PktMgr->StaleDropCnt;
+   HkPkt->SupersededCnt       = PktMgr->SupersededCnt;
+   HkPkt->CoalesceFullCnt     = PktMgr->CoalesceFullCnt;
+   HkPkt->LvcEntryCnt         = PktMgr->LvcEntryCnt;
+   HkPkt->SnapshotActive      = PktMgr->SnapshotActive;
+   HkPkt->LvcPoolUsed         = PktMgr->LvcPoolUsed;
+   HkPkt->LvcFullCnt          = PktMgr->LvcFullCnt;
+   HkPkt->ReorderWindow       = PktMgr->ReorderWindow;
+   HkPkt->ReorderCnt          = PktMgr->ReorderCnt;
+   HkPkt->ReorderLateCnt      = PktMgr->ReorderLateCnt;
+   HkPkt->ReorderFullCnt      = PktMgr->ReorderFullCnt;
+   HkPkt->WorkerCnt           = PktMgr->WorkerCnt;
+   HkPkt->WorkerCycleMs       = PktMgr->WorkerCycleMs;
+   HkPkt->WorkerPktCntMax     = 0;
+   HkPkt->WorkerPktCntMin     = 0;
+   for (i=0; i < PktMgr->WorkerCnt; i++)
+   {
+      if ((i == 0) || (PktMgr->Worker[i].PktCnt > HkPkt->WorkerPktCntMax)) HkPkt->WorkerPktCntMax = PktMgr->Worker[i].PktCnt;
+      if ((i == 0) || (PktMgr->Worker[i].PktCnt < HkPkt->WorkerPktCntMin)) HkPkt->WorkerPktCntMin = PktMgr->Worker[i].PktCnt;
+   }
+   HkPkt->PipelineEna         = PktMgr->PipelineEna;
+   HkPkt->PipeRingLen         = PKTMGR_PIPELINE_LEN;
+   HkPkt->PipeMsgCnt          = PktMgr->PipeMsgCnt;
+   HkPkt->PipeMsgPeak         = PktMgr->PipeMsgPeak;
+   HkPkt->PipeDatagramCnt     = PktMgr->PipeDatagramCnt;
+   HkPkt->PipeDatagramPeak    = PktMgr->PipeDatagramPeak;
+   HkPkt->PipeRcvStallCnt     = PktMgr->PipeRcvStallCnt;
+   HkPkt->PipePackStarveCnt   = PktMgr->PipePackStarveCnt;
+   HkPkt->PipePackStallCnt    = PktMgr->PipePackStallCnt;
+   HkPkt->PipeSendStarveCnt   = PktMgr->PipeSendStarveCnt;
+   HkPkt->PipeInlineCnt       = PktMgr->PipeInlineCnt;
+   HkPkt->PipePackErrCnt      = PktMgr->PipePackErrCnt;
+   HkPkt->PipeDropCnt         = PktMgr->PipeDropCnt;
 
    HkPkt->EvtPlbkEna      = KitTo.EvtPlbk.Enabled;
    HkPkt->EvtPlbkHkPeriod = (uint8)KitTo.EvtPlbk.HkCyclePeriod;
+
+   HkPkt->ContactSchEna    = KitTo.ContactSch.Enabled;
+   HkPkt->ContactSchState  = KitTo.ContactSch.State;
+   HkPkt->ContactSchWindow = (KitTo.ContactSch.WindowIdx < KitTo.ContactSch.Data.WindowCnt) ?
+                             KitTo.ContactSch.WindowIdx : CONTACT_SCH_NO_WINDOW;
+
+   HkPkt->TlmRecState       = KitTo.TlmRec.State;
+   HkPkt->TlmRecFreezeCnt   = KitTo.TlmRec.FreezeCnt;
+   HkPkt->TlmRecCnt         = (KitTo.TlmRec.State == TLM_REC_STATE_RECORDING) ? KitTo.TlmRec.RecCnt : KitTo.TlmRec.DumpLeft;
+   HkPkt->TlmRecBytes       = KitTo.TlmRec.RecBytes;
+   HkPkt->TlmRecTooLargeCnt = KitTo.TlmRec.TooLargeCnt;
    
    CFE_SB_TimeStampMsg(CFE_MSG_PTR(KitTo.HkPkt.TlmHeader));
    CFE_SB_TransmitMsg(CFE_MSG_PTR(KitTo.HkPkt.TlmHeader), true);
 
+   for (i=0; i < KitTo.ChannelCnt; i++)
+   {
+      SendChannelTlm(i);
+   }
+
 } /* End SendHousekeepingPkt() */
 
+
+/******************************************************************************
+** Function: UpdateCmdLatency
+**
+** Notes:
+**   1. Command headers only carry a time stamp on missions that configure a
+**      command secondary header with time. If the time can't be retrieved the
+**      latency is bounded by the time since the command pipe was last empty.
+**   2. The running sum is restarted if it would overflow so the average
+**      remains meaningful after long runs without a reset command.
+*/
+static void UpdateCmdLatency(const CFE_MSG_Message_t *MsgPtr)
+{
+
+   uint32 Latency;
+   CFE_TIME_SysTime_t CmdTime;
+   
+   if ((CFE_MSG_GetMsgTime(MsgPtr, &CmdTime) == CFE_SUCCESS) &&
+       ((CmdTime.Seconds != 0) || (CmdTime.Subseconds != 0)))
+   {
+      Latency = KIT_TO_ElapsedMilliSecs(CmdTime);
+   }
+   else
+   {
+      Latency = KIT_TO_ElapsedMilliSecs(KitTo.CmdPipeEmptyTime);
+   }
+   
+   if ((KitTo.CmdLatencySum + Latency) < KitTo.CmdLatencySum)
+   {
+      KitTo.CmdLatencyCnt = 0;
+      KitTo.CmdLatencySum = 0;
+   }
+   
+   ++KitTo.CmdLatencyCnt;
+   KitTo.CmdLatencySum += Latency;
+   if (Latency > KitTo.CmdLatencyMax) KitTo.CmdLatencyMax = Latency;
+
+} /* End UpdateCmdLatency() */
+
+
+/******************************************************************************
+** Function: UpdateStartupMode
+**
+** Notes:
+**   1. Called after each startup mode output cycle. The number of packets
+**      read by all channels during the cycle is used as a measure of the
+**      pipe backlog.
+**   2. A cycle is calm when no channel's drain reached its output budget
+**      and the backlog is no more than the configured calm backlog. Steady
+**      housekeeping traffic means the pipe is rarely empty so an empty pipe
+**      can't be required. The backlog test is needed because a pipe that
+**      is shallower than the output budget never reaches it. A channel's
+**      OutputBoundCycles changes when its drain hit the budget.
+**   3. A zero startup timeout means startup mode only ends after the
+**      configured number of calm cycles.
+*/
+static void UpdateStartupMode(void)
+{
+
+   uint16 i;
+   uint16 PktsRead = 0;
+   uint32 BoundCycles = 0;
+   bool   BudgetReached;
+   uint32 StartupMs;
+   
+   for (i=0; i < KitTo.ChannelCnt; i++)
+   {
+      PktsRead    += KitTo.PktMgr[i].OutputPktsRead;
+      BoundCycles += KitTo.PktMgr[i].OutputBoundCycles;
+   }
+   
+   BudgetReached = (BoundCycles != KitTo.StartupBoundCycles);
+   KitTo.StartupBoundCycles = BoundCycles;
+   
+   if (PktsRead > KitTo.StartupPeakBacklog) KitTo.StartupPeakBacklog = PktsRead;
+   
+   if (!BudgetReached && (PktsRead <= KitTo.StartupCalmBacklog))
+   {
+      ++KitTo.StartupCalmCnt;
+   }
+   else
+   {
+      KitTo.StartupCalmCnt = 0;
+   }
+   
+   StartupMs = KIT_TO_ElapsedMilliSecs(KitTo.StartupTime);
+   
+   if ((KitTo.StartupCalmCnt >= KitTo.StartupCalmCycles) ||
+       ((KitTo.StartupTimeout > 0) && (StartupMs >= KitTo.StartupTimeout)))
+   {
+   
+      KitTo.StartupMode = false;
+      KitTo.StartupMs   = (StartupMs == 0) ? 1 : StartupMs;
+      
+      CFE_EVS_SendEvent(KIT_TO_STARTUP_COMPLETE_EID, CFE_EVS_EventType_INFORMATION, 
+                        "Startup mode %s after %d ms with a peak backlog of %d packets",
+                        (KitTo.StartupCalmCnt >= KitTo.StartupCalmCycles) ? "completed" : "timed out",
+                        KitTo.StartupMs, KitTo.StartupPeakBacklog);
+   }
+
+} /* End UpdateStartupMode() */
@@ -38,6 +38,8 @@
 #include "pkttbl.h"
 #include "pktmgr.h"
 #include "evt_plbk.h"
+#include "contact_sch.h"
+#include "tlm_rec.h"
 
 
 /***********************/
@@ -57,6 +59,17 @@
 #define KIT_TO_INVALID_RUN_LOOP_DELAY_EID (KIT_TO_APP_BASE_EID + 6)
 #define KIT_TO_DEMO_EID                   (KIT_TO_APP_BASE_EID + 7)
 #define KIT_TO_TEST_FILTER_EID            (KIT_TO_APP_BASE_EID + 8)
+#define KIT_TO_STARTUP_COMPLETE_EID       (KIT_TO_APP_BASE_EID + 9)
+#define KIT_TO_PKT_TBL_RESTORE_EID        (KIT_TO_APP_BASE_EID + 10)
+#define KIT_TO_SELECT_CHANNEL_EID         (KIT_TO_APP_BASE_EID + 11)
+#define KIT_TO_SELECT_CHANNEL_ERR_EID     (KIT_TO_APP_BASE_EID + 12)
+
+/*
+** Source of the packet table at initialization
+*/
+
+#define KIT_TO_PKT_TBL_SRC_FILE  1
+#define KIT_TO_PKT_TBL_SRC_CDS   2
 
 
 /**********************/
@@ -89,6 +102,16 @@ typedef struct
 #define KIT_TO_TEST_FILTER_CMD_DATA_LEN  (sizeof(KIT_TO_TestFilterCmdMsg_t) - sizeof(CFE_MSG_CommandHeader_t))
 
 
+typedef struct
+{
+
+   CFE_MSG_CommandHeader_t  CmdHeader;
+   uint16   Channel;
+
+} KIT_TO_SelectChannelCmdMsg_t;
+#define KIT_TO_SELECT_CHANNEL_CMD_DATA_LEN  (sizeof(KIT_TO_SelectChannelCmdMsg_t) - sizeof(CFE_MSG_CommandHeader_t))
+
+
 /******************************************************************************
 ** Telemetry Packets
 */
@@ -105,25 +128,76 @@ typedef struct
 
 
    uint16   RunLoopDelay;
+   uint16   CmdLatencyAvg;    /* Milliseconds */
+   uint16   CmdLatencyMax;    /* Milliseconds */
+   uint16   WakeupCnt;
+   uint16   WakeupTimeoutCnt;
+   uint16   StartupPeakBacklog;   /* Max packets read in one startup cycle */
+   uint32   StartupMs;            /* Duration of startup mode, 0 while still in startup */
 
    /*
    ** PKTTBL Data
    */
 
    uint8    PktTblLastLoadStatus;
-   uint8    PktTblSpareAlignByte;
+   uint8    PktTblRestoreSrc;       /* KIT_TO_PKT_TBL_SRC_FILE or KIT_TO_PKT_TBL_SRC_CDS */
    uint16   PktTblAttrErrCnt;
+   uint16   PktTblHashCollisions;   /* Active entries not in their home slot */
+   uint16   PktTblHashMaxProbe;     /* Longest probe sequence of an active entry */
+   uint32   PktTblRestoreMs;        /* Time to restore from CDS or start the file load at initialization */
+   uint32   PktTblLastLoadMs;       /* Time from load command to the new table being applied */
 
    /*
    ** PKTMGR Data
+   ** - The packet table and PKTMGR fields report the command channel
    */
 
+   uint16   ChannelCnt;
+   uint16   CmdChannel;             /* Channel that receives packet table commands */
    uint8    StatsValid;
-   uint8    PktMgrSpareAlignByte;
+   uint8    ActiveProfile;          /* Packet table profile index */
    uint16   PktsPerSec;
    uint32   BytesPerSec;
    uint16   TlmSockId;
    char     TlmDestIp[PKTMGR_IP_STR_LEN];
+   uint16   RetryQueueCnt;
+   uint32   OutputBoundCycles;
+   uint32   RetryDropCnt;
+   uint32   SendTransientErrCnt;
+   uint32   OutputRateLimit;        /* Bytes per second, 0=No limit */
+   uint32   RateLimitCycles;
+   uint32   FeedbackRate;           /* Bytes per second, 0 when feedback is disabled */
+   uint32   FeedbackLossCnt;        /* Losses reported by the ground since the last reset */
+   uint16   FeedbackRptCnt;
+   uint16   FeedbackTimeoutCnt;
+   uint32   StaleDropCnt;           /* Packets dropped for exceeding their max age */
+   uint32   SupersededCnt;          /* Coalesced packets replaced by a newer packet */
+   uint32   CoalesceFullCnt;        /* Coalescing packets sent without coalescing   */
+   uint16   LvcEntryCnt;            /* Entries with a cached last value */
+   uint16   SnapshotActive;
+   uint32   LvcPoolUsed;            /* Last value cache pool bytes in use */
+   uint32   LvcFullCnt;             /* Packets not cached because the pool was full */
+   uint16   ReorderWindow;          /* Ms, 0=Time ordered output disabled */
+   uint16   ReorderCnt;             /* Packets held for time ordering */
+   uint32   ReorderLateCnt;         /* Packets that arrived after the reorder window */
+   uint32   ReorderFullCnt;         /* Packets released early, reorder heap full */
+   uint16   WorkerCnt;              /* Output workers, 0=Output on the app task */
+   uint16   WorkerCycleMs;          /* Last output cycle's worker fork to join time */
+   uint32   WorkerPktCntMax;        /* Most packets sent by one worker since the last reset */
+   uint32   WorkerPktCntMin;        /* Fewest packets sent by one worker since the last reset */
+   uint16   PipelineEna;
+   uint16   PipeRingLen;            /* Slots in each pipeline ring */
+   uint16   PipeMsgCnt;             /* Receive to pack ring occupancy */
+   uint16   PipeMsgPeak;
+   uint16   PipeDatagramCnt;        /* Pack to send ring occupancy */
+   uint16   PipeDatagramPeak;
+   uint32   PipeRcvStallCnt;        /* Receive cycles ended by a full pack ring */
+   uint32   PipePackStarveCnt;      /* Pack stage waits for received packets */
+   uint32   PipePackStallCnt;       /* Pack stage waits for a free send ring slot */
+   uint32   PipeSendStarveCnt;      /* Send stage waits for packed datagrams */
+   uint32   PipeInlineCnt;          /* Packets too large for a ring slot, sent by the app task */
+   uint32   PipePackErrCnt;         /* Packets the pack stage or app task failed to pack */
+   uint32   PipeDropCnt;            /* Packets dropped when the pipeline was stopped */
    
    /*
    ** EVT_PLBK Data
@@ -132,10 +206,63 @@ typedef struct
    uint8    EvtPlbkEna;
    uint8    EvtPlbkHkPeriod;
    
+   /*
+   ** CONTACT_SCH Data
+   */
+   
+   uint8    ContactSchEna;
+   uint8    ContactSchState;
+   uint16   ContactSchWindow;       /* Current or next window index, 0xFFFF if none */
+   
+   /*
+   ** TLM_REC Data
+   */
+   
+   uint16   TlmRecState;
+   uint16   TlmRecFreezeCnt;
+   uint16   TlmRecSpareAlignWord;
+   uint32   TlmRecCnt;              /* Records held, or remaining to dump while frozen */
+   uint32   TlmRecBytes;            /* Ring bytes held by records */
+   uint32   TlmRecTooLargeCnt;
+   
 } KIT_TO_HkPkt_t;
 #define KIT_TO_TLM_HK_LEN sizeof (KIT_TO_HkPkt_t)
 
 
+/*
+** Sent for every channel with the housekeeping packet, which only reports
+** the command channel's PKTMGR data
+*/
+typedef struct
+{
+
+   CFE_MSG_TelemetryHeader_t TlmHeader;
+
+   uint16   Channel;
+   uint8    DownlinkOn;
+   uint8    SuppressSend;
+   uint8    StatsValid;
+   uint8    PktTblLastLoadStatus;
+   uint16   PktsPerSec;
+   uint32   BytesPerSec;
+   char     TlmDestIp[PKTMGR_IP_STR_LEN];
+   uint16   ActiveProfile;
+   uint16   RetryQueueCnt;
+   uint32   OutputBoundCycles;
+   uint32   RetryDropCnt;
+   uint32   SendTransientErrCnt;
+   uint32   RateLimitCycles;
+   uint32   FeedbackRate;           /* Bytes per second, 0 when feedback is disabled */
+   uint32   StaleDropCnt;
+   uint32   ReorderLateCnt;
+   uint32   PipeInlineCnt;
+   uint32   PipePackErrCnt;
+   uint32   PipeDropCnt;
+
+} KIT_TO_ChannelTlm_t;
+#define KIT_TO_TLM_CHANNEL_LEN sizeof (KIT_TO_ChannelTlm_t)
+
+
 
 typedef struct
 {
@@ -184,6 +311,7 @@ typedef struct
    */
 
    KIT_TO_HkPkt_t        HkPkt;
+   KIT_TO_ChannelTlm_t   ChannelTlm;
    KIT_TO_DataTypePkt_t  DataTypePkt;
 
 
@@ -193,14 +321,65 @@ typedef struct
    
    CFE_SB_MsgId_t  CmdMid;
    CFE_SB_MsgId_t  SendHkMid;
+   CFE_SB_MsgId_t  WakeupMid;
+   
+   /*
+   ** When wakeups are enabled the main loop pends on the wakeup pipe using 
+   ** the run loop delay as a timeout so output is synchronized with the
+   ** scheduler's timeline.
+   */
+   bool             WakeupEna;
+   CFE_SB_PipeId_t  WakeupPipe;
+   uint16           WakeupCnt;
+   uint16           WakeupTimeoutCnt;
+   
+   /*
+   ** Startup mode uses a short loop delay to keep up with the boot event
+   ** storm. It ends after a number of consecutive calm cycles or when the
+   ** startup timeout expires. See UpdateStartupMode() for what counts as
+   ** calm.
+   */
+   bool                StartupMode;
+   CFE_TIME_SysTime_t  StartupTime;
+   uint16  StartupDelay;
+   uint16  StartupCalmCycles;
+   uint16  StartupCalmCnt;
+   uint16  StartupCalmBacklog;
+   uint32  StartupBoundCycles;
+   uint16  StartupPeakBacklog;
+   uint32  StartupTimeout;
+   uint32  StartupMs;
    
    uint16  RunLoopDelay;
    uint16  RunLoopDelayMin;
    uint16  RunLoopDelayMax;
 
-   PKTTBL_Class_t    PktTbl;
-   PKTMGR_Class_t    PktMgr;
+   uint16  CmdPipeLimit;        /* Max commands processed per cycle */
+
+   uint8   PktTblRestoreSrc;
+   uint32  PktTblRestoreMs;
+
+   /*
+   ** Output channels. Packet table and output commands are routed to
+   ** CmdChannel.
+   */
+   uint16  ChannelCnt;
+   uint16  CmdChannel;
+
+   /*
+   ** Command latency is measured from the command's time stamp when it has
+   ** one, otherwise from the last time the command pipe was found empty which
+   ** bounds how long a command could have been waiting.
+   */
+   CFE_TIME_SysTime_t  CmdPipeEmptyTime;
+   uint32  CmdLatencyCnt;
+   uint32  CmdLatencySum;       /* Milliseconds */
+   uint32  CmdLatencyMax;       /* Milliseconds */
+
+   PKTMGR_Class_t    PktMgr[PKTMGR_MAX_CHANNELS];
    EVT_PLBK_Class_t  EvtPlbk;
+   CONTACT_SCH_Class_t  ContactSch;
+   TLM_REC_Class_t      TlmRec;
    
 } KIT_TO_Class_t;
 
@@ -244,6 +423,20 @@ bool KIT_TO_NoOpCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
 bool KIT_TO_ResetAppCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
 
 
+/******************************************************************************
+** Function: KIT_TO_SelectChannelCmd
+**
+** Route subsequent packet table and output commands to the commanded
+** output channel.
+**
+** Notes:
+**   1. Function signature must match the CMDMGR_CmdFuncPtr_t definition
+**   2. Table load and dump commands use the table ID so they aren't routed.
+**
+*/
+bool KIT_TO_SelectChannelCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
 /******************************************************************************
 ** Function: KIT_TO_SetRunLoopDelayCmd
 **
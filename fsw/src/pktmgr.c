@@ -19,8 +19,9 @@
 **  Notes:
 **   1. This has some of the features of a flight app such as packet
 **      filtering but it would need design/code reviews to transition it to a
-**      flight mission. For starters it uses UDP sockets and it doesn't
-**      regulate output bit rates. 
+**      flight mission. For starters it uses UDP sockets.
+**   2. Output bit rates are regulated by a token bucket rate limit that is
+**      set by the contact schedule or ground receiver feedback.
 **
 **  References:
 **    1. OpenSatKit Object-based Application Developer's Guide
@@ -32,9 +33,10 @@
 ** Include Files:
 */
 
-#include <errno.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
 #include <string.h>
-#include <unistd.h>
 
 #include "osapi.h"
 
@@ -48,60 +50,263 @@
 
 #include "app_cfg.h"
 #include "pktmgr.h"
+#include "tlm_rec.h"
 
 
 /******************************/
 /** File Function Prototypes **/
 /******************************/
 
-static void  ComputeStats(uint16 PktsSent, uint32 BytesSent);
-static void  DestructorCallback(void);
-static void  FlushTlmPipe(void);
-static bool  LoadPktTbl(PKTTBL_Data_t* NewTbl);
-static int32 PackEdsOutputMessage(void *DestBuffer, const CFE_MSG_Message_t *SrcBuffer, 
-                                  size_t SrcBufferSize, size_t *EdsDataSize);
-static int32 SubscribeNewPkt(PKTTBL_Pkt_t *NewPkt);
+static void   AppendFailedIdx(char *IdxStr, uint16 Idx);
+static bool   BulkEntryCntValid(const char *CmdName, uint16 EntryCnt);
+static bool   ChildOutputConflict(PKTMGR_Class_t *PktMgr, uint16 EventId, const char *OutputStr);
+static uint16 CoalesceEntryCnt(const PKTTBL_Data_t *Tbl);
+static bool   CoalescePkt(PKTMGR_Class_t *PktMgr, const CFE_MSG_Message_t *MsgPtr, const PKTTBL_Pkt_t *PktPtr, CFE_MSG_Size_t MsgLen);
+static void   CoalesceSend(PKTMGR_Class_t *PktMgr, const OS_SockAddr_t *SocketAddr, uint16 *PktsSent, uint32 *BytesSent);
+static void   ComputePlan(PKTMGR_Class_t *PktMgr, const PKTTBL_Data_t *Tbl);
+static void   ComputeStats(PKTMGR_Class_t *PktMgr, uint16 PktsSent, uint32 BytesSent);
+static uint32 CounterDelta(uint32 *Counter, uint32 *Prev);
+static void   CreatePipeline(PKTMGR_Class_t *PktMgr);
+static void   CreateWorkers(PKTMGR_Class_t *PktMgr, const char *PipeName, uint16 WorkerCnt);
+static void   DestructorCallback(void);
+static bool   EnableOutput(PKTMGR_Class_t *PktMgr);
+static const PKTMGR_PktStats_t *FindPktStats(PKTMGR_Class_t *PktMgr, uint16 MsgId);
+static void   FlushTlmPipe(PKTMGR_Class_t *PktMgr);
+static PKTMGR_PktStats_t *GetPktStats(PKTMGR_Class_t *PktMgr, const PKTTBL_Pkt_t *PktPtr);
+static PKTMGR_Class_t *GetTaskInstance(uint16 *WorkerIdx);
+static bool   IsTransientSendErr(int32 SocketStatus, uint16 *ErrRun);
+static bool   LoadPktTbl(void *Owner, PKTTBL_Data_t* NewTbl);
+static void   LvcClear(PKTMGR_Class_t *PktMgr);
+static void   LvcStore(PKTMGR_Class_t *PktMgr, const PKTTBL_Pkt_t *PktPtr, const void *Datagram, size_t DatagramLen, uint32 MsgLen);
+static bool   OutputBudgetReached(PKTMGR_Class_t *PktMgr, uint16 PktsRead, CFE_TIME_SysTime_t StartTime);
+static int32  PackEdsOutputMessage(void *DestBuffer, const CFE_MSG_Message_t *SrcBuffer, 
+                                   size_t SrcBufferSize, size_t *EdsDataSize);
+static void   PlanPktTbl(void *Owner, const PKTTBL_Data_t *NewTbl, const char *Filename);
+static void   RecorderSend(PKTMGR_Class_t *PktMgr, const OS_SockAddr_t *SocketAddr, uint16 *PktsSent, uint32 *BytesSent);
+static void   RefillRateTokens(PKTMGR_Class_t *PktMgr, uint32 RateLimit);
+static uint32 RingCnt(PKTMGR_Ring_t *Ring);
+static void   RingPop(PKTMGR_Ring_t *Ring);
+static void   RingPush(PKTMGR_Ring_t *Ring);
+static bool   RingWaitForData(PKTMGR_Ring_t *Ring, uint32 *Slot, uint32 *StarveCnt);
+static bool   RingWaitForSpace(PKTMGR_Ring_t *Ring, uint32 *Slot, uint32 *StallCnt);
+static void   ReorderAdd(PKTMGR_Class_t *PktMgr, const void *Datagram, size_t DatagramLen, uint32 MsgLen, const CFE_MSG_Message_t *MsgPtr,
+                         const OS_SockAddr_t *SocketAddr, uint16 *PktsSent, uint32 *BytesSent);
+static bool   ReorderBefore(PKTMGR_Class_t *PktMgr, uint16 EntryA, uint16 EntryB);
+static void   ReorderClear(PKTMGR_Class_t *PktMgr);
+static uint64 ReorderKey(CFE_TIME_SysTime_t Time);
+static PKTMGR_ReorderEntry_t *ReorderPop(PKTMGR_Class_t *PktMgr);
+static void   ReorderRelease(PKTMGR_Class_t *PktMgr, const OS_SockAddr_t *SocketAddr, uint16 *PktsSent, uint32 *BytesSent);
+static uint32 OutputRateLimit(PKTMGR_Class_t *PktMgr);
+static void   OpenFeedbackSocket(PKTMGR_Class_t *PktMgr, uint16 Port);
+static bool   OpenWorkerSockets(PKTMGR_Class_t *PktMgr);
+static void   ProcessFeedback(PKTMGR_Class_t *PktMgr);
+static void   ProcessFeedbackRpt(PKTMGR_Class_t *PktMgr, const uint8 *Rpt);
+static bool   PipelineDrain(PKTMGR_Class_t *PktMgr);
+static void   PipelinePackTask(void);
+static void   PipelineReceive(PKTMGR_Class_t *PktMgr, const OS_SockAddr_t *SocketAddr, uint16 *PktsRead, bool *BudgetReached,
+                              uint16 *PktsSent, uint32 *BytesSent);
+static void   PipelineSendTask(void);
+static bool   PktExpired(const CFE_MSG_Message_t *MsgPtr, uint16 MaxAge, CFE_TIME_SysTime_t Now);
+static CFE_SB_PipeId_t PktPipe(PKTMGR_Class_t *PktMgr, uint16 MsgId);
+static const char *ProfileNameStr(const PKTTBL_Data_t *Tbl, uint16 Profile);
+static bool   RetryQueueAdd(PKTMGR_Class_t *PktMgr, const void *Datagram, size_t DatagramLen, uint32 MsgLen);
+static void   RetryQueueClear(PKTMGR_Class_t *PktMgr);
+static int32  RetryQueueSend(PKTMGR_Class_t *PktMgr, const OS_SockAddr_t *SocketAddr, uint16 *PktsSent, uint32 *BytesSent);
+static void   SaveCdsImage(PKTMGR_Class_t *PktMgr);
+static int32  SendDatagram(PKTMGR_Class_t *PktMgr, const void *Datagram, size_t DatagramLen, uint32 MsgLen,
+                           const OS_SockAddr_t *SocketAddr, uint16 *PktsSent, uint32 *BytesSent);
+static int32  SendSocket(osal_id_t SockId, const void *Datagram, size_t DatagramLen, const OS_SockAddr_t *SocketAddr);
+static void   SendOrQueueDatagram(PKTMGR_Class_t *PktMgr, const void *Datagram, size_t DatagramLen, uint32 MsgLen,
+                                  const OS_SockAddr_t *SocketAddr, uint16 *PktsSent, uint32 *BytesSent);
+static void   SnapshotSend(PKTMGR_Class_t *PktMgr, const OS_SockAddr_t *SocketAddr, uint16 *PktsSent, uint32 *BytesSent);
+static uint16 RunPipeline(PKTMGR_Class_t *PktMgr, uint32 RateLimit, bool RateLimited);
+static uint16 RunWorkers(PKTMGR_Class_t *PktMgr, uint32 RateLimit, bool RateLimited);
+static void   StartSnapshot(PKTMGR_Class_t *PktMgr);
+static int32  SubscribeNewPkt(PKTMGR_Class_t *PktMgr, PKTTBL_Pkt_t *NewPkt);
+static void   WorkerOutput(PKTMGR_Class_t *PktMgr, uint16 WorkerIdx);
+static void   StopPipeline(PKTMGR_Class_t *PktMgr, const char *Reason);
+static void   StopWorkers(PKTMGR_Class_t *PktMgr, uint16 LateWorker, uint32 JoinTimeout);
+static void   WorkerSend(PKTMGR_Worker_t *Worker, const OS_SockAddr_t *SocketAddr, const void *Datagram,
+                         size_t DatagramLen, uint32 MsgLen);
+static void   WorkerTask(void);
 
 /**********************/
 /** Global File Data **/
 /**********************/
 
-static PKTMGR_Class_t*  PktMgr = NULL;
-static CFE_HDR_TelemetryHeader_PackedBuffer_t SocketBuffer;
-static uint16 SocketBufferLen = sizeof(SocketBuffer);
+/*
+** Constructed channels indexed by channel number. cFE child tasks don't take
+** an argument so worker and pipeline stage tasks look up their channel by
+** task ID, see GetTaskInstance(). InstanceMutex is held while a child task
+** is created so its task ID is saved before the task can look it up.
+*/
+static PKTMGR_Class_t  *Instance[PKTMGR_MAX_CHANNELS];
+static uint16           InstanceCnt = 0;
+static osal_id_t        InstanceMutex;
+
+/* Failed entry index list reported in a bulk command's summary event */
+#define BULK_IDX_STR_LEN  48
 
 /******************************************************************************
 ** Function: PKTMGR_Constructor
 **
 */
-void PKTMGR_Constructor(PKTMGR_Class_t *PktMgrPtr, INITBL_Class_t *IniTbl)
+void PKTMGR_Constructor(PKTMGR_Class_t *PktMgr, INITBL_Class_t *IniTbl, uint16 Channel, uint8 TblId,
+                        TLM_REC_Class_t *TlmRec)
 {
 
-   PktMgr = PktMgrPtr;
-
+   int32  Status;
+   uint16 FeedbackPort;
+   uint16 WorkerCnt;
+   char   CdsName[CFE_MISSION_ES_CDS_MAX_NAME_LENGTH];
+   char   PipeName[OS_MAX_API_NAME];
+   
+   if (InstanceCnt++ == 0)
+   {
+      Status = OS_MutSemCreate(&InstanceMutex, "KIT_TO_PKTMGR_MUT", 0);
+      if (Status != OS_SUCCESS)
+      {
+         CFE_EVS_SendEvent(PKTMGR_WORKER_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Error creating the output task start mutex, status %d. Workers and pipeline will fail to start",
+                           (int)Status);
+      }
+   }
+   Instance[Channel] = PktMgr;
+   
    PktMgr->IniTbl       = IniTbl;
+   PktMgr->Channel      = Channel;
+   PktMgr->TlmRec       = TlmRec;
    PktMgr->DownlinkOn   = false;
    PktMgr->SuppressSend = true;
    PktMgr->TlmSockId    = 0;
-   PktMgr->TlmUdpPort   = INITBL_GetIntConfig(PktMgr->IniTbl, CFG_PKTMGR_UDP_TLM_PORT);
+   PktMgr->TlmUdpPort   = INITBL_GetIntConfig(PktMgr->IniTbl, CFG_PKTMGR_UDP_TLM_PORT) + Channel;
    strncpy(PktMgr->TlmDestIp, "000.000.000.000", PKTMGR_IP_STR_LEN);
 
-   PKTMGR_InitStats(INITBL_GetIntConfig(IniTbl, CFG_APP_RUN_LOOP_DELAY),
+   PktMgr->OutputPktLimit    = INITBL_GetIntConfig(IniTbl, CFG_PKTMGR_OUTPUT_PKT_LIMIT);
+   PktMgr->OutputTimeLimit   = INITBL_GetIntConfig(IniTbl, CFG_PKTMGR_OUTPUT_TIME_LIMIT);
+   PktMgr->OutputBoundCycles = 0;
+   PktMgr->OutputPktsRead    = 0;
+   PktMgr->LinkBudget        = INITBL_GetIntConfig(IniTbl, CFG_PKTMGR_LINK_BUDGET);
+   PktMgr->PktStatsStart     = CFE_TIME_GetTime();
+   PktMgr->ActiveProfile     = 0;
+   PktMgr->RateLimit         = 0;
+   PktMgr->RateTokens        = 0;
+   PktMgr->RateRefillTime    = CFE_TIME_GetTime();
+   PktMgr->RateLimitCycles   = 0;
+   PktMgr->HoldOutput        = false;
+   
+   PktMgr->FeedbackEna        = false;
+   PktMgr->FeedbackMinRate    = INITBL_GetIntConfig(IniTbl, CFG_PKTMGR_FEEDBACK_MIN_RATE);
+   PktMgr->FeedbackMaxRate    = INITBL_GetIntConfig(IniTbl, CFG_PKTMGR_FEEDBACK_MAX_RATE);
+   PktMgr->FeedbackIncrease   = INITBL_GetIntConfig(IniTbl, CFG_PKTMGR_FEEDBACK_INCREASE);
+   PktMgr->FeedbackDecrease   = INITBL_GetIntConfig(IniTbl, CFG_PKTMGR_FEEDBACK_DECREASE);
+   PktMgr->FeedbackTimeout    = INITBL_GetIntConfig(IniTbl, CFG_PKTMGR_FEEDBACK_TIMEOUT);
+   PktMgr->FeedbackRate       = PktMgr->FeedbackMinRate;
+   PktMgr->FeedbackTime       = CFE_TIME_GetTime();
+   PktMgr->FeedbackTimedOut   = false;
+   PktMgr->FeedbackRcvSeq     = 0;
+   PktMgr->FeedbackLossCnt    = 0;
+   PktMgr->FeedbackLimitCycles = 0;
+   PktMgr->FeedbackLossSum    = 0;
+   PktMgr->FeedbackRptCnt     = 0;
+   PktMgr->FeedbackTimeoutCnt = 0;
+   FeedbackPort = INITBL_GetIntConfig(IniTbl, CFG_PKTMGR_FEEDBACK_PORT);
+   OpenFeedbackSocket(PktMgr, (FeedbackPort == 0 ? 0 : FeedbackPort + Channel));
+   
+   PktMgr->RetryQueueHead      = 0;
+   PktMgr->RetryQueueCnt       = 0;
+   PktMgr->RetryDropCnt        = 0;
+   PktMgr->SendTransientErrCnt = 0;
+
+   PktMgr->LvcFullCnt       = 0;
+   PktMgr->SnapshotPkts     = INITBL_GetIntConfig(IniTbl, CFG_PKTMGR_SNAPSHOT_PKTS);
+   PktMgr->SnapshotOnEnable = (INITBL_GetIntConfig(IniTbl, CFG_PKTMGR_SNAPSHOT_ON_ENABLE) != 0);
+   PktMgr->SnapshotIdx      = 0;
+   PktMgr->SnapshotSentCnt  = 0;
+   LvcClear(PktMgr);
+
+   PktMgr->ReorderWindow  = INITBL_GetIntConfig(IniTbl, CFG_PKTMGR_REORDER_WINDOW);
+   PktMgr->ReorderLateCnt = 0;
+   PktMgr->ReorderFullCnt = 0;
+   PktMgr->Priv.ReorderWindowKey = ((uint64)(PktMgr->ReorderWindow/1000) << 32) + 
+                      CFE_TIME_Micro2SubSecs((PktMgr->ReorderWindow%1000)*1000);
+   ReorderClear(PktMgr);
+
+   /*
+   ** Channel 0 keeps the original CDS and pipe names so existing
+   ** configurations are unchanged. Other channels append their number.
+   */
+   if (Channel == 0)
+   {
+      strncpy(CdsName, PKTMGR_CDS_NAME, sizeof(CdsName));
+      strncpy(PipeName, INITBL_GetStrConfig(IniTbl, CFG_PKTMGR_PIPE_NAME), sizeof(PipeName));
+   }
+   else
+   {
+      snprintf(CdsName, sizeof(CdsName), "%s_%d", PKTMGR_CDS_NAME, Channel);
+      snprintf(PipeName, sizeof(PipeName), "%s_%d", INITBL_GetStrConfig(IniTbl, CFG_PKTMGR_PIPE_NAME), Channel);
+   }
+   CdsName[sizeof(CdsName)-1]   = '\0';
+   PipeName[sizeof(PipeName)-1] = '\0';
+   
+   Status = CFE_ES_RegisterCDS(&PktMgr->CdsHandle, sizeof(PKTMGR_CdsImage_t), CdsName);
+   PktMgr->CdsValid   = ((Status == CFE_SUCCESS) || (Status == CFE_ES_CDS_ALREADY_EXISTS));
+   PktMgr->CdsExisted = (Status == CFE_ES_CDS_ALREADY_EXISTS);
+   if (!PktMgr->CdsValid)
+   {
+      CFE_EVS_SendEvent(PKTMGR_CDS_RESTORE_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Error registering CDS %s, status 0x%08X. Packet table won't be preserved across resets",
+                        CdsName, (unsigned int)Status);
+   }
+
+   PktMgr->Stats.MeasureInterval = (INITBL_GetIntConfig(IniTbl, CFG_APP_WAKEUP_ENA) != 0);
+   PKTMGR_InitStats(PktMgr, INITBL_GetIntConfig(IniTbl, CFG_APP_RUN_LOOP_DELAY),
                     INITBL_GetIntConfig(IniTbl, CFG_PKTMGR_STATS_INIT_DELAY));
 
    PKTTBL_SetTblToUnused(&(PktMgr->PktTbl.Data));
 
    CFE_SB_CreatePipe(&(PktMgr->TlmPipe),
                      INITBL_GetIntConfig(IniTbl, CFG_PKTMGR_PIPE_DEPTH),
-                     INITBL_GetStrConfig(IniTbl, CFG_PKTMGR_PIPE_NAME));
+                     PipeName);
+   
+   PktMgr->WorkerTimeout = INITBL_GetIntConfig(IniTbl, CFG_PKTMGR_WORKER_TIMEOUT);
+   WorkerCnt = INITBL_GetIntConfig(IniTbl, CFG_PKTMGR_WORKERS);
+   if ((WorkerCnt > 0) && ChildOutputConflict(PktMgr, PKTMGR_WORKER_ERR_EID, "output workers"))
+   {
+      WorkerCnt = 0;
+   }
+   CreateWorkers(PktMgr, PipeName, WorkerCnt);
+   
+   PktMgr->PipelineEna = false;
+   if (INITBL_GetIntConfig(IniTbl, CFG_PKTMGR_PIPELINE) != 0)
+   {
+      if (PktMgr->WorkerCnt == 0)
+      {
+         if (!ChildOutputConflict(PktMgr, PKTMGR_PIPELINE_ERR_EID, "output pipeline"))
+         {
+            CreatePipeline(PktMgr);
+         }
+      }
+      else
+      {
+         CFE_EVS_SendEvent(PKTMGR_PIPELINE_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Channel %d output pipeline ignored because output workers are configured",
+                           PktMgr->Channel);
+      }
+   }
       
    CFE_MSG_Init(CFE_MSG_PTR(PktMgr->PktTlm), 
                 CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_KIT_TO_PKT_TBL_TLM_TOPICID)), 
                 PKTMGR_PKT_TLM_LEN);
    
+   CFE_MSG_Init(CFE_MSG_PTR(PktMgr->PlanTlm), 
+                CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_KIT_TO_PLAN_TLM_TOPICID)), 
+                PKTMGR_PLAN_TLM_LEN);
+   
    OS_TaskInstallDeleteHandler(&DestructorCallback); /* Called when application terminates */
 
-   PKTTBL_Constructor(&PktMgr->PktTbl, INITBL_GetStrConfig(IniTbl, CFG_APP_CFE_NAME), LoadPktTbl);
+   PKTTBL_Constructor(&PktMgr->PktTbl, IniTbl, INITBL_GetStrConfig(IniTbl, CFG_APP_CFE_NAME), 
+                      TblId, PktMgr, LoadPktTbl, PlanPktTbl);
 
 } /* End PKTMGR_Constructor() */
 
@@ -117,16 +322,14 @@ void PKTMGR_Constructor(PKTMGR_Class_t *PktMgrPtr, INITBL_Class_t *IniTbl)
 bool PKTMGR_AddPktCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
 
+   PKTMGR_Class_t *PktMgr = (PKTMGR_Class_t *)ObjDataPtr;
    const PKTMGR_AddPktCmdMsg_t *AddPktCmd = (const PKTMGR_AddPktCmdMsg_t *) MsgPtr;
    PKTTBL_Pkt_t  NewPkt;
    bool          RetStatus = true;
    int32         Status;
-   uint16        AppId;
 
    
-   AppId = AddPktCmd->MsgId & PKTTBL_APP_ID_MASK;
-   
-   if (PktMgr->PktTbl.Data.Pkt[AppId].MsgId == PKTTBL_UNUSED_MSG_ID)
+   if (PKTTBL_GetPkt(&(PktMgr->PktTbl.Data), AddPktCmd->MsgId) == NULL)
    {
       
       NewPkt.MsgId        = AddPktCmd->MsgId;
@@ -134,17 +337,29 @@ bool PKTMGR_AddPktCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
       NewPkt.BufLim       = AddPktCmd->BufLim;
       NewPkt.Filter.Type  = AddPktCmd->FilterType;
       NewPkt.Filter.Param = AddPktCmd->FilterParam;
+      NewPkt.ProfileMask  = PKTTBL_ALL_PROFILES;
+      NewPkt.MaxAge       = 0;
+      NewPkt.Coalesce     = false;
    
-      Status = SubscribeNewPkt(&NewPkt);
+      Status = SubscribeNewPkt(PktMgr, &NewPkt);
    
       if (Status == CFE_SUCCESS)
       {
 
-         PktMgr->PktTbl.Data.Pkt[AppId] = NewPkt;
-      
-         CFE_EVS_SendEvent(PKTMGR_ADD_PKT_SUCCESS_EID, CFE_EVS_EventType_INFORMATION,
-                           "Added message ID 0x%04X, QoS (%d,%d), BufLim %d",
-                           NewPkt.MsgId, NewPkt.Qos.Priority, NewPkt.Qos.Reliability, NewPkt.BufLim);
+         if (PKTTBL_SetPkt(&(PktMgr->PktTbl.Data), &NewPkt))
+         {
+            SaveCdsImage(PktMgr);
+            CFE_EVS_SendEvent(PKTMGR_ADD_PKT_SUCCESS_EID, CFE_EVS_EventType_INFORMATION,
+                              "Added message ID 0x%04X, QoS (%d,%d), BufLim %d",
+                              NewPkt.MsgId, NewPkt.Qos.Priority, NewPkt.Qos.Reliability, NewPkt.BufLim);
+         }
+         else
+         {
+            CFE_SB_Unsubscribe(CFE_SB_ValueToMsgId(NewPkt.MsgId), PktPipe(PktMgr, NewPkt.MsgId));
+            CFE_EVS_SendEvent(PKTMGR_ADD_PKT_ERROR_EID, CFE_EVS_EventType_ERROR,
+                              "Error adding message ID 0x%04X. Packet table is full",
+                              AddPktCmd->MsgId);
+         }
       }
       else
       {
@@ -169,51 +384,246 @@ bool PKTMGR_AddPktCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 
 
 /******************************************************************************
-** Function: PKTMGR_EnableOutputCmd
+** Function: PKTMGR_BulkAddPktCmd
 **
 */
-bool PKTMGR_EnableOutputCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+bool PKTMGR_BulkAddPktCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
 
-   const PKTMGR_EnableOutputCmdMsg_t *EnableOutputCmd = (const PKTMGR_EnableOutputCmdMsg_t *) MsgPtr;
-   bool  RetStatus = true;
-   int32 OsStatus;
+   PKTMGR_Class_t *PktMgr = (PKTMGR_Class_t *)ObjDataPtr;
+   const PKTMGR_BulkAddPktCmdMsg_t *BulkAddPktCmd = (const PKTMGR_BulkAddPktCmdMsg_t *) MsgPtr;
+   const PKTMGR_BulkAddPktEntry_t  *Entry;
+   PKTTBL_Pkt_t  NewPkt;
+   uint16        i;
+   uint16        FailedCnt = 0;
+   int32         Status;
+   char          FailedIdxStr[BULK_IDX_STR_LEN] = "";
+
+   
+   if (!BulkEntryCntValid("add", BulkAddPktCmd->EntryCnt)) return false;
+   
+   for (i=0; i < BulkAddPktCmd->EntryCnt; i++)
+   {
+      
+      Entry = &(BulkAddPktCmd->Entry[i]);
+      
+      if (PKTTBL_GetPkt(&(PktMgr->PktTbl.Data), Entry->MsgId) == NULL)
+      {
+         
+         NewPkt.MsgId        = Entry->MsgId;
+         NewPkt.Qos          = Entry->Qos;
+         NewPkt.BufLim       = Entry->BufLim;
+         NewPkt.Filter.Type  = Entry->FilterType;
+         NewPkt.Filter.Param = Entry->FilterParam;
+         NewPkt.ProfileMask  = PKTTBL_ALL_PROFILES;
+         NewPkt.MaxAge       = 0;
+         NewPkt.Coalesce     = false;
+      
+         Status = SubscribeNewPkt(PktMgr, &NewPkt);
+         if (Status == CFE_SUCCESS)
+         {
+            if (PKTTBL_SetPkt(&(PktMgr->PktTbl.Data), &NewPkt)) continue;
+            CFE_SB_Unsubscribe(CFE_SB_ValueToMsgId(NewPkt.MsgId), PktPipe(PktMgr, NewPkt.MsgId));
+         }
+      }
+      
+      ++FailedCnt;
+      AppendFailedIdx(FailedIdxStr, i);
+      
+   } /* End entry loop */
+   
+   SaveCdsImage(PktMgr);
    
-   strncpy(PktMgr->TlmDestIp, EnableOutputCmd->DestIp, PKTMGR_IP_STR_LEN);
+   CFE_EVS_SendEvent(PKTMGR_BULK_CMD_EID, 
+                     (FailedCnt == 0 ? CFE_EVS_EventType_INFORMATION : CFE_EVS_EventType_ERROR),
+                     "Bulk add of %d packets: %d added, %d failed%s%s",
+                     BulkAddPktCmd->EntryCnt, BulkAddPktCmd->EntryCnt-FailedCnt, FailedCnt,
+                     (FailedCnt == 0 ? "" : " at index "), FailedIdxStr);
+   
+   return (FailedCnt == 0);
 
-   PktMgr->SuppressSend = false;
-   CFE_EVS_SendEvent(PKTMGR_TLM_OUTPUT_ENA_INFO_EID, CFE_EVS_EventType_INFORMATION,
-                     "Telemetry output enabled for IP %s", PktMgr->TlmDestIp);
+} /* End PKTMGR_BulkAddPktCmd() */
 
-   /*
-   ** If disabled then create the socket and turn it on. If already
-   ** enabled then destination address is changed in the existing socket
-   */
-   if(PktMgr->DownlinkOn == false)
-   {
 
-      OsStatus = OS_SocketOpen(&PktMgr->TlmSockId, OS_SocketDomain_INET, OS_SocketType_DATAGRAM);
+/******************************************************************************
+** Function: PKTMGR_BulkRemovePktCmd
+**
+*/
+bool PKTMGR_BulkRemovePktCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   PKTMGR_Class_t *PktMgr = (PKTMGR_Class_t *)ObjDataPtr;
+   const PKTMGR_BulkRemovePktCmdMsg_t *BulkRemovePktCmd = (const PKTMGR_BulkRemovePktCmdMsg_t *) MsgPtr;
+   PKTTBL_Pkt_t *PktPtr;
+   bool    Subscribed;
+   uint16  i;
+   uint16  FailedCnt = 0;
+   char    FailedIdxStr[BULK_IDX_STR_LEN] = "";
 
-      if (OsStatus == OS_SUCCESS)
+   
+   if (!BulkEntryCntValid("remove", BulkRemovePktCmd->EntryCnt)) return false;
+   
+   for (i=0; i < BulkRemovePktCmd->EntryCnt; i++)
+   {
+      
+      PktPtr = PKTTBL_GetPkt(&(PktMgr->PktTbl.Data), BulkRemovePktCmd->MsgId[i]);
+      if (PktPtr != NULL)
       {
-         PKTMGR_InitStats(INITBL_GetIntConfig(PktMgr->IniTbl, CFG_APP_RUN_LOOP_DELAY),
-                          INITBL_GetIntConfig(PktMgr->IniTbl, CFG_PKTMGR_STATS_CONFIG_DELAY));
-         PktMgr->DownlinkOn = true;
+         Subscribed = PKTTBL_IN_PROFILE(PktPtr, PktMgr->ActiveProfile);
+         PKTTBL_RemovePkt(&(PktMgr->PktTbl.Data), BulkRemovePktCmd->MsgId[i]);
+         if (!Subscribed) continue;
+         if (CFE_SB_Unsubscribe(CFE_SB_ValueToMsgId(BulkRemovePktCmd->MsgId[i]), PktPipe(PktMgr, BulkRemovePktCmd->MsgId[i])) == CFE_SUCCESS) continue;
       }
-      else
+      
+      ++FailedCnt;
+      AppendFailedIdx(FailedIdxStr, i);
+      
+   } /* End entry loop */
+   
+   SaveCdsImage(PktMgr);
+   
+   CFE_EVS_SendEvent(PKTMGR_BULK_CMD_EID, 
+                     (FailedCnt == 0 ? CFE_EVS_EventType_INFORMATION : CFE_EVS_EventType_ERROR),
+                     "Bulk remove of %d packets: %d removed, %d failed%s%s",
+                     BulkRemovePktCmd->EntryCnt, BulkRemovePktCmd->EntryCnt-FailedCnt, FailedCnt,
+                     (FailedCnt == 0 ? "" : " at index "), FailedIdxStr);
+   
+   return (FailedCnt == 0);
+
+} /* End PKTMGR_BulkRemovePktCmd() */
+
+
+/******************************************************************************
+** Function: PKTMGR_BulkUpdateFilterCmd
+**
+*/
+bool PKTMGR_BulkUpdateFilterCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   PKTMGR_Class_t *PktMgr = (PKTMGR_Class_t *)ObjDataPtr;
+   const PKTMGR_BulkUpdateFilterCmdMsg_t *BulkUpdateFilterCmd = (const PKTMGR_BulkUpdateFilterCmdMsg_t *) MsgPtr;
+   const PKTMGR_BulkUpdateFilterEntry_t  *Entry;
+   PKTTBL_Pkt_t *PktPtr;
+   uint16  i;
+   uint16  FailedCnt = 0;
+   char    FailedIdxStr[BULK_IDX_STR_LEN] = "";
+
+   
+   if (!BulkEntryCntValid("update filter", BulkUpdateFilterCmd->EntryCnt)) return false;
+   
+   for (i=0; i < BulkUpdateFilterCmd->EntryCnt; i++)
+   {
+      
+      Entry  = &(BulkUpdateFilterCmd->Entry[i]);
+      PktPtr = PKTTBL_GetPkt(&(PktMgr->PktTbl.Data), Entry->MsgId);
+      
+      if ((PktPtr != NULL) && PktUtil_IsFilterTypeValid(Entry->FilterType))
       {
-         RetStatus = false;
-         CFE_EVS_SendEvent(PKTMGR_TLM_OUTPUT_ENA_SOCKET_ERR_EID, CFE_EVS_EventType_ERROR,
-                           "Telemetry output socket open error. Status = %d", OsStatus);
+         PktPtr->Filter.Type  = Entry->FilterType;
+         PktPtr->Filter.Param = Entry->FilterParam;
+         continue;
       }
+      
+      ++FailedCnt;
+      AppendFailedIdx(FailedIdxStr, i);
+      
+   } /* End entry loop */
+   
+   SaveCdsImage(PktMgr);
+   
+   CFE_EVS_SendEvent(PKTMGR_BULK_CMD_EID, 
+                     (FailedCnt == 0 ? CFE_EVS_EventType_INFORMATION : CFE_EVS_EventType_ERROR),
+                     "Bulk filter update of %d packets: %d updated, %d failed%s%s",
+                     BulkUpdateFilterCmd->EntryCnt, BulkUpdateFilterCmd->EntryCnt-FailedCnt, FailedCnt,
+                     (FailedCnt == 0 ? "" : " at index "), FailedIdxStr);
+   
+   return (FailedCnt == 0);
 
-   } /* End if downlink disabled */
+} /* End PKTMGR_BulkUpdateFilterCmd() */
+
+
+/******************************************************************************
+** Function: PKTMGR_DisableOutput
+**
+*/
+void PKTMGR_DisableOutput(PKTMGR_Class_t *PktMgr)
+{
+
+   PktMgr->SuppressSend = true;
+   RetryQueueClear(PktMgr);
+   ReorderClear(PktMgr);
+   SaveCdsImage(PktMgr);
+   CFE_EVS_SendEvent(PKTMGR_TLM_OUTPUT_ENA_INFO_EID, CFE_EVS_EventType_INFORMATION,
+                     "Telemetry output disabled");
+
+} /* End PKTMGR_DisableOutput() */
+
+
+/******************************************************************************
+** Function: PKTMGR_EnableOutput
+**
+** Notes:
+**   1. Datagrams waiting for a retry or held for reordering were addressed
+**      to the previous destination so they're discarded when it changes.
+*/
+bool PKTMGR_EnableOutput(PKTMGR_Class_t *PktMgr, const char *DestIp)
+{
+
+   bool  RetStatus;
+   
+   if (strncmp(PktMgr->TlmDestIp, DestIp, PKTMGR_IP_STR_LEN) != 0)
+   {
+      RetryQueueClear(PktMgr);
+      ReorderClear(PktMgr);
+   }
+   
+   strncpy(PktMgr->TlmDestIp, DestIp, PKTMGR_IP_STR_LEN);
+   PktMgr->TlmDestIp[PKTMGR_IP_STR_LEN-1] = '\0';
 
+   RetStatus = EnableOutput(PktMgr);
+   SaveCdsImage(PktMgr);
+   
+   if (RetStatus && PktMgr->SnapshotOnEnable)
+   {
+      StartSnapshot(PktMgr);
+   }
+   
    return RetStatus;
 
+} /* End PKTMGR_EnableOutput() */
+
+
+/******************************************************************************
+** Function: PKTMGR_EnableOutputCmd
+**
+*/
+bool PKTMGR_EnableOutputCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   PKTMGR_Class_t *PktMgr = (PKTMGR_Class_t *)ObjDataPtr;
+   const PKTMGR_EnableOutputCmdMsg_t *EnableOutputCmd = (const PKTMGR_EnableOutputCmdMsg_t *) MsgPtr;
+   char  DestIp[PKTMGR_IP_STR_LEN];
+   
+   strncpy(DestIp, EnableOutputCmd->DestIp, PKTMGR_IP_STR_LEN);
+   DestIp[PKTMGR_IP_STR_LEN-1] = '\0';
+   
+   return PKTMGR_EnableOutput(PktMgr, DestIp);
+
 } /* End PKTMGR_EnableOutputCmd() */
 
 
+/******************************************************************************
+** Function: PKTMGR_HoldOutput
+**
+*/
+void PKTMGR_HoldOutput(PKTMGR_Class_t *PktMgr, bool Hold)
+{
+
+   PktMgr->HoldOutput = Hold;
+
+} /* End PKTMGR_HoldOutput() */
+
+
 /******************************************************************************
 ** Function:  PKTMGR_InitStats
 **
@@ -221,7 +631,7 @@ bool PKTMGR_EnableOutputCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 ** ComputeStats() logic assumes at least 1 init cycle
 **
 */
-void PKTMGR_InitStats(uint16 OutputTlmInterval, uint16 InitDelay)
+void PKTMGR_InitStats(PKTMGR_Class_t *PktMgr, uint16 OutputTlmInterval, uint16 InitDelay)
 {
    
    if (OutputTlmInterval != 0) PktMgr->Stats.OutputTlmInterval = (double)OutputTlmInterval;
@@ -246,83 +656,242 @@ void PKTMGR_InitStats(uint16 OutputTlmInterval, uint16 InitDelay)
 ** Function: PKTMGR_OutputTelemetry
 **
 */
-uint16 PKTMGR_OutputTelemetry(void)
+uint16 PKTMGR_OutputTelemetry(PKTMGR_Class_t *PktMgr)
 {
 
-   int     SocketStatus;
    int32   SbStatus;
+   int32   PackStatus;
+   bool    BudgetReached = false;
+   bool    RateLimited;
+   bool    Packed = false;
+   uint32  RateLimit;
+   uint16  NumPktsRead    = 0;
    uint16  NumPktsOutput  = 0;
    uint32  NumBytesOutput = 0;
    size_t  EdsDataSize;
    
-   CFE_MSG_ApId_t   AppId;
+   CFE_SB_MsgId_t   MsgId;
    CFE_MSG_Size_t   MsgLen;
+   PKTTBL_Pkt_t     *PktPtr;
    OS_SockAddr_t    SocketAddr;
    CFE_SB_Buffer_t  *SbBufPtr;
+   PKTMGR_PktStats_t  *Stats;
+   CFE_TIME_SysTime_t StartTime = CFE_TIME_GetTime();
 
 
+   if (PktMgr->HoldOutput)
+   {
+      PktMgr->OutputPktsRead = 0;
+      ComputeStats(PktMgr, 0, 0);
+      return 0;
+   }
+   
+   if (PktMgr->FeedbackEna) ProcessFeedback(PktMgr);
+   
+   RateLimit = OutputRateLimit(PktMgr);
+   RefillRateTokens(PktMgr, RateLimit);
+   RateLimited = ((RateLimit > 0) && (PktMgr->RateTokens <= 0));
+   
+   if (PktMgr->WorkerCnt > 0)
+   {
+      return RunWorkers(PktMgr, RateLimit, RateLimited);
+   }
+   
+   if (PktMgr->PipelineEna)
+   {
+      if (__atomic_load_n(&PktMgr->Priv.Pipeline.PackExited, __ATOMIC_SEQ_CST) ||
+          __atomic_load_n(&PktMgr->Priv.Pipeline.SendExited, __ATOMIC_SEQ_CST))
+      {
+         StopPipeline(PktMgr, "a stage task terminated");
+      }
+      else
+      {
+         return RunPipeline(PktMgr, RateLimit, RateLimited);
+      }
+   }
+   
    OS_SocketAddrInit(&SocketAddr, OS_SocketDomain_INET);
    OS_SocketAddrFromString(&SocketAddr, PktMgr->TlmDestIp);
    OS_SocketAddrSetPort(&SocketAddr, PktMgr->TlmUdpPort);
-    
+   
+   /*
+   ** Previously queued datagrams are sent first to preserve packet order
+   */
+   if (PktMgr->DownlinkOn && (PktMgr->SuppressSend == false) && (PktMgr->RetryQueueCnt > 0) && !RateLimited)
+   {
+      RetryQueueSend(PktMgr, &SocketAddr, &NumPktsOutput, &NumBytesOutput);
+   }
+   
+   /*
+   ** A snapshot's cached values and a recorder dump are sent ahead of new
+   ** packets and use the same rate limit tokens. Only a channel with a
+   ** recorder serves it.
+   */
+   if (PktMgr->SnapshotActive && PktMgr->DownlinkOn && (PktMgr->SuppressSend == false) && !RateLimited)
+   {
+      SnapshotSend(PktMgr, &SocketAddr, &NumPktsOutput, &NumBytesOutput);
+      RateLimited = ((RateLimit > 0) && ((int32)NumBytesOutput >= PktMgr->RateTokens));
+   }
+   
+   if ((PktMgr->TlmRec != NULL) && PktMgr->DownlinkOn && (PktMgr->SuppressSend == false) && !RateLimited)
+   {
+      RecorderSend(PktMgr, &SocketAddr, &NumPktsOutput, &NumBytesOutput);
+      RateLimited = ((RateLimit > 0) && ((int32)NumBytesOutput >= PktMgr->RateTokens));
+   }
+   
    /*
    ** CFE_SB_RcvMsg returns CFE_SUCCESS when it gets a packet, otherwise
-   ** no packet was received
+   ** no packet was received. The loop also terminates when the output
+   ** budget or rate limit is reached or the retry queue is full and the
+   ** remaining packets are sent in a later cycle. A full retry queue is
+   ** socket backpressure so it isn't counted as an output bound cycle.
    */
-   do
+   SbStatus = CFE_SUCCESS;
+   while ((SbStatus == CFE_SUCCESS) && !BudgetReached && !RateLimited)
    {
+      
+      if (PktMgr->RetryQueueCnt >= PKTMGR_RETRY_QUEUE_LEN) break;
+
 
       SbStatus = CFE_SB_ReceiveBuffer(&SbBufPtr, PktMgr->TlmPipe, CFE_SB_POLL);
  
+      /* 
+      ** Input rates are observed before filtering for table planning. 
+      ** Packets no longer in the table or the active profile, e.g. queued
+      ** before a remove or profile switch, are dropped. Stale packets are
+      ** dropped before any packing cost is paid. The recorder keeps every
+      ** other subscribed packet before it's filtered and the packed image
+      ** is reused if the packet is sent.
+      */
+      if (SbStatus == CFE_SUCCESS)
+      {
+         CFE_MSG_GetSize(&SbBufPtr->Msg, &MsgLen);
+         CFE_MSG_GetMsgId(&SbBufPtr->Msg, &MsgId);
+         
+         PktPtr = PKTTBL_GetPkt(&(PktMgr->PktTbl.Data), CFE_SB_MsgIdToValue(MsgId));
+         if (PktPtr != NULL)
+         {
+            Stats = GetPktStats(PktMgr, PktPtr);
+            Stats->Pkts++;
+            Stats->Bytes += MsgLen;
+            if (!PKTTBL_IN_PROFILE(PktPtr, PktMgr->ActiveProfile))
+            {
+               PktPtr = NULL;
+            }
+            else if ((PktPtr->MaxAge > 0) && PktExpired(&SbBufPtr->Msg, PktPtr->MaxAge, StartTime))
+            {
+               Stats->StaleDrops++;
+               PktMgr->StaleDropCnt++;
+               PktPtr = NULL;
+            }
+         }
+         
+         Packed = false;
+         if ((PktPtr != NULL) && (PktMgr->TlmRec != NULL) && TLM_REC_Recording(PktMgr->TlmRec))
+         {
+            PackStatus = PackEdsOutputMessage(PktMgr->Priv.SocketBuffer, &SbBufPtr->Msg, sizeof(PktMgr->Priv.SocketBuffer), &EdsDataSize);
+            Packed = true;
+            if (PackStatus == CFE_SUCCESS)
+            {
+               TLM_REC_Write(PktMgr->TlmRec, PktMgr->Priv.SocketBuffer, EdsDataSize, MsgLen, StartTime.Seconds);
+            }
+         }
+      }
+      
       if ( (SbStatus == CFE_SUCCESS) && (PktMgr->SuppressSend == false) )
       {
           
          if(PktMgr->DownlinkOn)
          {
             
-            CFE_MSG_GetSize(&SbBufPtr->Msg, &MsgLen);
-            CFE_MSG_GetApId(&SbBufPtr->Msg, &AppId);
-            AppId = AppId & PKTTBL_APP_ID_MASK;            
-            if (!PktUtil_IsPacketFiltered(&SbBufPtr->Msg, &(PktMgr->PktTbl.Data.Pkt[AppId].Filter)))
+            if ((PktPtr != NULL) && !PktUtil_IsPacketFiltered(&SbBufPtr->Msg, &(PktPtr->Filter)))
             {
             
-               SbStatus = PackEdsOutputMessage(SocketBuffer, &SbBufPtr->Msg, SocketBufferLen, &EdsDataSize);
-               
-               if (SbStatus == CFE_SUCCESS)
+               if (!PktPtr->Coalesce || !CoalescePkt(PktMgr, &SbBufPtr->Msg, PktPtr, MsgLen))
                {
-                  SocketStatus = OS_SocketSendTo(PktMgr->TlmSockId, SocketBuffer, EdsDataSize, &SocketAddr);
-          
-                  ++NumPktsOutput;
-                  NumBytesOutput += MsgLen;
-               }
+                  
+                  if (!Packed)
+                  {
+                     PackStatus = PackEdsOutputMessage(PktMgr->Priv.SocketBuffer, &SbBufPtr->Msg, sizeof(PktMgr->Priv.SocketBuffer), &EdsDataSize);
+                  }
+                  
+                  if (PackStatus == CFE_SUCCESS)
+                  {
+                     
+                     LvcStore(PktMgr, PktPtr, PktMgr->Priv.SocketBuffer, EdsDataSize, MsgLen);
+                     
+                     if (PktMgr->ReorderWindow > 0)
+                     {
+                        ReorderAdd(PktMgr, PktMgr->Priv.SocketBuffer, EdsDataSize, MsgLen, &SbBufPtr->Msg, &SocketAddr,
+                                   &NumPktsOutput, &NumBytesOutput);
+                     }
+                     else
+                     {
+                        SendOrQueueDatagram(PktMgr, PktMgr->Priv.SocketBuffer, EdsDataSize, MsgLen, &SocketAddr,
+                                            &NumPktsOutput, &NumBytesOutput);
+                     }
+                  }
                
+               } /* End if packet is not coalesced */
             } /* End if packet is not filtered */
          } /* End if downlink enabled */
-         else
-         {
-            SocketStatus = 0;
-         } 
          
-         if (SocketStatus < 0)
-         {
-             
-            CFE_EVS_SendEvent(PKTMGR_SOCKET_SEND_ERR_EID,CFE_EVS_EventType_ERROR,
-                              "Error sending packet on socket %s, port %d, status %d. Tlm output suppressed\n",
-                              PktMgr->TlmDestIp, PktMgr->TlmUdpPort, SocketStatus);
-            PktMgr->SuppressSend = true;
-         }
-
       } /* End if SB received msg and output enabled */
 
-   } while(SbStatus == CFE_SUCCESS);
+      if (SbStatus == CFE_SUCCESS)
+      {
+         ++NumPktsRead;
+         BudgetReached = OutputBudgetReached(PktMgr, NumPktsRead, StartTime);
+         RateLimited   = ((RateLimit > 0) && ((int32)NumBytesOutput >= PktMgr->RateTokens));
+      }
+      
+   } /* End while pipe not empty */
 
-   ComputeStats(NumPktsOutput, NumBytesOutput);
+   if (PktMgr->Priv.CoalesceSlotCnt > 0)
+   {
+      CoalesceSend(PktMgr, &SocketAddr, &NumPktsOutput, &NumBytesOutput);
+   }
+   
+   /*
+   ** Held packets that are due wait for the next cycle when the rate limit
+   ** has been reached
+   */
+   if ((PktMgr->ReorderCnt > 0) && PktMgr->DownlinkOn && !RateLimited)
+   {
+      ReorderRelease(PktMgr, &SocketAddr, &NumPktsOutput, &NumBytesOutput);
+   }
+   
+   if (BudgetReached) ++PktMgr->OutputBoundCycles;
+   if (RateLimited)   ++PktMgr->RateLimitCycles;
+   if (RateLimit > 0) PktMgr->RateTokens -= (int32)NumBytesOutput;
+   PktMgr->OutputPktsRead = NumPktsRead;
+   
+   ComputeStats(PktMgr, NumPktsOutput, NumBytesOutput);
 
    return NumPktsOutput;
    
 } /* End of PKTMGR_OutputTelemetry() */
 
 
+/******************************************************************************
+** Function: PKTMGR_PlanTblCmd
+**
+*/
+bool PKTMGR_PlanTblCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   PKTMGR_Class_t *PktMgr = (PKTMGR_Class_t *)ObjDataPtr;
+   const PKTMGR_PlanTblCmdMsg_t *PlanTblCmd = (const PKTMGR_PlanTblCmdMsg_t *) MsgPtr;
+   char Filename[OS_MAX_PATH_LEN];
+   
+   strncpy(Filename, PlanTblCmd->Filename, OS_MAX_PATH_LEN);
+   Filename[OS_MAX_PATH_LEN-1] = '\0';
+   
+   return PKTTBL_PlanCmd(&PktMgr->PktTbl, Filename);
+
+} /* End PKTMGR_PlanTblCmd() */
+
+
 /******************************************************************************
 ** Function: PKTMGR_RemoveAllPktsCmd
 **
@@ -334,42 +903,46 @@ uint16 PKTMGR_OutputTelemetry(void)
 bool PKTMGR_RemoveAllPktsCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
 
-   uint16   AppId;
+   PKTMGR_Class_t *PktMgr = (PKTMGR_Class_t *)ObjDataPtr;
+   uint16   Slot;
+   uint16   MsgId;
+   bool     Subscribed;
    uint16   PktCnt = 0;
    uint16   FailedUnsubscribe = 0;
    int32    Status;
    bool     RetStatus = true;
 
-   for (AppId=0; AppId < PKTUTIL_MAX_APP_ID; AppId++)
+   /* Remove from the end of the active index so no index entries are moved */
+   while (PktMgr->PktTbl.Data.ActiveCnt > 0)
    {
       
-      if (PktMgr->PktTbl.Data.Pkt[AppId].MsgId != PKTTBL_UNUSED_MSG_ID)
+      Slot  = PktMgr->PktTbl.Data.ActiveIdx[PktMgr->PktTbl.Data.ActiveCnt-1];
+      MsgId = PktMgr->PktTbl.Data.Pkt[Slot].MsgId;
+      Subscribed = PKTTBL_IN_PROFILE(&(PktMgr->PktTbl.Data.Pkt[Slot]), PktMgr->ActiveProfile);
+      ++PktCnt;
+
+      Status = Subscribed ? CFE_SB_Unsubscribe(CFE_SB_ValueToMsgId(MsgId), PktPipe(PktMgr, MsgId)) : CFE_SUCCESS;
+      if(Status != CFE_SUCCESS)
       {
           
-         ++PktCnt;
-
-         Status = CFE_SB_Unsubscribe(CFE_SB_ValueToMsgId(PktMgr->PktTbl.Data.Pkt[AppId].MsgId), PktMgr->TlmPipe);
-         if(Status != CFE_SUCCESS)
-         {
-             
-            FailedUnsubscribe++;
-            CFE_EVS_SendEvent(PKTMGR_REMOVE_ALL_PKTS_ERROR_EID, CFE_EVS_EventType_ERROR,
-                              "Error removing message ID 0x%04X at table packet index %d. Unsubscribe status 0x%8X",
-                              PktMgr->PktTbl.Data.Pkt[AppId].MsgId, AppId, Status);
-         }
-
-         PKTTBL_SetPacketToUnused(&(PktMgr->PktTbl.Data.Pkt[AppId]));
+         FailedUnsubscribe++;
+         CFE_EVS_SendEvent(PKTMGR_REMOVE_ALL_PKTS_ERROR_EID, CFE_EVS_EventType_ERROR,
+                           "Error removing message ID 0x%04X at table packet index %d. Unsubscribe status 0x%8X",
+                           MsgId, Slot, Status);
+      }
 
-      } /* End if packet in use */
+      PKTTBL_RemovePkt(&(PktMgr->PktTbl.Data), MsgId);
 
-   } /* End AppId loop */
+   } /* End active packet loop */
 
    CFE_EVS_SendEvent(KIT_TO_INIT_DEBUG_EID, KIT_TO_INIT_EVS_TYPE, 
                      "PKTMGR_RemoveAllPktsCmd() - About to flush pipe\n");
-   FlushTlmPipe();
+   FlushTlmPipe(PktMgr);
    CFE_EVS_SendEvent(KIT_TO_INIT_DEBUG_EID, KIT_TO_INIT_EVS_TYPE, 
                      "PKTMGR_RemoveAllPktsCmd() - Completed pipe flush\n");
 
+   SaveCdsImage(PktMgr);
+
    if (FailedUnsubscribe == 0)
    {
       
@@ -397,20 +970,24 @@ bool PKTMGR_RemoveAllPktsCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 bool PKTMGR_RemovePktCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
 
+   PKTMGR_Class_t *PktMgr = (PKTMGR_Class_t *)ObjDataPtr;
    const PKTMGR_RemovePktCmdMsg_t *RemovePktCmd = (const PKTMGR_RemovePktCmdMsg_t *) MsgPtr;
-   uint16  AppId;
+   PKTTBL_Pkt_t *PktPtr;
+   bool    Subscribed;
    int32   Status;
    bool    RetStatus = true;
   
    
-   AppId = RemovePktCmd->MsgId & PKTTBL_APP_ID_MASK;
-  
-   if (PktMgr->PktTbl.Data.Pkt[AppId].MsgId != PKTTBL_UNUSED_MSG_ID)
+   PktPtr = PKTTBL_GetPkt(&(PktMgr->PktTbl.Data), RemovePktCmd->MsgId);
+   
+   if (PktPtr != NULL)
    {
-
-      PKTTBL_SetPacketToUnused(&(PktMgr->PktTbl.Data.Pkt[AppId]));
       
-      Status = CFE_SB_Unsubscribe(CFE_SB_ValueToMsgId(RemovePktCmd->MsgId), PktMgr->TlmPipe);
+      Subscribed = PKTTBL_IN_PROFILE(PktPtr, PktMgr->ActiveProfile);
+      PKTTBL_RemovePkt(&(PktMgr->PktTbl.Data), RemovePktCmd->MsgId);
+      SaveCdsImage(PktMgr);
+      
+      Status = Subscribed ? CFE_SB_Unsubscribe(CFE_SB_ValueToMsgId(RemovePktCmd->MsgId), PktPipe(PktMgr, RemovePktCmd->MsgId)) : CFE_SUCCESS;
       if(Status == CFE_SUCCESS)
       {
          CFE_EVS_SendEvent(PKTMGR_REMOVE_PKT_SUCCESS_EID, CFE_EVS_EventType_INFORMATION,
@@ -444,13 +1021,173 @@ bool PKTMGR_RemovePktCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 ** Function:  PKTMGR_ResetStatus
 **
 */
-void PKTMGR_ResetStatus(void)
+void PKTMGR_ResetStatus(PKTMGR_Class_t *PktMgr)
 {
 
-   PKTMGR_InitStats(0,INITBL_GetIntConfig(PktMgr->IniTbl, CFG_PKTMGR_STATS_CONFIG_DELAY));
-
-} /* End PKTMGR_ResetStatus() */
-
+   uint16 i;
+
+   PktMgr->OutputBoundCycles   = 0;
+   PktMgr->RateLimitCycles     = 0;
+   PktMgr->FeedbackLimitCycles = 0;
+   PktMgr->FeedbackLossSum     = 0;
+   PktMgr->FeedbackRptCnt      = 0;
+   PktMgr->FeedbackTimeoutCnt  = 0;
+   PktMgr->RetryDropCnt        = 0;
+   PktMgr->SendTransientErrCnt = 0;
+   PktMgr->StaleDropCnt        = 0;
+   PktMgr->SupersededCnt       = 0;
+   PktMgr->CoalesceFullCnt     = 0;
+   PktMgr->LvcFullCnt          = 0;
+   PktMgr->ReorderLateCnt      = 0;
+   PktMgr->ReorderFullCnt      = 0;
+   
+   for (i=0; i < PktMgr->WorkerCnt; i++)
+   {
+      PktMgr->Worker[i].PktCnt = 0;
+   }
+   
+   PktMgr->PipeRcvStallCnt   = 0;
+   PktMgr->PipePackStarveCnt = 0;
+   PktMgr->PipePackStallCnt  = 0;
+   PktMgr->PipeSendStarveCnt = 0;
+   PktMgr->PipeInlineCnt     = 0;
+   PktMgr->PipePackErrCnt    = 0;
+   PktMgr->PipeDropCnt       = 0;
+   __atomic_store_n(&PktMgr->Priv.Pipeline.MsgRing.Peak, 0, __ATOMIC_RELAXED);
+   __atomic_store_n(&PktMgr->Priv.Pipeline.DatagramRing.Peak, 0, __ATOMIC_RELAXED);
+   
+   CFE_PSP_MemSet(PktMgr->Priv.PktStats, 0, sizeof(PktMgr->Priv.PktStats));
+   PktMgr->PktStatsStart = CFE_TIME_GetTime();
+   
+   PKTMGR_InitStats(PktMgr, 0,INITBL_GetIntConfig(PktMgr->IniTbl, CFG_PKTMGR_STATS_CONFIG_DELAY));
+
+} /* End PKTMGR_ResetStatus() */
+
+
+/******************************************************************************
+** Function:  PKTMGR_RestoreFromCds
+**
+** Notes:
+**   1. Entries are subscribed directly rather than through LoadPktTbl()
+**      because the table is known to be empty.
+**   2. The image is rewritten after the restore so it reflects any entries
+**      that failed to subscribe.
+**   3. Only entries in the saved active profile are subscribed.
+**   4. Child task output doesn't coalesce so a saved coalesce setting is
+**      cleared when output is performed by child tasks.
+*/
+bool PKTMGR_RestoreFromCds(PKTMGR_Class_t *PktMgr)
+{
+
+   bool          RetStatus = false;
+   uint32        ResetType;
+   int32         Status;
+   uint16        Crc;
+   uint16        i;
+   uint16        FailedSubscription = 0;
+   uint16        CoalesceCleared = 0;
+   PKTTBL_Pkt_t  Pkt;
+   
+   
+   CFE_ES_GetResetType(&ResetType);
+   
+   if (!PktMgr->CdsExisted || (ResetType != CFE_PSP_RST_TYPE_PROCESSOR)) return false;
+
+   Status = CFE_ES_RestoreFromCDS(&PktMgr->Priv.CdsImage, PktMgr->CdsHandle);
+   
+   if (Status != CFE_SUCCESS)
+   {
+      CFE_EVS_SendEvent(PKTMGR_CDS_RESTORE_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "CDS restore failed with status 0x%08X. Loading the default table file",
+                        (unsigned int)Status);
+   }
+   else if ((PktMgr->Priv.CdsImage.Version != PKTMGR_CDS_VERSION) || (PktMgr->Priv.CdsImage.PktCnt > PKTTBL_MAX_SLOTS) ||
+            (PktMgr->Priv.CdsImage.ProfileCnt > PKTTBL_PROFILE_MAX) || 
+            (PktMgr->Priv.CdsImage.ActiveProfile >= (PktMgr->Priv.CdsImage.ProfileCnt > 0 ? PktMgr->Priv.CdsImage.ProfileCnt : 1)))
+   {
+      CFE_EVS_SendEvent(PKTMGR_CDS_RESTORE_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "CDS image version %d with %d packets and %d profiles is invalid. Loading the default table file",
+                        PktMgr->Priv.CdsImage.Version, PktMgr->Priv.CdsImage.PktCnt, PktMgr->Priv.CdsImage.ProfileCnt);
+   }
+   else
+   {
+      
+      Crc = PktMgr->Priv.CdsImage.Crc;
+      PktMgr->Priv.CdsImage.Crc = 0;
+      PktMgr->Priv.CdsImage.Crc = CFE_ES_CalculateCRC(&PktMgr->Priv.CdsImage, offsetof(PKTMGR_CdsImage_t, Pkt) + PktMgr->Priv.CdsImage.PktCnt*sizeof(PKTTBL_BinPkt_t), 
+                                         0, CFE_MISSION_ES_DEFAULT_CRC);
+      
+      if (Crc == PktMgr->Priv.CdsImage.Crc)
+      {
+         
+         RetStatus = true;
+         
+         PktMgr->PktTbl.Data.ProfileCnt = PktMgr->Priv.CdsImage.ProfileCnt;
+         memcpy(PktMgr->PktTbl.Data.ProfileName, PktMgr->Priv.CdsImage.ProfileName, sizeof(PktMgr->Priv.CdsImage.ProfileName));
+         PktMgr->ActiveProfile = PktMgr->Priv.CdsImage.ActiveProfile;
+         
+         for (i=0; i < PktMgr->Priv.CdsImage.PktCnt; i++)
+         {
+            
+            PKTTBL_UnpackBinPkt(&Pkt, &PktMgr->Priv.CdsImage.Pkt[i]);
+            if (Pkt.Coalesce && ((PktMgr->WorkerCnt > 0) || PktMgr->PipelineEna))
+            {
+               Pkt.Coalesce = false;
+               ++CoalesceCleared;
+            }
+            
+            Status = PKTTBL_IN_PROFILE(&Pkt, PktMgr->ActiveProfile) ? SubscribeNewPkt(PktMgr, &Pkt) : CFE_SUCCESS;
+            if ((Status == CFE_SUCCESS) && PKTTBL_SetPkt(&(PktMgr->PktTbl.Data), &Pkt))
+            {
+               continue;
+            }
+            
+            ++FailedSubscription;
+            CFE_EVS_SendEvent(PKTMGR_LOAD_TBL_SUBSCRIBE_ERR_EID,CFE_EVS_EventType_ERROR,
+                              "Error restoring message ID 0x%04X, BufLim %d, Status %i",
+                              Pkt.MsgId, Pkt.BufLim, Status);
+         
+         } /* End entry loop */
+
+         PktMgr->PktTbl.Loaded = true;
+         
+         if (CoalesceCleared > 0)
+         {
+            CFE_EVS_SendEvent(PKTMGR_CDS_RESTORE_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "Restored %d coalescing entries without coalescing. Channel %d output is performed by child tasks",
+                              CoalesceCleared, PktMgr->Channel);
+         }
+         
+         if (PktMgr->Priv.CdsImage.DownlinkOn)
+         {
+            strncpy(PktMgr->TlmDestIp, PktMgr->Priv.CdsImage.TlmDestIp, PKTMGR_IP_STR_LEN);
+            PktMgr->TlmDestIp[PKTMGR_IP_STR_LEN-1] = '\0';
+            EnableOutput(PktMgr);
+            PktMgr->SuppressSend = PktMgr->Priv.CdsImage.SuppressSend;
+         }
+         
+         SaveCdsImage(PktMgr);
+         
+         CFE_EVS_SendEvent(PKTMGR_CDS_RESTORE_EID, CFE_EVS_EventType_INFORMATION,
+                           "Restored %d of %d packets from CDS, failed %d subscriptions. Profile %s, output %s",
+                           PktMgr->PktTbl.Data.ActiveCnt, PktMgr->Priv.CdsImage.PktCnt, FailedSubscription,
+                           ProfileNameStr(&(PktMgr->PktTbl.Data), PktMgr->ActiveProfile),
+                           ((PktMgr->DownlinkOn && !PktMgr->SuppressSend) ? PktMgr->TlmDestIp : "disabled"));
+
+      } /* End if valid CRC */
+      else
+      {
+         CFE_EVS_SendEvent(PKTMGR_CDS_RESTORE_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "CDS image CRC 0x%04X doesn't match computed CRC 0x%04X. Loading the default table file",
+                           Crc, PktMgr->Priv.CdsImage.Crc);
+      }
+   
+   } /* End if valid image */
+   
+   return RetStatus;
+
+} /* End PKTMGR_RestoreFromCds() */
+
 
 /*******************************************************************
 ** Function: PKTMGR_SendPktTblTlmCmd
@@ -460,14 +1197,20 @@ void PKTMGR_ResetStatus(void)
 bool PKTMGR_SendPktTblTlmCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
 
+   PKTMGR_Class_t *PktMgr = (PKTMGR_Class_t *)ObjDataPtr;
    const PKTMGR_SendPktTblTlmCmdMsg_t *SendPktTblTlmCmd = (const PKTMGR_SendPktTblTlmCmdMsg_t *) MsgPtr;
-   uint16        AppId;
+   const PKTMGR_PktStats_t *Stats;
+   PKTTBL_Pkt_t  UnusedPkt;
    PKTTBL_Pkt_t* PktPtr;
    int32         Status;
   
   
-   AppId  = SendPktTblTlmCmd->MsgId & PKTTBL_APP_ID_MASK;
-   PktPtr = &(PktMgr->PktTbl.Data.Pkt[AppId]);
+   PktPtr = PKTTBL_GetPkt(&(PktMgr->PktTbl.Data), SendPktTblTlmCmd->MsgId);
+   if (PktPtr == NULL)
+   {
+      PKTTBL_SetPacketToUnused(&UnusedPkt);
+      PktPtr = &UnusedPkt;
+   }
    
    PktMgr->PktTlm.MsgId  = PktPtr->MsgId;
    PktMgr->PktTlm.Qos    = PktPtr->Qos;
@@ -476,6 +1219,12 @@ bool PKTMGR_SendPktTblTlmCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
    PktMgr->PktTlm.FilterType  = PktPtr->Filter.Type;
    PktMgr->PktTlm.FilterParam = PktPtr->Filter.Param;
 
+   PktMgr->PktTlm.MaxAge        = PktPtr->MaxAge;
+   PktMgr->PktTlm.Coalesce      = PktPtr->Coalesce;
+   Stats = FindPktStats(PktMgr, SendPktTblTlmCmd->MsgId);
+   PktMgr->PktTlm.StaleDropCnt  = (Stats == NULL) ? 0 : Stats->StaleDrops;
+   PktMgr->PktTlm.SupersededCnt = (Stats == NULL) ? 0 : Stats->Superseded;
+
    CFE_SB_TimeStampMsg(CFE_MSG_PTR(PktMgr->PktTlm));
    Status = CFE_SB_TransmitMsg(CFE_MSG_PTR(PktMgr->PktTlm), true);
     
@@ -484,31 +1233,167 @@ bool PKTMGR_SendPktTblTlmCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 } /* End of PKTMGR_SendPktTblTlmCmd() */
 
 
+/******************************************************************************
+** Function: PKTMGR_SetRateLimit
+**
+** The bucket starts full so a new limit takes effect without a startup delay.
+*/
+void PKTMGR_SetRateLimit(PKTMGR_Class_t *PktMgr, uint32 BytesPerSec)
+{
+
+   PktMgr->RateLimit      = BytesPerSec;
+   PktMgr->RateTokens     = (int32)BytesPerSec;
+   PktMgr->RateRefillTime = CFE_TIME_GetTime();
+
+} /* End PKTMGR_SetRateLimit() */
+
+
+/******************************************************************************
+** Function: PKTMGR_SnapshotCmd
+**
+*/
+bool PKTMGR_SnapshotCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   PKTMGR_Class_t *PktMgr = (PKTMGR_Class_t *)ObjDataPtr;
+   
+   if ((PktMgr->WorkerCnt > 0) || PktMgr->PipelineEna)
+   {
+      CFE_EVS_SendEvent(PKTMGR_WORKER_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Snapshot rejected. Output workers and the output pipeline don't maintain the last value cache");
+      return false;
+   }
+   
+   StartSnapshot(PktMgr);
+   
+   return true;
+
+} /* End PKTMGR_SnapshotCmd() */
+
+
+/******************************************************************************
+** Function: PKTMGR_SwitchProfile
+**
+** Notes:
+**   1. The subscription changes are derived from each entry's profile mask in
+**      a single pass over the active entries. No file is read and the pipe
+**      isn't flushed. Packets already queued for unsubscribed entries are
+**      dropped by PKTMGR_OutputTelemetry().
+**   2. An entry whose subscription fails stays in the profile and is 
+**      reported in an error event.
+*/
+bool PKTMGR_SwitchProfile(PKTMGR_Class_t *PktMgr, const char *Name)
+{
+
+   PKTTBL_Data_t *Tbl = &(PktMgr->PktTbl.Data);
+   PKTTBL_Pkt_t  *Pkt;
+   uint16  i;
+   uint16  PrevProfile = PktMgr->ActiveProfile;
+   uint16  NewProfile;
+   uint16  SubscribeCnt   = 0;
+   uint16  UnsubscribeCnt = 0;
+   uint16  FailedCnt      = 0;
+   bool    CurSub;
+   bool    NewSub;
+   int32   Status;
+
+   
+   NewProfile = PKTTBL_GetProfile(Tbl, Name);
+   if (NewProfile >= PKTTBL_PROFILE_MAX)
+   {
+      CFE_EVS_SendEvent(PKTMGR_SWITCH_PROFILE_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Switch profile rejected. Profile '%s' is not defined in the packet table", Name);
+      return false;
+   }
+   
+   for (i=0; i < Tbl->ActiveCnt; i++)
+   {
+      
+      Pkt    = &(Tbl->Pkt[Tbl->ActiveIdx[i]]);
+      CurSub = PKTTBL_IN_PROFILE(Pkt, PrevProfile);
+      NewSub = PKTTBL_IN_PROFILE(Pkt, NewProfile);
+      
+      if (CurSub == NewSub) continue;
+      
+      if (NewSub)
+      {
+         Status = SubscribeNewPkt(PktMgr, Pkt);
+         if (Status == CFE_SUCCESS) ++SubscribeCnt;
+      }
+      else
+      {
+         Status = CFE_SB_Unsubscribe(CFE_SB_ValueToMsgId(Pkt->MsgId), PktPipe(PktMgr, Pkt->MsgId));
+         if (Status == CFE_SUCCESS) ++UnsubscribeCnt;
+      }
+      
+      if (Status != CFE_SUCCESS)
+      {
+         ++FailedCnt;
+         CFE_EVS_SendEvent(PKTMGR_SWITCH_PROFILE_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Error %s message ID 0x%04X for profile %s, Status 0x%08X",
+                           (NewSub ? "subscribing to" : "unsubscribing from"), Pkt->MsgId, Name, (unsigned int)Status);
+      }
+      
+   } /* End active packet loop */
+   
+   PktMgr->ActiveProfile = NewProfile;
+   SaveCdsImage(PktMgr);
+   
+   CFE_EVS_SendEvent(PKTMGR_SWITCH_PROFILE_EID, 
+                     (FailedCnt == 0 ? CFE_EVS_EventType_INFORMATION : CFE_EVS_EventType_ERROR),
+                     "Switched from profile %s to %s: %d subscribed, %d unsubscribed, %d failed",
+                     ProfileNameStr(Tbl, PrevProfile), Name, SubscribeCnt, UnsubscribeCnt, FailedCnt);
+   
+   return (FailedCnt == 0);
+
+} /* End PKTMGR_SwitchProfile() */
+
+
+/******************************************************************************
+** Function: PKTMGR_SwitchProfileCmd
+**
+*/
+bool PKTMGR_SwitchProfileCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   PKTMGR_Class_t *PktMgr = (PKTMGR_Class_t *)ObjDataPtr;
+   const PKTMGR_SwitchProfileCmdMsg_t *SwitchProfileCmd = (const PKTMGR_SwitchProfileCmdMsg_t *) MsgPtr;
+   char  Name[PKTTBL_PROFILE_NAME_LEN];
+
+   strncpy(Name, SwitchProfileCmd->Name, PKTTBL_PROFILE_NAME_LEN);
+   Name[PKTTBL_PROFILE_NAME_LEN-1] = '\0';
+   
+   return PKTMGR_SwitchProfile(PktMgr, Name);
+
+} /* End PKTMGR_SwitchProfileCmd() */
+
+
 /******************************************************************************
 ** Function: PKTMGR_UpdateFilterCmd
 **
 ** Notes:
-**   1. Command rejected if AppId packet entry has not been loaded 
+**   1. Command rejected if the message ID packet entry has not been loaded 
 **   2. The filter type is verified but the filter parameter values are not 
 ** 
 */
 bool PKTMGR_UpdateFilterCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
 
+   PKTMGR_Class_t *PktMgr = (PKTMGR_Class_t *)ObjDataPtr;
    const PKTMGR_UpdateFilterCmdMsg_t *UpdateFilterCmd = (const PKTMGR_UpdateFilterCmdMsg_t *) MsgPtr;
    bool    RetStatus = false;
-   uint16  AppId;
+   PKTTBL_Pkt_t *PktPtr;
 
    
-   AppId = UpdateFilterCmd->MsgId & PKTTBL_APP_ID_MASK;
+   PktPtr = PKTTBL_GetPkt(&(PktMgr->PktTbl.Data), UpdateFilterCmd->MsgId);
    
-   if (PktMgr->PktTbl.Data.Pkt[AppId].MsgId != PKTTBL_UNUSED_MSG_ID)
+   if (PktPtr != NULL)
    {
       
       if (PktUtil_IsFilterTypeValid(UpdateFilterCmd->FilterType))
       {
         
-         PktUtil_Filter_t *TblFilter = &(PktMgr->PktTbl.Data.Pkt[AppId].Filter);
+         PktUtil_Filter_t *TblFilter = &(PktPtr->Filter);
          
          CFE_EVS_SendEvent(PKTMGR_UPDATE_FILTER_CMD_SUCCESS_EID, CFE_EVS_EventType_INFORMATION,
                            "Successfully changed message ID 0x%04X's filter (Type,N,X,O) from (%d,%d,%d,%d) to (%d,%d,%d,%d)",
@@ -519,6 +1404,7 @@ bool PKTMGR_UpdateFilterCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
                            
          TblFilter->Type  = UpdateFilterCmd->FilterType;
          TblFilter->Param = UpdateFilterCmd->FilterParam;         
+         SaveCdsImage(PktMgr);
         
          RetStatus = true;
       
@@ -546,251 +1432,2903 @@ bool PKTMGR_UpdateFilterCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 
 
 /******************************************************************************
-** Function:  ComputeStats
+** Function: AppendFailedIdx
 **
-** Called each output telemetry cycle
+** Append an entry index to a bulk command's comma separated failed index 
+** list. The list ends with "..." when it doesn't fit in BULK_IDX_STR_LEN.
 */
-static void ComputeStats(uint16 PktsSent, uint32 BytesSent)
+static void AppendFailedIdx(char *IdxStr, uint16 Idx)
 {
 
-   uint32 DeltaTimeMicroSec;   
-   CFE_TIME_SysTime_t CurrTime = CFE_TIME_GetTime();
-   CFE_TIME_SysTime_t DeltaTime;
+   size_t Len = strlen(IdxStr);
+   char   NumStr[8];
    
-   if (PktMgr->Stats.InitCycles > 0)
-   {
+   if ((Len > 0) && (IdxStr[Len-1] == '.')) return;
    
-      --PktMgr->Stats.InitCycles;
-      PktMgr->Stats.PrevTime = CFE_TIME_GetTime();
-      PktMgr->Stats.State = PKTMGR_STATS_INIT_CYCLE;
-
+   snprintf(NumStr, sizeof(NumStr), (Len == 0 ? "%d" : ",%d"), Idx);
+   
+   if ((Len + strlen(NumStr) + 4) < BULK_IDX_STR_LEN)
+   {
+      strcat(IdxStr, NumStr);
    }
    else
    {
-      
-      DeltaTime = CFE_TIME_Subtract(CurrTime, PktMgr->Stats.PrevTime);
-      DeltaTimeMicroSec = CFE_TIME_Sub2MicroSecs(DeltaTime.Subseconds); 
-      
-      PktMgr->Stats.IntervalMilliSecs += (double)DeltaTime.Seconds*1000.0 + (double)DeltaTimeMicroSec/1000.0;
-      PktMgr->Stats.IntervalPkts      += PktsSent;
-      PktMgr->Stats.IntervalBytes     += BytesSent;
-
-      if (PktMgr->Stats.IntervalMilliSecs >= PktMgr->Stats.OutputTlmInterval)
-      {
-      
-         double Seconds = PktMgr->Stats.IntervalMilliSecs/1000;
-         
-         CFE_EVS_SendEvent(PKTMGR_DEBUG_EID, CFE_EVS_EventType_DEBUG,
-                           "IntervalSecs=%f, IntervalPkts=%d, IntervalBytes=%d\n",
-                           Seconds,PktMgr->Stats.IntervalPkts,PktMgr->Stats.IntervalBytes);
-        
-         PktMgr->Stats.AvgPktsPerSec  = (double)PktMgr->Stats.IntervalPkts/Seconds;
-         PktMgr->Stats.AvgBytesPerSec = (double)PktMgr->Stats.IntervalBytes/Seconds;
-         
-         /* Good enough running average that avoids overflow */
-         if (PktMgr->Stats.State == PKTMGR_STATS_INIT_CYCLE) {
-     
-            PktMgr->Stats.State = PKTMGR_STATS_INIT_INTERVAL;
-       
-         }
-         else
-         {
-            
-            PktMgr->Stats.State = PKTMGR_STATS_VALID;
-            PktMgr->Stats.AvgPktsPerSec  = (PktMgr->Stats.AvgPktsPerSec  + PktMgr->Stats.PrevIntervalAvgPkts) / 2.0; 
-            PktMgr->Stats.AvgBytesPerSec = (PktMgr->Stats.AvgBytesPerSec + PktMgr->Stats.PrevIntervalAvgBytes) / 2.0; 
-  
-         }
-         
-         PktMgr->Stats.PrevIntervalAvgPkts  = PktMgr->Stats.AvgPktsPerSec;
-         PktMgr->Stats.PrevIntervalAvgBytes = PktMgr->Stats.AvgBytesPerSec;
-         
-         PktMgr->Stats.IntervalMilliSecs = 0.0;
-         PktMgr->Stats.IntervalPkts      = 0;
-         PktMgr->Stats.IntervalBytes     = 0;
-      
-      } /* End if report cycle */
-      
-      PktMgr->Stats.PrevTime = CFE_TIME_GetTime();
-      
-   } /* End if not init cycle */
+      strcat(IdxStr, "...");
+   }
    
-
-} /* End ComputeStats() */
+} /* End AppendFailedIdx() */
 
 
 /******************************************************************************
-** Function: DestructorCallback
+** Function: BulkEntryCntValid
 **
-** This function is called when the app is killed. This should
-** never occur but if it does this will close the network socket.
 */
-static void DestructorCallback(void)
+static bool BulkEntryCntValid(const char *CmdName, uint16 EntryCnt)
 {
 
-   CFE_EVS_SendEvent(PKTMGR_DESTRUCTOR_INFO_EID, CFE_EVS_EventType_INFORMATION, 
-                     "Destructor callback -- Closing TO Network socket. Downlink on = %d\n",
-                     PktMgr->DownlinkOn);
+   bool RetStatus = ((EntryCnt > 0) && (EntryCnt <= PKTMGR_BULK_ENTRY_MAX));
    
-   if (PktMgr->DownlinkOn)
+   if (!RetStatus)
    {
-      
-      OS_close(PktMgr->TlmSockId);
-   
+      CFE_EVS_SendEvent(PKTMGR_BULK_CMD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Bulk %s command rejected. Entry count %d is not in range 1..%d",
+                        CmdName, EntryCnt, PKTMGR_BULK_ENTRY_MAX);
    }
-
-} /* End DestructorCallback() */
+   
+   return RetStatus;
+   
+} /* End BulkEntryCntValid() */
 
 
 /******************************************************************************
-** Function: FlushTlmPipe
+** Function: ChildOutputConflict
 **
-** Remove all of the packets from the input pipe.
+** Return true and send an event naming the conflicting setting if a
+** configured feature requires output by the app task. OutputStr names the
+** child task output mode that won't be used.
 **
+** Notes:
+**   1. Child task output only filters, packs and sends. Time ordered output,
+**      the recorder and the last value cache used by the snapshot on enable
+**      are only performed by PKTMGR_OutputTelemetry().
 */
-static void FlushTlmPipe(void)
+static bool ChildOutputConflict(PKTMGR_Class_t *PktMgr, uint16 EventId, const char *OutputStr)
 {
 
-   int32 SbStatus;
-   CFE_SB_Buffer_t  *SbBufPtr;
-
-   do
+   const char *Setting = NULL;
+   
+   if (PktMgr->ReorderWindow > 0)
    {
-      SbStatus = CFE_SB_ReceiveBuffer(&SbBufPtr, PktMgr->TlmPipe, CFE_SB_POLL);
+      Setting = "PKTMGR_REORDER_WINDOW";
+   }
+   else if ((PktMgr->TlmRec != NULL) && (INITBL_GetIntConfig(PktMgr->IniTbl, CFG_TLM_REC_WINDOW) > 0))
+   {
+      Setting = "TLM_REC_WINDOW";
+   }
+   else if (PktMgr->SnapshotOnEnable)
+   {
+      Setting = "PKTMGR_SNAPSHOT_ON_ENABLE";
+   }
+   
+   if (Setting != NULL)
+   {
+      CFE_EVS_SendEvent(EventId, CFE_EVS_EventType_ERROR,
+                        "Channel %d %s not used because %s requires output by the app task",
+                        PktMgr->Channel, OutputStr, Setting);
+   }
+   
+   return (Setting != NULL);
+   
+} /* End ChildOutputConflict() */
 
-   } while(SbStatus == CFE_SUCCESS);
 
-} /* End FlushTlmPipe() */
+/******************************************************************************
+** Function: CoalesceEntryCnt
+**
+** Return the number of table entries that are coalesced.
+*/
+static uint16 CoalesceEntryCnt(const PKTTBL_Data_t *Tbl)
+{
+
+   uint16 i;
+   uint16 Cnt = 0;
    
+   for (i=0; i < Tbl->ActiveCnt; i++)
+   {
+      if (Tbl->Pkt[Tbl->ActiveIdx[i]].Coalesce) ++Cnt;
+   }
+   
+   return Cnt;
+   
+} /* End CoalesceEntryCnt() */
+
 
 /******************************************************************************
-** Function: LoadPktTbl
+** Function: CoalescePkt
+**
+** Hold a copy of a coalescing packet until the end of the output cycle,
+** replacing the previously held packet with the same message ID.
 **
 ** Notes:
-**   1. Function signature must match the PKTTBL_LoadNewTbl_t definition
-**   2. After the previous table's subscriptions are removed the new table is
-**      copied into the working table data structure. However there could still
-**      be subscription errors because of invalid table data so in a sense  
+**   1. Returns false if the packet wasn't held because it's too large or
+**      all slots are in use. The caller sends the packet normally.
+**   2. The SB buffer is only valid until the next receive so the packet is
+**      copied.
 */
-static bool LoadPktTbl(PKTTBL_Data_t* NewTbl)
+static bool CoalescePkt(PKTMGR_Class_t *PktMgr, const CFE_MSG_Message_t *MsgPtr, const PKTTBL_Pkt_t *PktPtr, CFE_MSG_Size_t MsgLen)
 {
 
-   uint16  AppId;
-   uint16  PktCnt = 0;
-   uint16  FailedSubscription = 0;
-   int32   Status;
-   bool    RetStatus = true;
+   uint16 i;
+   PKTMGR_CoalesceSlot_t *Slot = NULL;
 
-   CFE_MSG_Message_t *MsgPtr = NULL;
+   if (MsgLen > PKTMGR_COALESCE_MSG_MAX_LEN)
+   {
+      ++PktMgr->CoalesceFullCnt;
+      return false;
+   }
+   
+   for (i=0; i < PktMgr->Priv.CoalesceSlotCnt; i++)
+   {
+      if (PktMgr->Priv.CoalesceSlot[i].MsgId == PktPtr->MsgId)
+      {
+         Slot = &PktMgr->Priv.CoalesceSlot[i];
+         GetPktStats(PktMgr, PktPtr)->Superseded++;
+         PktMgr->SupersededCnt++;
+         break;
+      }
+   }
+   
+   if (Slot == NULL)
+   {
+      if (PktMgr->Priv.CoalesceSlotCnt >= PKTMGR_COALESCE_SLOTS)
+      {
+         ++PktMgr->CoalesceFullCnt;
+         return false;
+      }
+      Slot = &PktMgr->Priv.CoalesceSlot[PktMgr->Priv.CoalesceSlotCnt++];
+      Slot->MsgId = PktPtr->MsgId;
+   }
+   
+   Slot->MsgLen = MsgLen;
+   memcpy(Slot->Buf.Byte, MsgPtr, MsgLen);
+   
+   return true;
+   
+} /* End CoalescePkt() */
 
-   PKTMGR_RemoveAllPktsCmd(NULL, MsgPtr);  /* Both parameters are unused so OK to be NULL */
 
-   CFE_PSP_MemCpy(&(PktMgr->PktTbl), NewTbl, sizeof(PKTTBL_Data_t));
+/******************************************************************************
+** Function: CoalesceSend
+**
+** Send the packets held by CoalescePkt() and release all slots.
+**
+** Notes:
+**   1. Packets are sent in the order their message IDs were first read in
+**      the cycle unless they're time ordered. They're queued behind any
+**      datagrams waiting for a retry.
+*/
+static void CoalesceSend(PKTMGR_Class_t *PktMgr, const OS_SockAddr_t *SocketAddr, uint16 *PktsSent, uint32 *BytesSent)
+{
 
-   for (AppId=0; AppId < PKTUTIL_MAX_APP_ID; AppId++) {
+   uint16  i;
+   int32   PackStatus;
+   size_t  EdsDataSize;
+   const PKTTBL_Pkt_t *PktPtr;
+   
+   for (i=0; (i < PktMgr->Priv.CoalesceSlotCnt) && (PktMgr->SuppressSend == false); i++)
+   {
+      
+      PackStatus = PackEdsOutputMessage(PktMgr->Priv.SocketBuffer, &PktMgr->Priv.CoalesceSlot[i].Buf.Msg, sizeof(PktMgr->Priv.SocketBuffer), &EdsDataSize);
+      
+      if (PackStatus == CFE_SUCCESS)
+      {
+         PktPtr = PKTTBL_GetPkt(&(PktMgr->PktTbl.Data), PktMgr->Priv.CoalesceSlot[i].MsgId);
+         if (PktPtr != NULL)
+         {
+            LvcStore(PktMgr, PktPtr, PktMgr->Priv.SocketBuffer, EdsDataSize, PktMgr->Priv.CoalesceSlot[i].MsgLen);
+         }
+         
+         if (PktMgr->ReorderWindow > 0)
+         {
+            ReorderAdd(PktMgr, PktMgr->Priv.SocketBuffer, EdsDataSize, PktMgr->Priv.CoalesceSlot[i].MsgLen, &PktMgr->Priv.CoalesceSlot[i].Buf.Msg,
+                       SocketAddr, PktsSent, BytesSent);
+         }
+         else
+         {
+            SendOrQueueDatagram(PktMgr, PktMgr->Priv.SocketBuffer, EdsDataSize, PktMgr->Priv.CoalesceSlot[i].MsgLen, SocketAddr,
+                                PktsSent, BytesSent);
+         }
+      }
+   
+   } /* End slot loop */
+   
+   PktMgr->Priv.CoalesceSlotCnt = 0;
+   
+} /* End CoalesceSend() */
+
+
+/******************************************************************************
+** Function:  ComputePlan
+**
+** Predict the output of a table from the observed per-entry input rates and
+** store the result in the plan telemetry packet.
+**
+** Notes:
+**   1. Filters pass N of every X packets so the pass ratio is N/X. Time
+**      based filters use the same ratio which assumes a packet is produced
+**      once per time unit.
+**   2. An entry's recommended BufLim holds one output cycle of its packets
+**      plus one. The recommended pipe depth adds 50% margin to the peak.
+**   3. Only entries in the profile that would be active after a load of
+**      the table are included.
+**   4. Rates are looked up by full message ID in the current table so an
+**      entry that isn't loaded yet is unobserved.
+*/
+static void ComputePlan(PKTMGR_Class_t *PktMgr, const PKTTBL_Data_t *Tbl)
+{
+
+   uint16  i;
+   uint16  RecBufLim;
+   double  ObsSecs;
+   double  CycleSecs = PktMgr->Stats.OutputTlmInterval/1000.0;
+   double  PassRatio;
+   double  PktsPerSec;
+   double  InBytesPerSec  = 0.0;
+   double  OutBytesPerSec = 0.0;
+   double  OutPktsPerSec  = 0.0;
+   uint32  PeakBacklog    = 0;
+   uint16  Profile = (PktMgr->ActiveProfile < Tbl->ProfileCnt) ? PktMgr->ActiveProfile : 0;
+   
+   const PKTTBL_Pkt_t      *Pkt;
+   const PKTMGR_PktStats_t *Obs;
+   PKTMGR_PlanTlm_t        *Plan = &(PktMgr->PlanTlm);
+   
+   
+   ObsSecs = KIT_TO_ElapsedMilliSecs(PktMgr->PktStatsStart)/1000.0;
+   
+   Plan->PktCnt        = 0;
+   Plan->UnobservedCnt = 0;
+   Plan->BufLimLowCnt  = 0;
+   
+   for (i=0; i < Tbl->ActiveCnt; i++)
+   {
+      
+      Pkt = &(Tbl->Pkt[Tbl->ActiveIdx[i]]);
+      
+      if (!PKTTBL_IN_PROFILE(Pkt, Profile)) continue;
+      ++Plan->PktCnt;
+      
+      Obs = FindPktStats(PktMgr, Pkt->MsgId);
+      if ((Obs == NULL) || (Obs->Pkts == 0) || (ObsSecs <= 0.0))
+      {
+         ++Plan->UnobservedCnt;
+         continue;
+      }
+      
+      switch (Pkt->Filter.Type)
+      {
+         case PKTUTIL_FILTER_ALWAYS:
+            PassRatio = 0.0;
+            break;
+         case PKTUTIL_FILTER_BY_SEQ_CNT:
+         case PKTUTIL_FILTER_BY_TIME:
+            PassRatio = (Pkt->Filter.Param.X == 0) ? 0.0 : (double)Pkt->Filter.Param.N/Pkt->Filter.Param.X;
+            if (PassRatio > 1.0) PassRatio = 1.0;
+            break;
+         default:
+            PassRatio = 1.0;
+            break;
+      }
+      
+      PktsPerSec      = Obs->Pkts/ObsSecs;
+      InBytesPerSec  += Obs->Bytes/ObsSecs;
+      OutBytesPerSec += PassRatio*Obs->Bytes/ObsSecs;
+      OutPktsPerSec  += PassRatio*PktsPerSec;
+      
+      RecBufLim    = (uint16)ceil(PktsPerSec*CycleSecs) + 1;
+      PeakBacklog += RecBufLim - 1;
+      
+      if (Pkt->BufLim < RecBufLim)
+      {
+         if (Plan->BufLimLowCnt < PKTMGR_PLAN_ENTRY_MAX)
+         {
+            Plan->Entry[Plan->BufLimLowCnt].MsgId     = Pkt->MsgId;
+            Plan->Entry[Plan->BufLimLowCnt].BufLim    = Pkt->BufLim;
+            Plan->Entry[Plan->BufLimLowCnt].RecBufLim = RecBufLim;
+         }
+         ++Plan->BufLimLowCnt;
+      }
+      
+   } /* End entry loop */
+   
+   for (i=(Plan->BufLimLowCnt < PKTMGR_PLAN_ENTRY_MAX ? Plan->BufLimLowCnt : PKTMGR_PLAN_ENTRY_MAX); i < PKTMGR_PLAN_ENTRY_MAX; i++)
+   {
+      Plan->Entry[i].MsgId     = PKTTBL_UNUSED_MSG_ID;
+      Plan->Entry[i].BufLim    = 0;
+      Plan->Entry[i].RecBufLim = 0;
+   }
+   
+   Plan->InBytesPerSec  = round(InBytesPerSec);
+   Plan->OutBytesPerSec = round(OutBytesPerSec);
+   Plan->OutPktsPerSec  = round(OutPktsPerSec);
+   Plan->PeakBacklog    = (PeakBacklog > 0xFFFF) ? 0xFFFF : PeakBacklog;
+   Plan->PipeDepth      = INITBL_GetIntConfig(PktMgr->IniTbl, CFG_PKTMGR_PIPE_DEPTH);
+   Plan->RecPipeDepth   = (PeakBacklog + (PeakBacklog+1)/2 > 0xFFFF) ? 0xFFFF : PeakBacklog + (PeakBacklog+1)/2;
+   Plan->LinkBudget     = PktMgr->LinkBudget;
+   Plan->OverBudget     = ((PktMgr->LinkBudget > 0) && (Plan->OutBytesPerSec > PktMgr->LinkBudget));
+   Plan->SpareAlignByte = 0;
+   
+} /* End ComputePlan() */
+
+
+/******************************************************************************
+** Function:  ComputeStats
+**
+** Called each output telemetry cycle
+**
+** Notes:
+**   1. When MeasureInterval is set the computational interval is a running
+**      average of the measured time between calls rather than the configured
+**      run loop delay.
+*/
+static void ComputeStats(PKTMGR_Class_t *PktMgr, uint16 PktsSent, uint32 BytesSent)
+{
+
+   uint32 DeltaTimeMicroSec;   
+   double DeltaMilliSecs;
+   CFE_TIME_SysTime_t CurrTime = CFE_TIME_GetTime();
+   CFE_TIME_SysTime_t DeltaTime;
+   
+   if (PktMgr->Stats.InitCycles > 0)
+   {
+   
+      --PktMgr->Stats.InitCycles;
+      PktMgr->Stats.PrevTime = CFE_TIME_GetTime();
+      PktMgr->Stats.State = PKTMGR_STATS_INIT_CYCLE;
+
+   }
+   else
+   {
+      
+      DeltaTime = CFE_TIME_Subtract(CurrTime, PktMgr->Stats.PrevTime);
+      DeltaTimeMicroSec = CFE_TIME_Sub2MicroSecs(DeltaTime.Subseconds); 
+      
+      DeltaMilliSecs = (double)DeltaTime.Seconds*1000.0 + (double)DeltaTimeMicroSec/1000.0;
+      
+      if (PktMgr->Stats.MeasureInterval)
+      {
+         PktMgr->Stats.OutputTlmInterval = (PktMgr->Stats.OutputTlmInterval + DeltaMilliSecs) / 2.0;
+      }
+      
+      PktMgr->Stats.IntervalMilliSecs += DeltaMilliSecs;
+      PktMgr->Stats.IntervalPkts      += PktsSent;
+      PktMgr->Stats.IntervalBytes     += BytesSent;
+
+      if (PktMgr->Stats.IntervalMilliSecs >= PktMgr->Stats.OutputTlmInterval)
+      {
+      
+         double Seconds = PktMgr->Stats.IntervalMilliSecs/1000;
+         
+         CFE_EVS_SendEvent(PKTMGR_DEBUG_EID, CFE_EVS_EventType_DEBUG,
+                           "IntervalSecs=%f, IntervalPkts=%d, IntervalBytes=%d\n",
+                           Seconds,PktMgr->Stats.IntervalPkts,PktMgr->Stats.IntervalBytes);
+        
+         PktMgr->Stats.AvgPktsPerSec  = (double)PktMgr->Stats.IntervalPkts/Seconds;
+         PktMgr->Stats.AvgBytesPerSec = (double)PktMgr->Stats.IntervalBytes/Seconds;
+         
+         /* Good enough running average that avoids overflow */
+         if (PktMgr->Stats.State == PKTMGR_STATS_INIT_CYCLE) {
+     
+            PktMgr->Stats.State = PKTMGR_STATS_INIT_INTERVAL;
+       
+         }
+         else
+         {
+            
+            PktMgr->Stats.State = PKTMGR_STATS_VALID;
+            PktMgr->Stats.AvgPktsPerSec  = (PktMgr->Stats.AvgPktsPerSec  + PktMgr->Stats.PrevIntervalAvgPkts) / 2.0; 
+            PktMgr->Stats.AvgBytesPerSec = (PktMgr->Stats.AvgBytesPerSec + PktMgr->Stats.PrevIntervalAvgBytes) / 2.0; 
+  
+         }
+         
+         PktMgr->Stats.PrevIntervalAvgPkts  = PktMgr->Stats.AvgPktsPerSec;
+         PktMgr->Stats.PrevIntervalAvgBytes = PktMgr->Stats.AvgBytesPerSec;
+         
+         PktMgr->Stats.IntervalMilliSecs = 0.0;
+         PktMgr->Stats.IntervalPkts      = 0;
+         PktMgr->Stats.IntervalBytes     = 0;
+      
+      } /* End if report cycle */
+      
+      PktMgr->Stats.PrevTime = CFE_TIME_GetTime();
+      
+   } /* End if not init cycle */
+   
+
+} /* End ComputeStats() */
+
+
+/******************************************************************************
+** Function: CounterDelta
+**
+** Return the change in a counter written by a pipeline stage task since the
+** previous call and remember its current value.
+*/
+static uint32 CounterDelta(uint32 *Counter, uint32 *Prev)
+{
+
+   uint32 Value = __atomic_load_n(Counter, __ATOMIC_RELAXED);
+   uint32 Delta = Value - *Prev;
+   
+   *Prev = Value;
+   
+   return Delta;
+
+} /* End CounterDelta() */
+
+
+/******************************************************************************
+** Function: CreatePipeline
+**
+** Create the output pipeline semaphores and the pack and send stage tasks.
+** PipelineEna is only set when every task is created.
+*/
+static void CreatePipeline(PKTMGR_Class_t *PktMgr)
+{
+
+   int32  Status;
+   char   Name[OS_MAX_API_NAME];
+   PKTMGR_Pipeline_t *Pipe = &PktMgr->Priv.Pipeline;
+   
+   memset(Pipe, 0, sizeof(PKTMGR_Pipeline_t));
+
+   snprintf(Name, sizeof(Name), "KIT_TO_PSTART%d", PktMgr->Channel);
+   Status = OS_BinSemCreate(&Pipe->StartSem, Name, OS_SEM_EMPTY, 0);
+   
+   if (Status == OS_SUCCESS)
+   {
+      snprintf(Name, sizeof(Name), "KIT_TO_PMSG%d", PktMgr->Channel);
+      Status = OS_BinSemCreate(&Pipe->MsgRing.DataSem, Name, OS_SEM_EMPTY, 0);
+   }
+   if (Status == OS_SUCCESS)
+   {
+      snprintf(Name, sizeof(Name), "KIT_TO_PDGM%d", PktMgr->Channel);
+      Status = OS_BinSemCreate(&Pipe->DatagramRing.DataSem, Name, OS_SEM_EMPTY, 0);
+   }
+   if (Status == OS_SUCCESS)
+   {
+      snprintf(Name, sizeof(Name), "KIT_TO_PSPACE%d", PktMgr->Channel);
+      Status = OS_BinSemCreate(&Pipe->DatagramRing.SpaceSem, Name, OS_SEM_EMPTY, 0);
+   }
+   
+   if (Status == OS_SUCCESS)
+   {
+      snprintf(Name, sizeof(Name), "%s%d_PACK", INITBL_GetStrConfig(PktMgr->IniTbl, CFG_PKTMGR_WORKER_NAME), PktMgr->Channel);
+      OS_MutSemTake(InstanceMutex);
+      Status = CFE_ES_CreateChildTask(&Pipe->PackTaskId, Name, PipelinePackTask, 0,
+                                      INITBL_GetIntConfig(PktMgr->IniTbl, CFG_PKTMGR_WORKER_STACK_SIZE),
+                                      INITBL_GetIntConfig(PktMgr->IniTbl, CFG_PKTMGR_WORKER_PRIORITY), 0);
+      OS_MutSemGive(InstanceMutex);
+      if (Status == CFE_SUCCESS)
+      {
+         OS_BinSemTake(Pipe->StartSem);
+      }
+   }
+   
+   if (Status == CFE_SUCCESS)
+   {
+      snprintf(Name, sizeof(Name), "%s%d_SEND", INITBL_GetStrConfig(PktMgr->IniTbl, CFG_PKTMGR_WORKER_NAME), PktMgr->Channel);
+      OS_MutSemTake(InstanceMutex);
+      Status = CFE_ES_CreateChildTask(&Pipe->SendTaskId, Name, PipelineSendTask, 0,
+                                      INITBL_GetIntConfig(PktMgr->IniTbl, CFG_PKTMGR_WORKER_STACK_SIZE),
+                                      INITBL_GetIntConfig(PktMgr->IniTbl, CFG_PKTMGR_WORKER_PRIORITY), 0);
+      OS_MutSemGive(InstanceMutex);
+      if (Status == CFE_SUCCESS)
+      {
+         OS_BinSemTake(Pipe->StartSem);
+      }
+   }
+   
+   if (Status == CFE_SUCCESS)
+   {
+      PktMgr->PipelineEna = true;
+      CFE_EVS_SendEvent(PKTMGR_PIPELINE_EID, CFE_EVS_EventType_INFORMATION,
+                        "Channel %d output is packed and sent by pipeline stage tasks with %d slot rings",
+                        PktMgr->Channel, PKTMGR_PIPELINE_LEN);
+   }
+   else
+   {
+      CFE_EVS_SendEvent(PKTMGR_PIPELINE_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating channel %d output pipeline, status 0x%08X. Output will be performed by the app task",
+                        PktMgr->Channel, (unsigned int)Status);
+   }
+   
+} /* End CreatePipeline() */
+
+
+/******************************************************************************
+** Function: CreateWorkers
+**
+** Create WorkerCnt output worker pipes, semaphores and child tasks. 
+**
+** Notes:
+**   1. WorkerCnt is only set when every worker is created. Workers created
+**      before a failure stay blocked on their WakeSem.
+**   2. Must be called before any packets are subscribed.
+*/
+static void CreateWorkers(PKTMGR_Class_t *PktMgr, const char *PipeName, uint16 WorkerCnt)
+{
+
+   int32  Status = CFE_SUCCESS;
+   uint16 i;
+   char   Name[OS_MAX_API_NAME];
+   PKTMGR_Worker_t *Worker;
+   
+   PktMgr->WorkerCnt     = 0;
+   PktMgr->WorkerCycleMs = 0;
+   
+   if (WorkerCnt == 0) return;
+   
+   if (WorkerCnt > PKTMGR_MAX_WORKERS)
+   {
+      CFE_EVS_SendEvent(PKTMGR_WORKER_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Channel %d worker count %d exceeds the maximum %d. Output will be performed by the app task",
+                        PktMgr->Channel, WorkerCnt, PKTMGR_MAX_WORKERS);
+      return;
+   }
+   
+   for (i=0; (i < WorkerCnt) && (Status == CFE_SUCCESS); i++)
+   {
+      
+      Worker = &PktMgr->Worker[i];
+      memset(Worker, 0, sizeof(PKTMGR_Worker_t));
+      
+      snprintf(Name, sizeof(Name), "%s_W%d", PipeName, i);
+      Status = CFE_SB_CreatePipe(&Worker->Pipe, INITBL_GetIntConfig(PktMgr->IniTbl, CFG_PKTMGR_PIPE_DEPTH), Name);
+      
+      if (Status == CFE_SUCCESS)
+      {
+         snprintf(Name, sizeof(Name), "KIT_TO_WAKE%d_%d", PktMgr->Channel, i);
+         Status = OS_BinSemCreate(&Worker->WakeSem, Name, OS_SEM_EMPTY, 0);
+      }
+      
+      if (Status == OS_SUCCESS)
+      {
+         snprintf(Name, sizeof(Name), "KIT_TO_DONE%d_%d", PktMgr->Channel, i);
+         Status = OS_BinSemCreate(&Worker->DoneSem, Name, OS_SEM_EMPTY, 0);
+      }
+      
+      if (Status == OS_SUCCESS)
+      {
+         snprintf(Name, sizeof(Name), "%s%d_%d", INITBL_GetStrConfig(PktMgr->IniTbl, CFG_PKTMGR_WORKER_NAME), PktMgr->Channel, i);
+         OS_MutSemTake(InstanceMutex);
+         Status = CFE_ES_CreateChildTask(&Worker->TaskId, Name, WorkerTask, 0,
+                                         INITBL_GetIntConfig(PktMgr->IniTbl, CFG_PKTMGR_WORKER_STACK_SIZE),
+                                         INITBL_GetIntConfig(PktMgr->IniTbl, CFG_PKTMGR_WORKER_PRIORITY), 0);
+         OS_MutSemGive(InstanceMutex);
+         if (Status == CFE_SUCCESS)
+         {
+            OS_BinSemTake(Worker->DoneSem);
+         }
+      }
+      
+   } /* End worker loop */
+   
+   if (Status == CFE_SUCCESS)
+   {
+      PktMgr->WorkerCnt = WorkerCnt;
+      CFE_EVS_SendEvent(PKTMGR_WORKER_EID, CFE_EVS_EventType_INFORMATION,
+                        "Channel %d output is performed by %d workers", PktMgr->Channel, WorkerCnt);
+   }
+   else
+   {
+      CFE_EVS_SendEvent(PKTMGR_WORKER_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating channel %d output worker %d, status 0x%08X. Output will be performed by the app task",
+                        PktMgr->Channel, i-1, (unsigned int)Status);
+   }
+   
+} /* End CreateWorkers() */
+
+
+/******************************************************************************
+** Function: DestructorCallback
+**
+** This function is called when the app is killed. This should
+** never occur but if it does this will close each channel's network sockets.
+*/
+static void DestructorCallback(void)
+{
+
+   uint16 i, w;
+   PKTMGR_Class_t *PktMgr;
+   
+   for (i=0; i < PKTMGR_MAX_CHANNELS; i++)
+   {
+   
+      PktMgr = Instance[i];
+      if (PktMgr == NULL) continue;
+      
+      CFE_EVS_SendEvent(PKTMGR_DESTRUCTOR_INFO_EID, CFE_EVS_EventType_INFORMATION, 
+                        "Destructor callback -- Closing TO channel %d network socket. Downlink on = %d\n",
+                        PktMgr->Channel, PktMgr->DownlinkOn);
+      
+      if (PktMgr->DownlinkOn)
+      {
+         
+         OS_close(PktMgr->TlmSockId);
+      
+      }
+      
+      for (w=0; w < PktMgr->WorkerCnt; w++)
+      {
+         if (PktMgr->Worker[w].SockOpen) OS_close(PktMgr->Worker[w].SockId);
+      }
+      
+      if (PktMgr->FeedbackEna) OS_close(PktMgr->FeedbackSockId);
+   
+   } /* End channel loop */
+
+} /* End DestructorCallback() */
+
+
+/******************************************************************************
+** Function: EnableOutput
+**
+** Enable output to the current TlmDestIp. If downlink is disabled then a new
+** socket is created and downlink is turned on. If already enabled then the
+** destination address is changed in the existing socket.
+*/
+static bool EnableOutput(PKTMGR_Class_t *PktMgr)
+{
+
+   bool   RetStatus = true;
+   int32  OsStatus;
+   uint16 i;
+   
+   PktMgr->SuppressSend = false;
+   PktMgr->SendErrRun   = 0;
+   PktMgr->FeedbackTime = CFE_TIME_GetTime();
+   for (i=0; i < PktMgr->WorkerCnt; i++)
+   {
+      PktMgr->Worker[i].SendErrRun = 0;
+   }
+   __atomic_store_n(&PktMgr->Priv.Pipeline.SendErrStatus, 0, __ATOMIC_RELAXED);
+   CFE_EVS_SendEvent(PKTMGR_TLM_OUTPUT_ENA_INFO_EID, CFE_EVS_EventType_INFORMATION,
+                     "Telemetry output enabled for IP %s", PktMgr->TlmDestIp);
+
+   if(PktMgr->DownlinkOn == false)
+   {
+
+      OsStatus = OS_SocketOpen(&PktMgr->TlmSockId, OS_SocketDomain_INET, OS_SocketType_DATAGRAM);
+
+      if ((OsStatus == OS_SUCCESS) && !OpenWorkerSockets(PktMgr))
+      {
+         OS_close(PktMgr->TlmSockId);
+         RetStatus = false;
+      }
+      else if (OsStatus == OS_SUCCESS)
+      {
+         PKTMGR_InitStats(PktMgr, INITBL_GetIntConfig(PktMgr->IniTbl, CFG_APP_RUN_LOOP_DELAY),
+                          INITBL_GetIntConfig(PktMgr->IniTbl, CFG_PKTMGR_STATS_CONFIG_DELAY));
+         PktMgr->DownlinkOn = true;
+      }
+      else
+      {
+         RetStatus = false;
+         CFE_EVS_SendEvent(PKTMGR_TLM_OUTPUT_ENA_SOCKET_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Telemetry output socket open error. Status = %d", OsStatus);
+      }
+
+   } /* End if downlink disabled */
+
+   return RetStatus;
+
+} /* End EnableOutput() */
+
+
+/******************************************************************************
+** Function: FindPktStats
+**
+** Return the input statistics of MsgId's current packet table entry or NULL
+** if MsgId isn't in the table or nothing has been counted for it.
+*/
+static const PKTMGR_PktStats_t *FindPktStats(PKTMGR_Class_t *PktMgr, uint16 MsgId)
+{
+
+   const PKTTBL_Pkt_t      *PktPtr = PKTTBL_GetPkt(&(PktMgr->PktTbl.Data), MsgId);
+   const PKTMGR_PktStats_t *Stats;
+   
+   if (PktPtr == NULL) return NULL;
+   
+   Stats = &PktMgr->Priv.PktStats[PktPtr - PktMgr->PktTbl.Data.Pkt];
+   
+   return (Stats->MsgId == MsgId) ? Stats : NULL;
+
+} /* End FindPktStats() */
+
+
+/******************************************************************************
+** Function: FlushTlmPipe
+**
+** Remove all of the packets from the input pipe and the worker pipes.
+**
+*/
+static void FlushTlmPipe(PKTMGR_Class_t *PktMgr)
+{
+
+   int32 SbStatus;
+   uint16 i;
+   CFE_SB_Buffer_t  *SbBufPtr;
+
+   do
+   {
+      SbStatus = CFE_SB_ReceiveBuffer(&SbBufPtr, PktMgr->TlmPipe, CFE_SB_POLL);
+
+   } while(SbStatus == CFE_SUCCESS);
+
+   for (i=0; i < PktMgr->WorkerCnt; i++)
+   {
+      do
+      {
+         SbStatus = CFE_SB_ReceiveBuffer(&SbBufPtr, PktMgr->Worker[i].Pipe, CFE_SB_POLL);
+
+      } while(SbStatus == CFE_SUCCESS);
+   }
+
+} /* End FlushTlmPipe() */
+   
+
+/******************************************************************************
+** Function: GetPktStats
+**
+** Return the input statistics of a packet table entry.
+**
+** Notes:
+**   1. Statistics are kept per table slot like the last value cache. A slot
+**      whose counts belong to another message ID, because the entry was
+**      removed or moved by a removal, is cleared and assigned to PktPtr's
+**      message ID.
+*/
+static PKTMGR_PktStats_t *GetPktStats(PKTMGR_Class_t *PktMgr, const PKTTBL_Pkt_t *PktPtr)
+{
+
+   PKTMGR_PktStats_t *Stats = &PktMgr->Priv.PktStats[PktPtr - PktMgr->PktTbl.Data.Pkt];
+   
+   if (Stats->MsgId != PktPtr->MsgId)
+   {
+      Stats->MsgId      = PktPtr->MsgId;
+      Stats->Pkts       = 0;
+      Stats->Bytes      = 0;
+      Stats->StaleDrops = 0;
+      Stats->Superseded = 0;
+   }
+   
+   return Stats;
+
+} /* End GetPktStats() */
+
+
+/******************************************************************************
+** Function: GetTaskInstance
+**
+** Return the channel that created the calling worker or pipeline stage task
+** and set WorkerIdx to the worker's index. 
+**
+** Notes:
+**   1. Returns NULL, after exiting the task, if the task isn't found. This
+**      can only happen if the creator didn't hold InstanceMutex.
+*/
+static PKTMGR_Class_t *GetTaskInstance(uint16 *WorkerIdx)
+{
+
+   uint16 i, w;
+   CFE_ES_TaskId_t TaskId;
+   PKTMGR_Class_t *PktMgr;
+   PKTMGR_Class_t *TaskPktMgr = NULL;
+   
+   *WorkerIdx = 0;
+   CFE_ES_GetTaskID(&TaskId);
+   
+   OS_MutSemTake(InstanceMutex);
+   for (i=0; (i < PKTMGR_MAX_CHANNELS) && (TaskPktMgr == NULL); i++)
+   {
+      PktMgr = Instance[i];
+      if (PktMgr == NULL) continue;
+      
+      if (CFE_RESOURCEID_TEST_EQUAL(PktMgr->Priv.Pipeline.PackTaskId, TaskId) ||
+          CFE_RESOURCEID_TEST_EQUAL(PktMgr->Priv.Pipeline.SendTaskId, TaskId))
+      {
+         TaskPktMgr = PktMgr;
+      }
+      for (w=0; (w < PKTMGR_MAX_WORKERS) && (TaskPktMgr == NULL); w++)
+      {
+         if (CFE_RESOURCEID_TEST_EQUAL(PktMgr->Worker[w].TaskId, TaskId))
+         {
+            TaskPktMgr = PktMgr;
+            *WorkerIdx = w;
+         }
+      }
+   }
+   OS_MutSemGive(InstanceMutex);
+   
+   if (TaskPktMgr == NULL)
+   {
+      CFE_EVS_SendEvent(PKTMGR_WORKER_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Output child task isn't owned by a channel, terminating");
+      CFE_ES_ExitChildTask();
+   }
+   
+   return TaskPktMgr;
+
+} /* End GetTaskInstance() */
+
+
+/******************************************************************************
+** Function: IsTransientSendErr
+**
+** Classify a failed SendSocket() status. ErrRun is the sender's count of
+** consecutive OS_ERROR failures and is cleared by the sender when a send
+** succeeds.
+**
+** Notes:
+**   1. OS_ERROR_TIMEOUT means the socket wasn't writable so nothing was
+**      sent and it's always retried.
+**   2. OS_ERROR is any network stack failure. A full send buffer clears
+**      quickly so it's retried until PKTMGR_SEND_ERR_LIMIT consecutive
+**      failures, after which it's treated as a hard error. The other codes
+**      mean the socket or its arguments are bad and retrying can't succeed.
+**   3. errno isn't used because it's owned by the OSAL implementation and
+**      may have been changed before the call returns.
+*/
+static bool IsTransientSendErr(int32 SocketStatus, uint16 *ErrRun)
+{
+
+   if (SocketStatus == OS_ERROR_TIMEOUT) return true;
+   
+   if (SocketStatus != OS_ERROR) return false;
+   
+   if (*ErrRun < PKTMGR_SEND_ERR_LIMIT) ++(*ErrRun);
+   
+   return (*ErrRun < PKTMGR_SEND_ERR_LIMIT);
+   
+} /* End IsTransientSendErr() */
+
+
+/******************************************************************************
+** Function: LoadPktTbl
+**
+** Apply a new packet table by only changing the entries that differ from the
+** current table.
+**
+** Notes:
+**   1. Function signature must match the PKTTBL_LoadNewTbl_t definition
+**   2. Removed entries are unsubscribed and added entries are subscribed.
+**      Entries with a new QoS or buffer limit are resubscribed. Filter-only
+**      changes are updated in place without touching the subscription.
+**   3. The telemetry pipe is not flushed so unchanged packets continue to
+**      flow during the load.
+**   4. An entry whose subscription fails is left unused in the table.
+**   5. The table is rejected without any changes if a link budget is
+**      configured and the table's predicted output exceeds it, or if it has
+**      coalescing entries and output is performed by child tasks.
+**   6. Only entries in the active profile are subscribed. The active profile
+**      is kept if the new table defines it, otherwise profile 0 is used.
+**      Entries whose membership changes are treated like a QoS change.
+**   7. SB treats a second subscription to a topic on the same pipe as a
+**      duplicate and keeps the original QoS and buffer limit, so a
+**      resubscribe must unsubscribe first. Packets published between the
+**      two calls are lost. Resubscribes are counted in the load event. If
+**      the unsubscribe fails the entry keeps its current definition.
+*/
+static bool LoadPktTbl(void *Owner, PKTTBL_Data_t* NewTbl)
+{
+
+   PKTMGR_Class_t *PktMgr = (PKTMGR_Class_t *)Owner;
+   uint16  i;
+   uint16  NewProfile = (PktMgr->ActiveProfile < NewTbl->ProfileCnt) ? PktMgr->ActiveProfile : 0;
+   bool    CurSub;
+   bool    NewSub;
+   uint16  PktCnt  = NewTbl->ActiveCnt;
+   uint16  AddCnt  = 0;
+   uint16  RemoveCnt = 0;
+   uint16  ChangeCnt = 0;
+   uint16  ResubCnt  = 0;
+   uint16  FailedSubscription = 0;
+   int32   Status;
+   bool    RetStatus = true;
+   
+   PKTTBL_Data_t *CurTbl = &(PktMgr->PktTbl.Data);
+   PKTTBL_Pkt_t  *CurPkt;
+   PKTTBL_Pkt_t  *NewPkt;
+   
+
+   if (((PktMgr->WorkerCnt > 0) || PktMgr->PipelineEna) && (CoalesceEntryCnt(NewTbl) > 0))
+   {
+      CFE_EVS_SendEvent(PKTMGR_LOAD_TBL_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Rejected table load with %d coalescing entries. Channel %d output is performed by child tasks that don't coalesce",
+                        CoalesceEntryCnt(NewTbl), PktMgr->Channel);
+      return false;
+   }
+   
+   if (PktMgr->LinkBudget > 0)
+   {
+      ComputePlan(PktMgr, NewTbl);
+      if (PktMgr->PlanTlm.OverBudget)
+      {
+         CFE_EVS_SendEvent(PKTMGR_LOAD_TBL_BUDGET_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Rejected table load with %d packets. Predicted output %d bytes/sec exceeds the %d bytes/sec link budget",
+                           PktCnt, (int)PktMgr->PlanTlm.OutBytesPerSec, (int)PktMgr->LinkBudget);
+         return false;
+      }
+   }
+   
+   LvcClear(PktMgr);
+   
+   /*
+   ** Pass 1: Remove or update current entries. The active index is traversed
+   ** from the end so removing an entry doesn't move unvisited entries.
+   */
+   
+   for (i=CurTbl->ActiveCnt; i > 0; i--) {
+
+      CurPkt = &(CurTbl->Pkt[CurTbl->ActiveIdx[i-1]]);
+      NewPkt = PKTTBL_GetPkt(NewTbl, CurPkt->MsgId);
+      CurSub = PKTTBL_IN_PROFILE(CurPkt, PktMgr->ActiveProfile);
+      
+      if (NewPkt == NULL) {
+         
+         ++RemoveCnt;
+         Status = CurSub ? CFE_SB_Unsubscribe(CFE_SB_ValueToMsgId(CurPkt->MsgId), PktPipe(PktMgr, CurPkt->MsgId)) : CFE_SUCCESS;
+         if (Status != CFE_SUCCESS) {
+            CFE_EVS_SendEvent(PKTMGR_REMOVE_PKT_ERROR_EID, CFE_EVS_EventType_ERROR,
+                              "Error removing message ID 0x%04X at table packet index %d. Unsubscribe status 0x%8X",
+                              CurPkt->MsgId, CurTbl->ActiveIdx[i-1], Status);
+         }
+         PKTTBL_RemovePkt(CurTbl, CurPkt->MsgId);
+         continue;
+      
+      }
+      
+      NewSub = PKTTBL_IN_PROFILE(NewPkt, NewProfile);
+      
+      if ((CurPkt->Qos.Priority    != NewPkt->Qos.Priority)    ||
+          (CurPkt->Qos.Reliability != NewPkt->Qos.Reliability) ||
+          (CurPkt->BufLim          != NewPkt->BufLim)          ||
+          (CurSub != NewSub)) {
+         
+         ++ChangeCnt;
+         if (CurSub) {
+            
+            Status = CFE_SB_Unsubscribe(CFE_SB_ValueToMsgId(CurPkt->MsgId), PktPipe(PktMgr, CurPkt->MsgId));
+            if (Status != CFE_SUCCESS) {
+               ++FailedSubscription;
+               CFE_EVS_SendEvent(PKTMGR_LOAD_TBL_SUBSCRIBE_ERR_EID,CFE_EVS_EventType_ERROR,
+                                 "Error unsubscribing message ID 0x%04X to apply a new definition, Status %i. Current definition kept",
+                                 CurPkt->MsgId, Status);
+               continue;
+            }
+            if (NewSub) ++ResubCnt;
+         }
+         
+         Status = NewSub ? SubscribeNewPkt(PktMgr, NewPkt) : CFE_SUCCESS; 
+         if(Status == CFE_SUCCESS) {
+            PKTTBL_SetPkt(CurTbl, NewPkt);
+         }
+         else {
+            ++FailedSubscription;
+            CFE_EVS_SendEvent(PKTMGR_LOAD_TBL_SUBSCRIBE_ERR_EID,CFE_EVS_EventType_ERROR,
+                              "Error subscribing to message ID 0x%04X, BufLim %d, Status %i",
+                              NewPkt->MsgId, NewPkt->BufLim, Status);
+            PKTTBL_RemovePkt(CurTbl, CurPkt->MsgId);
+         }
+         
+      }
+      else if ((CurPkt->Filter.Type    != NewPkt->Filter.Type)    ||
+               (CurPkt->Filter.Param.N != NewPkt->Filter.Param.N) ||
+               (CurPkt->Filter.Param.X != NewPkt->Filter.Param.X) ||
+               (CurPkt->Filter.Param.O != NewPkt->Filter.Param.O) ||
+               (CurPkt->ProfileMask    != NewPkt->ProfileMask) ||
+               (CurPkt->MaxAge         != NewPkt->MaxAge) ||
+               (CurPkt->Coalesce       != NewPkt->Coalesce)) {
+      
+         ++ChangeCnt;
+         CurPkt->Filter      = NewPkt->Filter;
+         CurPkt->ProfileMask = NewPkt->ProfileMask;
+         CurPkt->MaxAge      = NewPkt->MaxAge;
+         CurPkt->Coalesce    = NewPkt->Coalesce;
+      
+      }
+      
+   } /* End current pkt loop */
+
+   /*
+   ** Pass 2: Add new entries
+   */
+   
+   for (i=0; i < NewTbl->ActiveCnt; i++) {
+   
+      NewPkt = &(NewTbl->Pkt[NewTbl->ActiveIdx[i]]);
+      
+      if (PKTTBL_GetPkt(CurTbl, NewPkt->MsgId) == NULL) {
+         
+         ++AddCnt;
+         Status = PKTTBL_IN_PROFILE(NewPkt, NewProfile) ? SubscribeNewPkt(PktMgr, NewPkt) : CFE_SUCCESS; 
+
+         if(Status == CFE_SUCCESS) {
+         
+            PKTTBL_SetPkt(CurTbl, NewPkt);
+         
+         }
+         else {
+            
+            ++FailedSubscription;
+            CFE_EVS_SendEvent(PKTMGR_LOAD_TBL_SUBSCRIBE_ERR_EID,CFE_EVS_EventType_ERROR,
+                              "Error subscribing to message ID 0x%04X, BufLim %d, Status %i",
+                              NewPkt->MsgId, NewPkt->BufLim, Status);
+         }
+      }
+
+   } /* End new pkt loop */
+
+   CurTbl->ProfileCnt = NewTbl->ProfileCnt;
+   memcpy(CurTbl->ProfileName, NewTbl->ProfileName, sizeof(CurTbl->ProfileName));
+   PktMgr->ActiveProfile = NewProfile;
+   
+   SaveCdsImage(PktMgr);
+   
+   if (FailedSubscription == 0) {
+      
+      PKTMGR_InitStats(PktMgr, INITBL_GetIntConfig(PktMgr->IniTbl, CFG_APP_RUN_LOOP_DELAY),
+                       INITBL_GetIntConfig(PktMgr->IniTbl, CFG_PKTMGR_STATS_INIT_DELAY));
+      CFE_EVS_SendEvent(PKTMGR_LOAD_TBL_INFO_EID, CFE_EVS_EventType_INFORMATION,
+                        "Successfully loaded new table with %d packets: %d added, %d removed, %d changed, %d resubscribed. Active profile %s", 
+                        PktCnt, AddCnt, RemoveCnt, ChangeCnt, ResubCnt, ProfileNameStr(CurTbl, NewProfile));
+   }
+   else {
+      
+      RetStatus = false;
+      CFE_EVS_SendEvent(PKTMGR_LOAD_TBL_ERR_EID, CFE_EVS_EventType_INFORMATION,
+                        "Attempted to load new table with %d packets: %d added, %d removed, %d changed, %d resubscribed. Failed %d subscriptions",
+                        PktCnt, AddCnt, RemoveCnt, ChangeCnt, ResubCnt, FailedSubscription);
+   }
+
+   return RetStatus;
+
+} /* End LoadPktTbl() */
+
+
+/******************************************************************************
+** Function: LvcClear
+**
+** Empty the last value cache and release the whole pool. A snapshot in
+** progress is stopped.
+*/
+static void LvcClear(PKTMGR_Class_t *PktMgr)
+{
+
+   uint16 i;
+   
+   for (i=0; i < PKTTBL_MAX_SLOTS; i++)
+   {
+      PktMgr->Priv.LvcEntry[i].MsgId = PKTTBL_UNUSED_MSG_ID;
+      PktMgr->Priv.LvcEntry[i].Cap   = 0;
+   }
+   
+   PktMgr->LvcEntryCnt    = 0;
+   PktMgr->LvcPoolUsed    = 0;
+   PktMgr->SnapshotActive = false;
+   
+} /* End LvcClear() */
+
+
+/******************************************************************************
+** Function: LvcStore
+**
+** Save a packed datagram as the last value of its packet table entry.
+**
+** Notes:
+**   1. An entry's pool space is allocated when its first datagram is stored
+**      and is reused while later datagrams fit. Space left behind by an
+**      entry that outgrows its allocation is only reclaimed by LvcClear().
+**   2. Datagrams are not cached when the pool is full.
+*/
+static void LvcStore(PKTMGR_Class_t *PktMgr, const PKTTBL_Pkt_t *PktPtr, const void *Datagram, size_t DatagramLen, uint32 MsgLen)
+{
+
+   uint16  Slot  = (uint16)(PktPtr - PktMgr->PktTbl.Data.Pkt);
+   uint32  Cap;
+   PKTMGR_LvcEntry_t *Entry = &PktMgr->Priv.LvcEntry[Slot];
+   
+   if (DatagramLen > Entry->Cap)
+   {
+      Cap = (DatagramLen + 3) & ~3;
+      if ((PktMgr->LvcPoolUsed + Cap) > PKTMGR_LVC_POOL_SIZE)
+      {
+         ++PktMgr->LvcFullCnt;
+         return;
+      }
+      Entry->Offset = PktMgr->LvcPoolUsed;
+      Entry->Cap    = Cap;
+      PktMgr->LvcPoolUsed += Cap;
+   }
+   
+   if (Entry->MsgId == PKTTBL_UNUSED_MSG_ID)
+   {
+      ++PktMgr->LvcEntryCnt;
+   }
+   
+   Entry->MsgId  = PktPtr->MsgId;
+   Entry->Len    = DatagramLen;
+   Entry->MsgLen = MsgLen;
+   memcpy(&PktMgr->Priv.LvcPool[Entry->Offset], Datagram, DatagramLen);
+   
+} /* End LvcStore() */
+
+
+/******************************************************************************
+** Function: OpenFeedbackSocket
+**
+** Open and bind the ground feedback socket. Feedback is disabled when the
+** port is 0 or the socket can't be created.
+*/
+static void OpenFeedbackSocket(PKTMGR_Class_t *PktMgr, uint16 Port)
+{
+
+   int32          OsStatus;
+   OS_SockAddr_t  SocketAddr;
+   
+   if (Port == 0) return;
+   
+   OsStatus = OS_SocketOpen(&PktMgr->FeedbackSockId, OS_SocketDomain_INET, OS_SocketType_DATAGRAM);
+   
+   if (OsStatus == OS_SUCCESS)
+   {
+      
+      OS_SocketAddrInit(&SocketAddr, OS_SocketDomain_INET);
+      OS_SocketAddrSetPort(&SocketAddr, Port);
+      OsStatus = OS_SocketBind(PktMgr->FeedbackSockId, &SocketAddr);
+      
+      if (OsStatus != OS_SUCCESS) OS_close(PktMgr->FeedbackSockId);
+   
+   }
+   
+   if (OsStatus == OS_SUCCESS)
+   {
+      PktMgr->FeedbackEna = true;
+      CFE_EVS_SendEvent(PKTMGR_FEEDBACK_EID, CFE_EVS_EventType_INFORMATION,
+                        "Ground feedback enabled on port %d, rate %u to %u bytes/sec",
+                        Port, (unsigned int)PktMgr->FeedbackMinRate, (unsigned int)PktMgr->FeedbackMaxRate);
+   }
+   else
+   {
+      CFE_EVS_SendEvent(PKTMGR_FEEDBACK_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Ground feedback disabled, error opening socket on port %d. Status = %d",
+                        Port, (int)OsStatus);
+   }
+
+} /* End OpenFeedbackSocket() */
+
+
+/******************************************************************************
+** Function: OpenWorkerSockets
+**
+** Open each output worker's socket. Sockets that were opened are closed
+** if any open fails.
+*/
+static bool OpenWorkerSockets(PKTMGR_Class_t *PktMgr)
+{
+
+   int32  OsStatus = OS_SUCCESS;
+   uint16 i;
+   
+   for (i=0; (i < PktMgr->WorkerCnt) && (OsStatus == OS_SUCCESS); i++)
+   {
+      OsStatus = OS_SocketOpen(&PktMgr->Worker[i].SockId, OS_SocketDomain_INET, OS_SocketType_DATAGRAM);
+      PktMgr->Worker[i].SockOpen = (OsStatus == OS_SUCCESS);
+   }
+   
+   if (OsStatus != OS_SUCCESS)
+   {
+      
+      CFE_EVS_SendEvent(PKTMGR_TLM_OUTPUT_ENA_SOCKET_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Output worker %d socket open error. Status = %d", i-1, OsStatus);
+      
+      for (i=0; i < PktMgr->WorkerCnt; i++)
+      {
+         if (PktMgr->Worker[i].SockOpen) OS_close(PktMgr->Worker[i].SockId);
+         PktMgr->Worker[i].SockOpen = false;
+      }
+   }
+   
+   return (OsStatus == OS_SUCCESS);
+
+} /* End OpenWorkerSockets() */
+
+
+/******************************************************************************
+** Function: OutputBudgetReached
+**
+** Return true if the number of packets read or the time spent in the current
+** output cycle has reached its configured limit. A limit of zero means no 
+** limit.
+*/
+static bool OutputBudgetReached(PKTMGR_Class_t *PktMgr, uint16 PktsRead, CFE_TIME_SysTime_t StartTime)
+{
+
+   bool BudgetReached = false;
+   
+   if (PktMgr->OutputPktLimit > 0)
+   {
+      BudgetReached = (PktsRead >= PktMgr->OutputPktLimit);
+   }
+   
+   if (!BudgetReached && (PktMgr->OutputTimeLimit > 0))
+   {
+      BudgetReached = (KIT_TO_ElapsedMilliSecs(StartTime) >= PktMgr->OutputTimeLimit);
+   }
+   
+   return BudgetReached;
+
+} /* End OutputBudgetReached() */
+
+
+/******************************************************************************
+** Function: OutputRateLimit
+**
+** Return the output rate limit in bytes/sec, 0 means no limit.
+*/
+static uint32 OutputRateLimit(PKTMGR_Class_t *PktMgr)
+{
+
+   uint32 RateLimit = PktMgr->RateLimit;
+   
+   if (PktMgr->FeedbackEna && ((RateLimit == 0) || (PktMgr->FeedbackRate < RateLimit)))
+   {
+      RateLimit = PktMgr->FeedbackRate;
+   }
+
+   return RateLimit;
+
+} /* End OutputRateLimit() */
+
+
+/******************************************************************************
+** Function: PackEdsOutputMessage
+**
+** Notes:
+**   1. Adopted from NASA"S cfE-eds-framework TO_LAB app
+**
+*/
+static int32 PackEdsOutputMessage(void *DestBuffer, const CFE_MSG_Message_t *SrcBuffer, 
+                                  size_t SrcBufferSize, size_t *EdsDataSize)
+{
+    EdsLib_Id_t                           EdsId;
+    EdsLib_DataTypeDB_TypeInfo_t          TypeInfo;
+    CFE_SB_SoftwareBus_PubSub_Interface_t PubSubParams;
+    CFE_SB_Publisher_Component_t          PublisherParams;
+    uint16                                TopicId;
+    int32                                 Status;
+    size_t                                SrcMsgSize;
+
+    const EdsLib_DatabaseObject_t *EDS_DB = CFE_Config_GetObjPointer(CFE_CONFIGID_MISSION_EDS_DB);
+
+    CFE_MSG_GetSize(SrcBuffer, &SrcMsgSize);
+
+    CFE_MissionLib_Get_PubSub_Parameters(&PubSubParams, &SrcBuffer->BaseMsg);
+    CFE_MissionLib_UnmapPublisherComponent(&PublisherParams, &PubSubParams);
+    TopicId = PublisherParams.Telemetry.TopicId;
+
+    Status = CFE_MissionLib_GetArgumentType(&CFE_SOFTWAREBUS_INTERFACE, CFE_SB_Telemetry_Interface_ID, TopicId, 1, 1,
+                                            &EdsId);
+    if (Status != CFE_MISSIONLIB_SUCCESS)
+    {
+        return CFE_STATUS_UNKNOWN_MSG_ID;
+    }
+
+    Status = EdsLib_DataTypeDB_PackCompleteObject(EDS_DB, &EdsId, DestBuffer, SrcBuffer, 8 * SrcBufferSize,
+                                                  SrcMsgSize);
+    if (Status != EDSLIB_SUCCESS)
+    {
+        return CFE_SB_INTERNAL_ERR;
+    }
+
+    Status = EdsLib_DataTypeDB_GetTypeInfo(EDS_DB, EdsId, &TypeInfo);
+    if (Status != EDSLIB_SUCCESS)
+    {
+        return CFE_SB_INTERNAL_ERR;
+    }
+
+    *EdsDataSize = (TypeInfo.Size.Bits + 7) / 8;
+    
+    return CFE_SUCCESS;
+}
+
+
+/******************************************************************************
+** Function: PipelineDrain
+**
+** Wait until the pack and send stages have sent every packet in the rings.
+** The pack stage pops its input after it pushes its output so both rings
+** are only empty when the send stage is idle. Returns false if a stage
+** exited or the rings didn't drain within WorkerTimeout ms.
+**
+** Notes:
+**   1. Each poll delays at least 1 ms so the wait is bounded by the poll
+**      count rather than timed.
+*/
+static bool PipelineDrain(PKTMGR_Class_t *PktMgr)
+{
+
+   uint32 Waited = 0;
+   PKTMGR_Pipeline_t *Pipe = &PktMgr->Priv.Pipeline;
+   
+   while ((RingCnt(&Pipe->MsgRing) > 0) || (RingCnt(&Pipe->DatagramRing) > 0))
+   {
+      
+      if (__atomic_load_n(&Pipe->PackExited, __ATOMIC_SEQ_CST) ||
+          __atomic_load_n(&Pipe->SendExited, __ATOMIC_SEQ_CST) ||
+          (Waited >= PktMgr->WorkerTimeout))
+      {
+         return false;
+      }
+      
+      OS_TaskDelay(1);
+      ++Waited;
+   
+   }
+   
+   return true;
+
+} /* End PipelineDrain() */
+
+
+/******************************************************************************
+** Function: PipelinePackTask
+**
+** Pack stage child task. Packs each received packet into the send ring and
+** waits when the receive ring is empty or the send ring is full.
+*/
+static void PipelinePackTask(void)
+{
+
+   uint32 MsgSlot;
+   uint32 DatagramSlot;
+   uint16 WorkerIdx;
+   PKTMGR_Class_t        *PktMgr = GetTaskInstance(&WorkerIdx);
+   PKTMGR_Pipeline_t     *Pipe;
+   PKTMGR_PipeMsg_t      *Msg;
+   PKTMGR_PipeDatagram_t *Datagram;
+   
+   if (PktMgr == NULL) return;
+   Pipe = &PktMgr->Priv.Pipeline;
+   OS_BinSemGive(Pipe->StartSem);
+   
+   while (RingWaitForData(&Pipe->MsgRing, &MsgSlot, &Pipe->PackStarveCnt) &&
+          RingWaitForSpace(&Pipe->DatagramRing, &DatagramSlot, &Pipe->PackStallCnt))
+   {
+      
+      Msg      = &PktMgr->Priv.PipeMsg[MsgSlot];
+      Datagram = &PktMgr->Priv.PipeDatagram[DatagramSlot];
+      
+      if (PackEdsOutputMessage(Datagram->Datagram, &Msg->Buf.Msg, sizeof(Datagram->Datagram), &Datagram->DatagramLen) == CFE_SUCCESS)
+      {
+         Datagram->MsgLen     = Msg->MsgLen;
+         Datagram->SocketAddr = Msg->SocketAddr;
+         RingPush(&Pipe->DatagramRing);
+      }
+      else
+      {
+         __atomic_fetch_add(&Pipe->PackErrCnt, 1, __ATOMIC_RELAXED);
+      }
+      
+      RingPop(&Pipe->MsgRing);
+      
+   }
+   
+   CFE_EVS_SendEvent(PKTMGR_PIPELINE_ERR_EID, CFE_EVS_EventType_ERROR,
+                     "Channel %d output pipeline pack stage terminating", PktMgr->Channel);
+   __atomic_store_n(&Pipe->PackExited, true, __ATOMIC_SEQ_CST);
+   CFE_ES_ExitChildTask();
+
+} /* End PipelinePackTask() */
+
+
+/******************************************************************************
+** Function: PipelineReceive
+**
+** Receive stage performed by the app task. Read and filter packets and copy
+** them to the pack stage's ring until the pipe is empty, the output budget
+** is reached or the ring is full.
+**
+** Notes:
+**   1. The ring is checked before a packet is read so a full ring leaves
+**      packets in the pipe for the next cycle rather than blocking the app.
+**   2. A packet that doesn't fit in a ring slot is sent by the app task
+**      after the pipeline drains so its AppId's packets stay in order. If
+**      the pipeline doesn't drain the packet is dropped, the pipeline is
+**      stopped and the app task performs the channel's output.
+*/
+static void PipelineReceive(PKTMGR_Class_t *PktMgr, const OS_SockAddr_t *SocketAddr, uint16 *PktsRead, bool *BudgetReached,
+                            uint16 *PktsSent, uint32 *BytesSent)
+{
+
+   int32   SbStatus = CFE_SUCCESS;
+   size_t  EdsDataSize;
+   PKTMGR_Pipeline_t *Pipe = &PktMgr->Priv.Pipeline;
+   PKTMGR_PipeMsg_t  *Slot;
+   PKTMGR_PktStats_t *Stats;
+
+   CFE_SB_MsgId_t   MsgId;
+   CFE_MSG_Size_t   MsgLen;
+   PKTTBL_Pkt_t     *PktPtr;
+   CFE_SB_Buffer_t  *SbBufPtr;
+   CFE_TIME_SysTime_t StartTime = CFE_TIME_GetTime();
+   
+   while ((SbStatus == CFE_SUCCESS) && !(*BudgetReached))
+   {
+      
+      if (RingCnt(&Pipe->MsgRing) >= PKTMGR_PIPELINE_LEN)
+      {
+         ++PktMgr->PipeRcvStallCnt;
+         break;
+      }
+      
+      SbStatus = CFE_SB_ReceiveBuffer(&SbBufPtr, PktMgr->TlmPipe, CFE_SB_POLL);
+      
+      if (SbStatus == CFE_SUCCESS)
+      {
+         
+         CFE_MSG_GetSize(&SbBufPtr->Msg, &MsgLen);
+         CFE_MSG_GetMsgId(&SbBufPtr->Msg, &MsgId);
+         
+         PktPtr = PKTTBL_GetPkt(&(PktMgr->PktTbl.Data), CFE_SB_MsgIdToValue(MsgId));
+         if (PktPtr != NULL)
+         {
+            Stats = GetPktStats(PktMgr, PktPtr);
+            Stats->Pkts++;
+            Stats->Bytes += MsgLen;
+         }
+         
+         if ((PktPtr != NULL) && PKTTBL_IN_PROFILE(PktPtr, PktMgr->ActiveProfile) &&
+             PktMgr->DownlinkOn && (PktMgr->SuppressSend == false) &&
+             !PktUtil_IsPacketFiltered(&SbBufPtr->Msg, &(PktPtr->Filter)))
+         {
+            
+            if ((PktPtr->MaxAge > 0) && PktExpired(&SbBufPtr->Msg, PktPtr->MaxAge, StartTime))
+            {
+               Stats->StaleDrops++;
+               PktMgr->StaleDropCnt++;
+            }
+            else if (MsgLen <= sizeof(Slot->Buf))
+            {
+               Slot = &PktMgr->Priv.PipeMsg[Pipe->MsgRing.Tail % PKTMGR_PIPELINE_LEN];
+               memcpy(Slot->Buf.Byte, SbBufPtr, MsgLen);
+               Slot->MsgLen     = MsgLen;
+               Slot->SocketAddr = *SocketAddr;
+               RingPush(&Pipe->MsgRing);
+            }
+            else
+            {
+               
+               ++PktMgr->PipeInlineCnt;
+               
+               if (!PipelineDrain(PktMgr))
+               {
+                  ++PktMgr->PipeDropCnt;
+                  StopPipeline(PktMgr, "it didn't drain for a packet too large for a ring slot");
+               }
+               else if (PackEdsOutputMessage(PktMgr->Priv.SocketBuffer, &SbBufPtr->Msg, sizeof(PktMgr->Priv.SocketBuffer), &EdsDataSize) == CFE_SUCCESS)
+               {
+                  SendOrQueueDatagram(PktMgr, PktMgr->Priv.SocketBuffer, EdsDataSize, MsgLen, SocketAddr, PktsSent, BytesSent);
+               }
+               else
+               {
+                  ++PktMgr->PipePackErrCnt;
+               }
+            
+            } /* End if packet too large for a ring slot */
+         } /* End if packet is output */
+         
+         ++(*PktsRead);
+         *BudgetReached = OutputBudgetReached(PktMgr, *PktsRead, StartTime);
+         
+         if (!PktMgr->PipelineEna || (PktMgr->RetryQueueCnt > 0)) break;
+      
+      } /* End if SB received msg */
+      
+   } /* End while pipe not empty */
+
+} /* End PipelineReceive() */
+
+
+/******************************************************************************
+** Function: PipelineSendTask
+**
+** Send stage child task. Sends each packed datagram and waits when the send
+** ring is empty. Datagrams are dropped after a hard socket error until
+** output is enabled again.
+**
+** Notes:
+**   1. A datagram that gets a transient send error stays at the head of the
+**      ring and is resent after a one tick delay. The rings fill behind it
+**      so the receive stage stops reading the pipe, the same backpressure
+**      the app task's retry queue applies.
+*/
+static void PipelineSendTask(void)
+{
+
+   uint32 Slot;
+   int32  SocketStatus;
+   uint16 ErrRun = 0;
+   uint16 WorkerIdx;
+   PKTMGR_Class_t        *PktMgr = GetTaskInstance(&WorkerIdx);
+   PKTMGR_Pipeline_t     *Pipe;
+   PKTMGR_PipeDatagram_t *Datagram;
+   
+   if (PktMgr == NULL) return;
+   Pipe = &PktMgr->Priv.Pipeline;
+   OS_BinSemGive(Pipe->StartSem);
+   
+   while (RingWaitForData(&Pipe->DatagramRing, &Slot, &Pipe->SendStarveCnt))
+   {
+      
+      Datagram = &PktMgr->Priv.PipeDatagram[Slot];
+      
+      if (__atomic_load_n(&Pipe->SendErrStatus, __ATOMIC_RELAXED) == 0)
+      {
+         
+         SocketStatus = SendSocket(PktMgr->TlmSockId, Datagram->Datagram, Datagram->DatagramLen, &Datagram->SocketAddr);
+         
+         if (SocketStatus >= 0)
+         {
+            __atomic_fetch_add(&Pipe->SentPkts, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&Pipe->SentBytes, Datagram->MsgLen, __ATOMIC_RELAXED);
+            ErrRun = 0;
+         }
+         else if (IsTransientSendErr(SocketStatus, &ErrRun))
+         {
+            __atomic_fetch_add(&Pipe->TransientErrs, 1, __ATOMIC_RELAXED);
+            OS_TaskDelay(1);
+            continue;
+         }
+         else
+         {
+            __atomic_store_n(&Pipe->SendErrStatus, SocketStatus, __ATOMIC_RELAXED);
+         }
+      }
+      
+      RingPop(&Pipe->DatagramRing);
+      
+   }
+   
+   CFE_EVS_SendEvent(PKTMGR_PIPELINE_ERR_EID, CFE_EVS_EventType_ERROR,
+                     "Channel %d output pipeline send stage terminating", PktMgr->Channel);
+   __atomic_store_n(&Pipe->SendExited, true, __ATOMIC_SEQ_CST);
+   CFE_ES_ExitChildTask();
+
+} /* End PipelineSendTask() */
+
+
+/******************************************************************************
+** Function: PktExpired
+**
+** Return true if the packet's header time is more than MaxAge milliseconds
+** before Now. Packets time stamped after Now are never expired.
+*/
+static bool PktExpired(const CFE_MSG_Message_t *MsgPtr, uint16 MaxAge, CFE_TIME_SysTime_t Now)
+{
+
+   CFE_TIME_SysTime_t  MsgTime;
+   CFE_TIME_SysTime_t  Age;
+   
+   if (CFE_MSG_GetMsgTime(MsgPtr, &MsgTime) != CFE_SUCCESS) return false;
+   
+   if (CFE_TIME_Compare(MsgTime, Now) != CFE_TIME_A_LT_B) return false;
+   
+   Age = CFE_TIME_Subtract(Now, MsgTime);
+   
+   return (((uint64)Age.Seconds*1000 + CFE_TIME_Sub2MicroSecs(Age.Subseconds)/1000) > MaxAge);
+
+} /* End PktExpired() */
+
+
+/******************************************************************************
+** Function: PktPipe
+**
+** Return the pipe a message ID is subscribed on. With output workers a
+** message ID always maps to the same worker so its packets stay in order.
+*/
+static CFE_SB_PipeId_t PktPipe(PKTMGR_Class_t *PktMgr, uint16 MsgId)
+{
+
+   if (PktMgr->WorkerCnt == 0) return PktMgr->TlmPipe;
+   
+   return PktMgr->Worker[MsgId % PktMgr->WorkerCnt].Pipe;
+
+} /* End PktPipe() */
+
+
+/******************************************************************************
+** Function: PlanPktTbl
+**
+** Report the predicted output of a table that was read by a plan command.
+**
+** Notes:
+**   1. Function signature must match the PKTTBL_PlanNewTbl_t definition
+*/
+static void PlanPktTbl(void *Owner, const PKTTBL_Data_t *NewTbl, const char *Filename)
+{
+
+   PKTMGR_Class_t *PktMgr = (PKTMGR_Class_t *)Owner;
+   PKTMGR_PlanTlm_t *Plan = &(PktMgr->PlanTlm);
+   
+   ComputePlan(PktMgr, NewTbl);
+   
+   CFE_EVS_SendEvent(PKTMGR_PLAN_TBL_EID, 
+                     (Plan->OverBudget ? CFE_EVS_EventType_ERROR : CFE_EVS_EventType_INFORMATION),
+                     "Plan for %s: %d pkts (%d unobserved), %d bytes/sec out of %d in, peak backlog %d, pipe depth %d (rec %d), %d BufLim below rec%s",
+                     Filename, Plan->PktCnt, Plan->UnobservedCnt, (int)Plan->OutBytesPerSec,
+                     (int)Plan->InBytesPerSec, Plan->PeakBacklog, Plan->PipeDepth, Plan->RecPipeDepth,
+                     Plan->BufLimLowCnt, (Plan->OverBudget ? ", exceeds link budget" : ""));
+   
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(Plan->TlmHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(Plan->TlmHeader), true);
+
+} /* End PlanPktTbl() */
+
+
+/******************************************************************************
+** Function: ProcessFeedback
+**
+** Read all pending ground feedback reports and check for a feedback timeout.
+**
+** Notes:
+**   1. A timeout only applies while telemetry is being sent. It drops the
+**      rate to the minimum because a silent receiver may be a saturated link.
+*/
+static void ProcessFeedback(PKTMGR_Class_t *PktMgr)
+{
+
+   int32  RcvLen;
+   uint8  Rpt[sizeof(PKTMGR_FeedbackRpt_t)];
+   
+   while ((RcvLen = OS_SocketRecvFrom(PktMgr->FeedbackSockId, Rpt, sizeof(Rpt), NULL, OS_CHECK)) > 0)
+   {
+      
+      if (RcvLen == sizeof(Rpt))
+      {
+         ProcessFeedbackRpt(PktMgr, Rpt);
+      }
+      else
+      {
+         CFE_EVS_SendEvent(PKTMGR_FEEDBACK_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Ground feedback report length %d isn't the expected %d",
+                           (int)RcvLen, (int)sizeof(Rpt));
+      }
+   }
+   
+   if ((PktMgr->FeedbackTimeout > 0) && !PktMgr->FeedbackTimedOut &&
+       PktMgr->DownlinkOn && !PktMgr->SuppressSend && !PktMgr->HoldOutput)
+   {
+      
+      if (KIT_TO_ElapsedMilliSecs(PktMgr->FeedbackTime) > PktMgr->FeedbackTimeout)
+      {
+         
+         PktMgr->FeedbackTimedOut = true;
+         PktMgr->FeedbackTimeoutCnt++;
+         PktMgr->FeedbackRate = PktMgr->FeedbackMinRate;
+         
+         CFE_EVS_SendEvent(PKTMGR_FEEDBACK_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "No ground feedback for %u ms, output rate reduced to %u bytes/sec",
+                           (unsigned int)PktMgr->FeedbackTimeout, (unsigned int)PktMgr->FeedbackRate);
+      }
+   }
+   
+} /* End ProcessFeedback() */
+
+
+/******************************************************************************
+** Function: ProcessFeedbackRpt
+**
+** Apply one ground feedback report to the AIMD controller.
+**
+** Notes:
+**   1. The rate only increases when the output was rate limited since the
+**      previous report. Otherwise the lack of loss says nothing about the
+**      link's capacity.
+*/
+static void ProcessFeedbackRpt(PKTMGR_Class_t *PktMgr, const uint8 *Rpt)
+{
+
+   uint32  Magic   = ((uint32)Rpt[0] << 24) | ((uint32)Rpt[1] << 16) | ((uint32)Rpt[2] << 8) | Rpt[3];
+   uint32  RcvSeq  = ((uint32)Rpt[4] << 24) | ((uint32)Rpt[5] << 16) | ((uint32)Rpt[6] << 8) | Rpt[7];
+   uint32  LossCnt = ((uint32)Rpt[8] << 24) | ((uint32)Rpt[9] << 16) | ((uint32)Rpt[10] << 8) | Rpt[11];
+   uint32  NewLoss;
+   uint32  PrevRate = PktMgr->FeedbackRate;
+   uint64  Rate;
+   
+   if (Magic != PKTMGR_FEEDBACK_MAGIC)
+   {
+      CFE_EVS_SendEvent(PKTMGR_FEEDBACK_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Ground feedback report magic 0x%08X isn't the expected 0x%08X",
+                        (unsigned int)Magic, PKTMGR_FEEDBACK_MAGIC);
+      return;
+   }
+   
+   PktMgr->FeedbackRptCnt++;
+   PktMgr->FeedbackTime = CFE_TIME_GetTime();
+   if (PktMgr->FeedbackTimedOut)
+   {
+      PktMgr->FeedbackTimedOut = false;
+      CFE_EVS_SendEvent(PKTMGR_FEEDBACK_EID, CFE_EVS_EventType_INFORMATION,
+                        "Ground feedback resumed at receive sequence %u", (unsigned int)RcvSeq);
+   }
+   
+   /* A receiver restart resets the baseline without a rate change */
+   if ((RcvSeq < PktMgr->FeedbackRcvSeq) || (LossCnt < PktMgr->FeedbackLossCnt))
+   {
+      NewLoss = 0;
+   }
+   else
+   {
+      NewLoss = LossCnt - PktMgr->FeedbackLossCnt;
+   }
+   PktMgr->FeedbackRcvSeq  = RcvSeq;
+   PktMgr->FeedbackLossCnt = LossCnt;
+   
+   if (NewLoss > 0)
+   {
+      PktMgr->FeedbackLossSum += NewLoss;
+      Rate = ((uint64)PktMgr->FeedbackRate * PktMgr->FeedbackDecrease)/100;
+      PktMgr->FeedbackRate = (Rate < PktMgr->FeedbackMinRate) ? PktMgr->FeedbackMinRate : (uint32)Rate;
+   }
+   else if (PktMgr->RateLimitCycles != PktMgr->FeedbackLimitCycles)
+   {
+      Rate = (uint64)PktMgr->FeedbackRate + PktMgr->FeedbackIncrease;
+      PktMgr->FeedbackRate = (Rate > PktMgr->FeedbackMaxRate) ? PktMgr->FeedbackMaxRate : (uint32)Rate;
+   }
+   PktMgr->FeedbackLimitCycles = PktMgr->RateLimitCycles;
+   
+   if (PktMgr->FeedbackRate != PrevRate)
+   {
+      CFE_EVS_SendEvent(PKTMGR_FEEDBACK_EID, CFE_EVS_EventType_DEBUG,
+                        "Ground feedback seq %u, %u new losses: output rate %u to %u bytes/sec",
+                        (unsigned int)RcvSeq, (unsigned int)NewLoss,
+                        (unsigned int)PrevRate, (unsigned int)PktMgr->FeedbackRate);
+   }
+
+} /* End ProcessFeedbackRpt() */
+
+
+/******************************************************************************
+** Function: ProfileNameStr
+**
+** Return a profile's name for event messages. Tables without profile names
+** have a single default profile.
+*/
+static const char *ProfileNameStr(const PKTTBL_Data_t *Tbl, uint16 Profile)
+{
+
+   return (Profile < Tbl->ProfileCnt) ? Tbl->ProfileName[Profile] : "default";
+
+} /* End ProfileNameStr() */
+
+
+/******************************************************************************
+** Function: RecorderSend
+**
+** Send the recorder's frozen records that are available in this output
+** cycle.
+**
+** Notes:
+**   1. Sending stops for the cycle when a datagram is queued for retry. 
+**      Records are copied into the retry queue so they remain valid after
+**      recording resumes.
+*/
+static void RecorderSend(PKTMGR_Class_t *PktMgr, const OS_SockAddr_t *SocketAddr, uint16 *PktsSent, uint32 *BytesSent)
+{
+
+   const void *Datagram;
+   uint16     DatagramLen;
+   uint16     MsgLen;
+   
+   while ((PktMgr->SuppressSend == false) && (PktMgr->RetryQueueCnt == 0) &&
+          TLM_REC_ReadTlmDump(PktMgr->TlmRec, &Datagram, &DatagramLen, &MsgLen))
+   {
+      SendDatagram(PktMgr, Datagram, DatagramLen, MsgLen, SocketAddr, PktsSent, BytesSent);
+   }
+   
+} /* End RecorderSend() */
+
+
+/******************************************************************************
+** Function: RefillRateTokens
+**
+** Add the tokens earned since the last refill. The bucket holds at most one
+** second of output so an idle period doesn't allow a large burst.
+*/
+static void RefillRateTokens(PKTMGR_Class_t *PktMgr, uint32 RateLimit)
+{
+
+   uint32 ElapsedMs;
+   int64  Tokens;
+   
+   if (RateLimit == 0) return;
+   
+   ElapsedMs = KIT_TO_ElapsedMilliSecs(PktMgr->RateRefillTime);
+   if (ElapsedMs == 0) return;
+   
+   PktMgr->RateRefillTime = CFE_TIME_GetTime();
+   
+   Tokens = (int64)PktMgr->RateTokens + ((int64)RateLimit*ElapsedMs)/1000;
+   PktMgr->RateTokens = (Tokens > (int64)RateLimit) ? (int32)RateLimit : (int32)Tokens;
+
+} /* End RefillRateTokens() */
+
+
+/******************************************************************************
+** Function: ReorderAdd
+**
+** Hold a packed datagram until it can be sent in packet time order.
+**
+** Notes:
+**   1. A packet older than the last packet released missed the reorder
+**      window. It's counted and sent immediately rather than dropped.
+**   2. When the heap is full the oldest of the held packets and the new
+**      packet is released early.
+**   3. Packets without a valid header time are keyed by the time they're
+**      held.
+*/
+static void ReorderAdd(PKTMGR_Class_t *PktMgr, const void *Datagram, size_t DatagramLen, uint32 MsgLen, const CFE_MSG_Message_t *MsgPtr,
+                       const OS_SockAddr_t *SocketAddr, uint16 *PktsSent, uint32 *BytesSent)
+{
+
+   uint16  Child;
+   uint16  Parent;
+   uint16  EntryIdx;
+   uint64  Key;
+   uint64  ArrivalKey = ReorderKey(CFE_TIME_GetTime());
+   CFE_TIME_SysTime_t MsgTime;
+   PKTMGR_ReorderEntry_t *Entry;
+   
+   Key = (CFE_MSG_GetMsgTime(MsgPtr, &MsgTime) == CFE_SUCCESS) ? ReorderKey(MsgTime) : ArrivalKey;
+   
+   if (Key < PktMgr->Priv.ReorderLastKey)
+   {
+      ++PktMgr->ReorderLateCnt;
+      SendOrQueueDatagram(PktMgr, Datagram, DatagramLen, MsgLen, SocketAddr, PktsSent, BytesSent);
+      return;
+   }
+   
+   if (PktMgr->ReorderCnt >= PKTMGR_REORDER_LEN)
+   {
+      ++PktMgr->ReorderFullCnt;
+      if (Key <= PktMgr->Priv.ReorderEntry[PktMgr->Priv.ReorderHeap[0]].Key)
+      {
+         PktMgr->Priv.ReorderLastKey = Key;
+         SendOrQueueDatagram(PktMgr, Datagram, DatagramLen, MsgLen, SocketAddr, PktsSent, BytesSent);
+         return;
+      }
+      Entry = ReorderPop(PktMgr);
+      SendOrQueueDatagram(PktMgr, &Entry->Datagram, Entry->DatagramLen, Entry->MsgLen, SocketAddr, PktsSent, BytesSent);
+   }
+   
+   EntryIdx = PktMgr->Priv.ReorderHeap[PktMgr->ReorderCnt];
+   Entry    = &PktMgr->Priv.ReorderEntry[EntryIdx];
+   Entry->Key         = Key;
+   Entry->ArrivalKey  = ArrivalKey;
+   Entry->Seq         = PktMgr->Priv.ReorderSeq++;
+   Entry->DatagramLen = DatagramLen;
+   Entry->MsgLen      = MsgLen;
+   memcpy(&Entry->Datagram, Datagram, DatagramLen);
+   
+   Child = PktMgr->ReorderCnt++;
+   while (Child > 0)
+   {
+      Parent = (Child - 1)/2;
+      if (!ReorderBefore(PktMgr, EntryIdx, PktMgr->Priv.ReorderHeap[Parent])) break;
+      PktMgr->Priv.ReorderHeap[Child] = PktMgr->Priv.ReorderHeap[Parent];
+      Child = Parent;
+   }
+   PktMgr->Priv.ReorderHeap[Child] = EntryIdx;
+   
+} /* End ReorderAdd() */
+
+
+/******************************************************************************
+** Function: ReorderBefore
+**
+** Return true if entry A is released before entry B.
+*/
+static bool ReorderBefore(PKTMGR_Class_t *PktMgr, uint16 EntryA, uint16 EntryB)
+{
+
+   const PKTMGR_ReorderEntry_t *A = &PktMgr->Priv.ReorderEntry[EntryA];
+   const PKTMGR_ReorderEntry_t *B = &PktMgr->Priv.ReorderEntry[EntryB];
+   
+   if (A->Key != B->Key) return (A->Key < B->Key);
+   
+   return ((int32)(A->Seq - B->Seq) < 0);
+
+} /* End ReorderBefore() */
+
+
+/******************************************************************************
+** Function: ReorderClear
+**
+** Discard held packets and free all heap entries.
+*/
+static void ReorderClear(PKTMGR_Class_t *PktMgr)
+{
+
+   uint16 i;
+   
+   for (i=0; i < PKTMGR_REORDER_LEN; i++)
+   {
+      PktMgr->Priv.ReorderHeap[i] = i;
+   }
+   PktMgr->ReorderCnt = 0;
+   PktMgr->Priv.ReorderLastKey = 0;
+
+} /* End ReorderClear() */
+
+
+/******************************************************************************
+** Function: ReorderKey
+**
+*/
+static uint64 ReorderKey(CFE_TIME_SysTime_t Time)
+{
+
+   return (((uint64)Time.Seconds << 32) | Time.Subseconds);
+
+} /* End ReorderKey() */
+
+
+/******************************************************************************
+** Function: ReorderPop
+**
+** Remove the oldest held packet from the heap and return its entry. The
+** entry is valid until the next ReorderAdd().
+*/
+static PKTMGR_ReorderEntry_t *ReorderPop(PKTMGR_Class_t *PktMgr)
+{
+
+   uint16  EntryIdx = PktMgr->Priv.ReorderHeap[0];
+   uint16  LastIdx;
+   uint16  Parent = 0;
+   uint16  Child;
+   
+   LastIdx = PktMgr->Priv.ReorderHeap[--PktMgr->ReorderCnt];
+   
+   while ((Child = 2*Parent + 1) < PktMgr->ReorderCnt)
+   {
+      if (((Child + 1) < PktMgr->ReorderCnt) && ReorderBefore(PktMgr, PktMgr->Priv.ReorderHeap[Child+1], PktMgr->Priv.ReorderHeap[Child]))
+      {
+         ++Child;
+      }
+      if (!ReorderBefore(PktMgr, PktMgr->Priv.ReorderHeap[Child], LastIdx)) break;
+      PktMgr->Priv.ReorderHeap[Parent] = PktMgr->Priv.ReorderHeap[Child];
+      Parent = Child;
+   }
+   PktMgr->Priv.ReorderHeap[Parent] = LastIdx;
+   
+   /* The released entry becomes the first free entry */
+   PktMgr->Priv.ReorderHeap[PktMgr->ReorderCnt] = EntryIdx;
+   PktMgr->Priv.ReorderLastKey = PktMgr->Priv.ReorderEntry[EntryIdx].Key;
+   
+   return &PktMgr->Priv.ReorderEntry[EntryIdx];
+   
+} /* End ReorderPop() */
+
+
+/******************************************************************************
+** Function: ReorderRelease
+**
+** Send held packets, oldest first, whose header time or hold time is at
+** least the reorder window before the current time.
+**
+** Notes:
+**   1. The hold time check bounds the delay of packets with header times
+**      ahead of the current time.
+*/
+static void ReorderRelease(PKTMGR_Class_t *PktMgr, const OS_SockAddr_t *SocketAddr, uint16 *PktsSent, uint32 *BytesSent)
+{
+
+   uint64  NowKey = ReorderKey(CFE_TIME_GetTime());
+   PKTMGR_ReorderEntry_t *Entry;
+   
+   while ((PktMgr->ReorderCnt > 0) && (PktMgr->SuppressSend == false))
+   {
+      
+      Entry = &PktMgr->Priv.ReorderEntry[PktMgr->Priv.ReorderHeap[0]];
+      
+      if (((Entry->Key + PktMgr->Priv.ReorderWindowKey) > NowKey) && ((Entry->ArrivalKey + PktMgr->Priv.ReorderWindowKey) > NowKey)) break;
+      
+      Entry = ReorderPop(PktMgr);
+      SendOrQueueDatagram(PktMgr, &Entry->Datagram, Entry->DatagramLen, Entry->MsgLen, SocketAddr, PktsSent, BytesSent);
+   
+   } /* End while packets due */
+   
+} /* End ReorderRelease() */
+
+
+/******************************************************************************
+** Function: RetryQueueAdd
+**
+** Append a datagram to the retry queue. When the queue is full the oldest
+** datagram is dropped and counted. Returns true if a datagram was dropped.
+**
+** Notes:
+**   1. The telemetry pipe drain stops for the cycle when the queue is full
+**      so the backlog stays in the SB pipe. A datagram can still arrive at
+**      a full queue when coalesced or reordered packets are released at
+**      the end of a cycle. Dropping from the head keeps the remaining
+**      datagrams in order and keeps the newest data.
+*/
+static bool RetryQueueAdd(PKTMGR_Class_t *PktMgr, const void *Datagram, size_t DatagramLen, uint32 MsgLen)
+{
+   
+   bool   Dropped = false;
+   uint16 Tail;
+   
+   if (PktMgr->RetryQueueCnt >= PKTMGR_RETRY_QUEUE_LEN)
+   {
+      PktMgr->RetryQueueHead = (PktMgr->RetryQueueHead + 1) % PKTMGR_RETRY_QUEUE_LEN;
+      --PktMgr->RetryQueueCnt;
+      ++PktMgr->RetryDropCnt;
+      Dropped = true;
+   }
+   
+   Tail = (PktMgr->RetryQueueHead + PktMgr->RetryQueueCnt) % PKTMGR_RETRY_QUEUE_LEN;
+
+   PktMgr->Priv.RetryQueue[Tail].DatagramLen = DatagramLen;
+   PktMgr->Priv.RetryQueue[Tail].MsgLen      = MsgLen;
+   memcpy(&PktMgr->Priv.RetryQueue[Tail].Datagram, Datagram, DatagramLen);
+   ++PktMgr->RetryQueueCnt;
+   
+   return Dropped;
+   
+} /* End RetryQueueAdd() */
+
+
+/******************************************************************************
+** Function: RetryQueueClear
+**
+** Discard datagrams waiting for a retry, including the datagram held by
+** each output worker.
+*/
+static void RetryQueueClear(PKTMGR_Class_t *PktMgr)
+{
+
+   uint16 i;
+   
+   PktMgr->RetryQueueHead = 0;
+   PktMgr->RetryQueueCnt  = 0;
+   
+   for (i=0; i < PktMgr->WorkerCnt; i++)
+   {
+      PktMgr->Worker[i].RetryLen = 0;
+   }
+
+} /* End RetryQueueClear() */
+
+
+/******************************************************************************
+** Function: RetryQueueSend
+**
+** Notes:
+**   1. Datagrams are sent oldest first until the queue is empty or a send
+**      fails. A failed datagram remains at the head of the queue.
+*/
+static int32 RetryQueueSend(PKTMGR_Class_t *PktMgr, const OS_SockAddr_t *SocketAddr, uint16 *PktsSent, uint32 *BytesSent)
+{
+   
+   int32  SocketStatus = 0;
+   PKTMGR_RetryEntry_t *Entry;
+   
+   while ((PktMgr->RetryQueueCnt > 0) && (SocketStatus >= 0))
+   {
+      
+      Entry = &PktMgr->Priv.RetryQueue[PktMgr->RetryQueueHead];
+      
+      SocketStatus = SendSocket(PktMgr->TlmSockId, &Entry->Datagram, Entry->DatagramLen, SocketAddr);
+      
+      if (SocketStatus >= 0)
+      {
+         PktMgr->RetryQueueHead = (PktMgr->RetryQueueHead + 1) % PKTMGR_RETRY_QUEUE_LEN;
+         --PktMgr->RetryQueueCnt;
+         ++(*PktsSent);
+         *BytesSent += Entry->MsgLen;
+         PktMgr->SendErrRun = 0;
+      }
+      else if (IsTransientSendErr(SocketStatus, &PktMgr->SendErrRun))
+      {
+         ++PktMgr->SendTransientErrCnt;
+      }
+      else
+      {
+         CFE_EVS_SendEvent(PKTMGR_SOCKET_SEND_ERR_EID,CFE_EVS_EventType_ERROR,
+                           "Error resending packet on socket %s, port %d, status %d. Tlm output suppressed\n",
+                           PktMgr->TlmDestIp, PktMgr->TlmUdpPort, SocketStatus);
+         PktMgr->SuppressSend = true;
+      }
+      
+   } /* End while queue not empty */
+   
+   return SocketStatus;
+   
+} /* End RetryQueueSend() */
+
+
+/******************************************************************************
+** Function: RingCnt
+**
+** Return the number of ring slots in use. Sequentially consistent loads
+** pair with the waiting flags, see RingWaitForData().
+*/
+static uint32 RingCnt(PKTMGR_Ring_t *Ring)
+{
+
+   return __atomic_load_n(&Ring->Tail, __ATOMIC_SEQ_CST) - __atomic_load_n(&Ring->Head, __ATOMIC_SEQ_CST);
+
+} /* End RingCnt() */
+
+
+/******************************************************************************
+** Function: RingPop
+**
+** Consumer releases the slot at Head and wakes a waiting producer.
+*/
+static void RingPop(PKTMGR_Ring_t *Ring)
+{
+
+   __atomic_store_n(&Ring->Head, Ring->Head + 1, __ATOMIC_SEQ_CST);
+   
+   if (__atomic_exchange_n(&Ring->ProducerWaiting, false, __ATOMIC_SEQ_CST))
+   {
+      OS_BinSemGive(Ring->SpaceSem);
+   }
+
+} /* End RingPop() */
+
+
+/******************************************************************************
+** Function: RingPush
+**
+** Producer publishes the slot at Tail, updates the peak occupancy and wakes
+** a waiting consumer.
+*/
+static void RingPush(PKTMGR_Ring_t *Ring)
+{
+
+   uint32 Cnt;
+   
+   __atomic_store_n(&Ring->Tail, Ring->Tail + 1, __ATOMIC_SEQ_CST);
+   
+   Cnt = RingCnt(Ring);
+   if (Cnt > __atomic_load_n(&Ring->Peak, __ATOMIC_RELAXED))
+   {
+      __atomic_store_n(&Ring->Peak, Cnt, __ATOMIC_RELAXED);
+   }
+   
+   if (__atomic_exchange_n(&Ring->ConsumerWaiting, false, __ATOMIC_SEQ_CST))
+   {
+      OS_BinSemGive(Ring->DataSem);
+   }
+
+} /* End RingPush() */
+
+
+/******************************************************************************
+** Function: RingWaitForData
+**
+** Consumer waits until the ring has a slot to read and returns its index.
+** Returns false if the wait fails.
+**
+** Notes:
+**   1. The waiting flag is set before the ring is rechecked. A producer that
+**      pushes after the recheck sees the flag and gives the semaphore, so a
+**      push can't be missed. A stale give only causes an extra recheck.
+*/
+static bool RingWaitForData(PKTMGR_Ring_t *Ring, uint32 *Slot, uint32 *StarveCnt)
+{
+
+   if (RingCnt(Ring) == 0)
+   {
+      
+      __atomic_fetch_add(StarveCnt, 1, __ATOMIC_RELAXED);
+      
+      __atomic_store_n(&Ring->ConsumerWaiting, true, __ATOMIC_SEQ_CST);
+      while (RingCnt(Ring) == 0)
+      {
+         if (OS_BinSemTake(Ring->DataSem) != OS_SUCCESS) return false;
+         __atomic_store_n(&Ring->ConsumerWaiting, true, __ATOMIC_SEQ_CST);
+      }
+      __atomic_store_n(&Ring->ConsumerWaiting, false, __ATOMIC_SEQ_CST);
+   
+   }
+   
+   *Slot = Ring->Head % PKTMGR_PIPELINE_LEN;
+   
+   return true;
+
+} /* End RingWaitForData() */
+
+
+/******************************************************************************
+** Function: RingWaitForSpace
+**
+** Producer waits until the ring has a free slot and returns its index.
+** Returns false if the wait fails. See RingWaitForData().
+*/
+static bool RingWaitForSpace(PKTMGR_Ring_t *Ring, uint32 *Slot, uint32 *StallCnt)
+{
+
+   if (RingCnt(Ring) >= PKTMGR_PIPELINE_LEN)
+   {
+      
+      __atomic_fetch_add(StallCnt, 1, __ATOMIC_RELAXED);
+      
+      __atomic_store_n(&Ring->ProducerWaiting, true, __ATOMIC_SEQ_CST);
+      while (RingCnt(Ring) >= PKTMGR_PIPELINE_LEN)
+      {
+         if (OS_BinSemTake(Ring->SpaceSem) != OS_SUCCESS) return false;
+         __atomic_store_n(&Ring->ProducerWaiting, true, __ATOMIC_SEQ_CST);
+      }
+      __atomic_store_n(&Ring->ProducerWaiting, false, __ATOMIC_SEQ_CST);
+   
+   }
+   
+   *Slot = Ring->Tail % PKTMGR_PIPELINE_LEN;
+   
+   return true;
+
+} /* End RingWaitForSpace() */
+
+
+/******************************************************************************
+** Function: RunPipeline
+**
+** Perform the receive stage of an output cycle and merge the pack and send
+** stage results since the previous cycle.
+**
+** Notes:
+**   1. The send stage's output lags the receive stage so the rate limit
+**      tokens are charged for the bytes sent since the previous cycle.
+**   2. A packet too large for a ring slot is sent by the app task and held
+**      in the retry queue on a transient error. The pipe isn't read until
+**      the retry queue is empty so packet order is preserved.
+*/
+static uint16 RunPipeline(PKTMGR_Class_t *PktMgr, uint32 RateLimit, bool RateLimited)
+{
+
+   bool    BudgetReached  = false;
+   uint16  NumPktsRead    = 0;
+   uint16  NumPktsOutput  = 0;
+   uint32  NumBytesOutput = 0;
+   int32   SendErrStatus;
+   OS_SockAddr_t      SocketAddr;
+   PKTMGR_Pipeline_t *Pipe = &PktMgr->Priv.Pipeline;
+   
+   if (!RateLimited)
+   {
+      
+      OS_SocketAddrInit(&SocketAddr, OS_SocketDomain_INET);
+      OS_SocketAddrFromString(&SocketAddr, PktMgr->TlmDestIp);
+      OS_SocketAddrSetPort(&SocketAddr, PktMgr->TlmUdpPort);
+      
+      if (PktMgr->DownlinkOn && (PktMgr->SuppressSend == false) && (PktMgr->RetryQueueCnt > 0))
+      {
+         RetryQueueSend(PktMgr, &SocketAddr, &NumPktsOutput, &NumBytesOutput);
+      }
+      
+      if (PktMgr->RetryQueueCnt == 0)
+      {
+         PipelineReceive(PktMgr, &SocketAddr, &NumPktsRead, &BudgetReached, &NumPktsOutput, &NumBytesOutput);
+      }
+   
+   }
+   
+   NumPktsOutput  += CounterDelta(&Pipe->SentPkts, &Pipe->PrevSentPkts);
+   NumBytesOutput += CounterDelta(&Pipe->SentBytes, &Pipe->PrevSentBytes);
+   PktMgr->SendTransientErrCnt += CounterDelta(&Pipe->TransientErrs, &Pipe->PrevTransientErrs);
+   PktMgr->PipePackStarveCnt   += CounterDelta(&Pipe->PackStarveCnt, &Pipe->PrevPackStarveCnt);
+   PktMgr->PipePackStallCnt    += CounterDelta(&Pipe->PackStallCnt,  &Pipe->PrevPackStallCnt);
+   PktMgr->PipeSendStarveCnt   += CounterDelta(&Pipe->SendStarveCnt, &Pipe->PrevSendStarveCnt);
+   PktMgr->PipePackErrCnt      += CounterDelta(&Pipe->PackErrCnt,    &Pipe->PrevPackErrCnt);
+   
+   PktMgr->PipeMsgCnt       = RingCnt(&Pipe->MsgRing);
+   PktMgr->PipeMsgPeak      = __atomic_load_n(&Pipe->MsgRing.Peak, __ATOMIC_RELAXED);
+   PktMgr->PipeDatagramCnt  = RingCnt(&Pipe->DatagramRing);
+   PktMgr->PipeDatagramPeak = __atomic_load_n(&Pipe->DatagramRing.Peak, __ATOMIC_RELAXED);
+   
+   SendErrStatus = __atomic_load_n(&Pipe->SendErrStatus, __ATOMIC_RELAXED);
+   if ((SendErrStatus != 0) && (PktMgr->SuppressSend == false))
+   {
+      CFE_EVS_SendEvent(PKTMGR_SOCKET_SEND_ERR_EID,CFE_EVS_EventType_ERROR,
+                        "Error sending packet on socket %s, port %d, status %d. Tlm output suppressed\n",
+                        PktMgr->TlmDestIp, PktMgr->TlmUdpPort, (int)SendErrStatus);
+      PktMgr->SuppressSend = true;
+   }
+   
+   if (BudgetReached) ++PktMgr->OutputBoundCycles;
+   if (RateLimited)   ++PktMgr->RateLimitCycles;
+   if (RateLimit > 0) PktMgr->RateTokens -= (int32)NumBytesOutput;
+   PktMgr->OutputPktsRead = NumPktsRead;
+   
+   ComputeStats(PktMgr, NumPktsOutput, NumBytesOutput);
+
+   return NumPktsOutput;
+
+} /* End RunPipeline() */
+
+
+/******************************************************************************
+** Function: RunWorkers
+**
+** Perform an output cycle with the output workers and merge their results.
+**
+** Notes:
+**   1. The workers only run while this function waits for them so they can
+**      read the packet table and PktMgr state without locks. Each worker
+**      only updates the PktStats[] entries of its own message IDs.
+**   2. Workers don't check the rate limit. A cycle's output can exceed the
+**      available tokens and the deficit delays the next cycle.
+**   3. Workers check the time limit after each packet so the join waits up
+**      to WorkerTimeout ms longer for a send in progress. A worker that
+**      misses the join deadline is considered dead. Only the results of the
+**      workers that finished are merged and the workers are stopped.
+*/
+static uint16 RunWorkers(PKTMGR_Class_t *PktMgr, uint32 RateLimit, bool RateLimited)
+{
 
-      if (PktMgr->PktTbl.Data.Pkt[AppId].MsgId != PKTTBL_UNUSED_MSG_ID) {
+   uint16  i;
+   uint16  JoinCnt;
+   uint32  ElapsedMs;
+   uint32  JoinTimeout    = PktMgr->OutputTimeLimit + PktMgr->WorkerTimeout;
+   int32   OsStatus       = OS_SUCCESS;
+   bool    BudgetReached  = false;
+   uint16  NumPktsRead    = 0;
+   uint16  NumPktsOutput  = 0;
+   uint32  NumBytesOutput = 0;
+   PKTMGR_Worker_t    *Worker;
+   CFE_TIME_SysTime_t StartTime = CFE_TIME_GetTime();
+   
+   if (!RateLimited)
+   {
+      
+      OS_SocketAddrInit(&PktMgr->Priv.WorkerAddr, OS_SocketDomain_INET);
+      OS_SocketAddrFromString(&PktMgr->Priv.WorkerAddr, PktMgr->TlmDestIp);
+      OS_SocketAddrSetPort(&PktMgr->Priv.WorkerAddr, PktMgr->TlmUdpPort);
+      
+      for (i=0; i < PktMgr->WorkerCnt; i++)
+      {
+         OS_BinSemGive(PktMgr->Worker[i].WakeSem);
+      }
+      for (JoinCnt=0; JoinCnt < PktMgr->WorkerCnt; JoinCnt++)
+      {
+         ElapsedMs = KIT_TO_ElapsedMilliSecs(StartTime);
+         OsStatus  = OS_BinSemTimedWait(PktMgr->Worker[JoinCnt].DoneSem, 
+                                        (ElapsedMs < JoinTimeout) ? (JoinTimeout - ElapsedMs) : 0);
+         if (OsStatus != OS_SUCCESS) break;
+      }
+      PktMgr->WorkerCycleMs = KIT_TO_ElapsedMilliSecs(StartTime);
+      
+      for (i=0; i < JoinCnt; i++)
+      {
          
-         ++PktCnt;
-         Status = SubscribeNewPkt(&(PktMgr->PktTbl.Data.Pkt[AppId])); 
-
-         if(Status != CFE_SUCCESS) {
-            
-            ++FailedSubscription;
-            CFE_EVS_SendEvent(PKTMGR_LOAD_TBL_SUBSCRIBE_ERR_EID,CFE_EVS_EventType_ERROR,
-                              "Error subscribing to message ID 0x%04X, BufLim %d, Status %i",
-                              PktMgr->PktTbl.Data.Pkt[AppId].MsgId, 
-                              PktMgr->PktTbl.Data.Pkt[AppId].BufLim, Status);
+         Worker = &PktMgr->Worker[i];
+         
+         NumPktsRead    += Worker->PktsRead;
+         NumPktsOutput  += Worker->PktsSent;
+         NumBytesOutput += Worker->BytesSent;
+         BudgetReached  |= Worker->BudgetReached;
+         Worker->PktCnt += Worker->PktsSent;
+         
+         PktMgr->StaleDropCnt        += Worker->StaleDrops;
+         PktMgr->SendTransientErrCnt += Worker->TransientErrs;
+         
+         if ((Worker->SendErrStatus != 0) && (PktMgr->SuppressSend == false))
+         {
+            CFE_EVS_SendEvent(PKTMGR_SOCKET_SEND_ERR_EID,CFE_EVS_EventType_ERROR,
+                              "Error sending packet on socket %s, port %d, worker %d, status %d. Tlm output suppressed\n",
+                              PktMgr->TlmDestIp, PktMgr->TlmUdpPort, i, (int)Worker->SendErrStatus);
+            PktMgr->SuppressSend = true;
          }
+      
+      } /* End worker loop */
+   
+      if (OsStatus != OS_SUCCESS)
+      {
+         StopWorkers(PktMgr, JoinCnt, JoinTimeout);
+         BudgetReached = true;
       }
+      
+   } /* End if not rate limited */
+   
+   if (BudgetReached) ++PktMgr->OutputBoundCycles;
+   if (RateLimited)   ++PktMgr->RateLimitCycles;
+   if (RateLimit > 0) PktMgr->RateTokens -= (int32)NumBytesOutput;
+   PktMgr->OutputPktsRead = NumPktsRead;
+   
+   ComputeStats(PktMgr, NumPktsOutput, NumBytesOutput);
 
-   } /* End pkt loop */
+   return NumPktsOutput;
 
-   if (FailedSubscription == 0) {
-      
-      PKTMGR_InitStats(INITBL_GetIntConfig(PktMgr->IniTbl, CFG_APP_RUN_LOOP_DELAY),
-                       INITBL_GetIntConfig(PktMgr->IniTbl, CFG_PKTMGR_STATS_INIT_DELAY));
-      CFE_EVS_SendEvent(PKTMGR_LOAD_TBL_INFO_EID, CFE_EVS_EventType_INFORMATION,
-                        "Successfully loaded new table with %d packets", PktCnt);
-   }
-   else {
-      
-      RetStatus = false;
-      CFE_EVS_SendEvent(PKTMGR_LOAD_TBL_ERR_EID, CFE_EVS_EventType_INFORMATION,
-                        "Attempted to load new table with %d packets. Failed %d subscriptions",
-                        PktCnt, FailedSubscription);
+} /* End RunWorkers() */
+
+
+/******************************************************************************
+** Function: SaveCdsImage
+**
+** Copy the active packet table, profile and output destination to the CDS. 
+*/
+static void SaveCdsImage(PKTMGR_Class_t *PktMgr)
+{
+
+   uint16 i;
+   PKTTBL_Data_t *Tbl = &(PktMgr->PktTbl.Data);
+   
+   if (!PktMgr->CdsValid) return;
+   
+   PktMgr->Priv.CdsImage.Version        = PKTMGR_CDS_VERSION;
+   PktMgr->Priv.CdsImage.PktCnt         = Tbl->ActiveCnt;
+   PktMgr->Priv.CdsImage.Crc            = 0;
+   PktMgr->Priv.CdsImage.DownlinkOn     = PktMgr->DownlinkOn;
+   PktMgr->Priv.CdsImage.ActiveProfile  = PktMgr->ActiveProfile;
+   strncpy(PktMgr->Priv.CdsImage.TlmDestIp, PktMgr->TlmDestIp, PKTMGR_IP_STR_LEN);
+   PktMgr->Priv.CdsImage.ProfileCnt     = Tbl->ProfileCnt;
+   PktMgr->Priv.CdsImage.SuppressSend   = PktMgr->SuppressSend;
+   PktMgr->Priv.CdsImage.Spare          = 0;
+   memcpy(PktMgr->Priv.CdsImage.ProfileName, Tbl->ProfileName, sizeof(PktMgr->Priv.CdsImage.ProfileName));
+   
+   for (i=0; i < Tbl->ActiveCnt; i++)
+   {
+      PKTTBL_PackBinPkt(&PktMgr->Priv.CdsImage.Pkt[i], &(Tbl->Pkt[Tbl->ActiveIdx[i]]));
    }
+   
+   PktMgr->Priv.CdsImage.Crc = CFE_ES_CalculateCRC(&PktMgr->Priv.CdsImage, offsetof(PKTMGR_CdsImage_t, Pkt) + PktMgr->Priv.CdsImage.PktCnt*sizeof(PKTTBL_BinPkt_t), 
+                                      0, CFE_MISSION_ES_DEFAULT_CRC);
+   
+   CFE_ES_CopyToCDS(PktMgr->CdsHandle, &PktMgr->Priv.CdsImage);
 
-   return RetStatus;
+} /* End SaveCdsImage() */
 
-} /* End LoadPktTbl() */
+
+/******************************************************************************
+** Function: SendDatagram
+**
+** Send a packed datagram and classify send failures.
+**
+** Notes:
+**   1. Transient failures queue the datagram for retry on the next cycle.
+**   2. Hard failures suppress telemetry output until it is re-enabled by
+**      command.
+*/
+static int32 SendDatagram(PKTMGR_Class_t *PktMgr, const void *Datagram, size_t DatagramLen, uint32 MsgLen,
+                          const OS_SockAddr_t *SocketAddr, uint16 *PktsSent, uint32 *BytesSent)
+{
+   
+   int32 SocketStatus;
+   
+   SocketStatus = SendSocket(PktMgr->TlmSockId, Datagram, DatagramLen, SocketAddr);
+
+   if (SocketStatus >= 0)
+   {
+      ++(*PktsSent);
+      *BytesSent += MsgLen;
+      PktMgr->SendErrRun = 0;
+   }
+   else if (IsTransientSendErr(SocketStatus, &PktMgr->SendErrRun))
+   {
+      
+      ++PktMgr->SendTransientErrCnt;
+      RetryQueueAdd(PktMgr, Datagram, DatagramLen, MsgLen);
+      
+      CFE_EVS_SendEvent(PKTMGR_SOCKET_SEND_RETRY_EID,CFE_EVS_EventType_DEBUG,
+                        "Transient error sending packet on socket %s, port %d, status %d. Packet queued for retry",
+                        PktMgr->TlmDestIp, PktMgr->TlmUdpPort, SocketStatus);
+   }
+   else
+   {
+      CFE_EVS_SendEvent(PKTMGR_SOCKET_SEND_ERR_EID,CFE_EVS_EventType_ERROR,
+                        "Error sending packet on socket %s, port %d, status %d. Tlm output suppressed\n",
+                        PktMgr->TlmDestIp, PktMgr->TlmUdpPort, SocketStatus);
+      PktMgr->SuppressSend = true;
+   }
+   
+   return SocketStatus;
+   
+} /* End SendDatagram() */
 
 
 /******************************************************************************
-** Function: PackEdsOutputMessage
+** Function: SendSocket
+**
+** Send a datagram without blocking. Returns OS_ERROR_TIMEOUT without
+** sending when the socket's send buffer is full, otherwise the
+** OS_SocketSendTo() status.
 **
 ** Notes:
-**   1. Adopted from NASA"S cfE-eds-framework TO_LAB app
+**   1. The writable check makes every send non-blocking whatever mode the
+**      OSAL implementation opened the socket in. An implementation without
+**      select support sends directly.
+*/
+static int32 SendSocket(osal_id_t SockId, const void *Datagram, size_t DatagramLen, const OS_SockAddr_t *SocketAddr)
+{
+
+   uint32 StateFlags = OS_STREAM_STATE_WRITABLE;
+   int32  Status;
+   
+   Status = OS_SelectSingle(SockId, &StateFlags, 0);
+   
+   if ((Status == OS_SUCCESS) && ((StateFlags & OS_STREAM_STATE_WRITABLE) == 0))
+   {
+      Status = OS_ERROR_TIMEOUT;
+   }
+   
+   if ((Status == OS_SUCCESS) || (Status == OS_ERR_NOT_IMPLEMENTED))
+   {
+      Status = OS_SocketSendTo(SockId, Datagram, DatagramLen, SocketAddr);
+   }
+   
+   return Status;
+
+} /* End SendSocket() */
+
+
+/******************************************************************************
+** Function: SendOrQueueDatagram
 **
+** Send a packed datagram unless datagrams are waiting for a retry, in which
+** case it's queued behind them to preserve packet order.
 */
-static int32 PackEdsOutputMessage(void *DestBuffer, const CFE_MSG_Message_t *SrcBuffer, 
-                                  size_t SrcBufferSize, size_t *EdsDataSize)
+static void SendOrQueueDatagram(PKTMGR_Class_t *PktMgr, const void *Datagram, size_t DatagramLen, uint32 MsgLen,
+                                const OS_SockAddr_t *SocketAddr, uint16 *PktsSent, uint32 *BytesSent)
 {
-    EdsLib_Id_t                           EdsId;
-    EdsLib_DataTypeDB_TypeInfo_t          TypeInfo;
-    CFE_SB_SoftwareBus_PubSub_Interface_t PubSubParams;
-    CFE_SB_Publisher_Component_t          PublisherParams;
-    uint16                                TopicId;
-    int32                                 Status;
-    size_t                                SrcMsgSize;
 
-    const EdsLib_DatabaseObject_t *EDS_DB = CFE_Config_GetObjPointer(CFE_CONFIGID_MISSION_EDS_DB);
+   if (PktMgr->RetryQueueCnt > 0)
+   {
+      RetryQueueAdd(PktMgr, Datagram, DatagramLen, MsgLen);
+   }
+   else
+   {
+      SendDatagram(PktMgr, Datagram, DatagramLen, MsgLen, SocketAddr, PktsSent, BytesSent);
+   }
 
-    CFE_MSG_GetSize(SrcBuffer, &SrcMsgSize);
+} /* End SendOrQueueDatagram() */
 
-    CFE_MissionLib_Get_PubSub_Parameters(&PubSubParams, &SrcBuffer->BaseMsg);
-    CFE_MissionLib_UnmapPublisherComponent(&PublisherParams, &PubSubParams);
-    TopicId = PublisherParams.Telemetry.TopicId;
 
-    Status = CFE_MissionLib_GetArgumentType(&CFE_SOFTWAREBUS_INTERFACE, CFE_SB_Telemetry_Interface_ID, TopicId, 1, 1,
-                                            &EdsId);
-    if (Status != CFE_MISSIONLIB_SUCCESS)
-    {
-        return CFE_STATUS_UNKNOWN_MSG_ID;
-    }
+/******************************************************************************
+** Function: SnapshotSend
+**
+** Send up to SnapshotPkts cached datagrams, resuming where the previous
+** output cycle stopped.
+**
+** Notes:
+**   1. Entries are sent in active index order. Entries without a cached
+**      value or outside the active profile are skipped and not counted.
+**   2. Sending stops for the cycle when a datagram is queued for retry so
+**      the snapshot doesn't overrun the retry queue.
+*/
+static void SnapshotSend(PKTMGR_Class_t *PktMgr, const OS_SockAddr_t *SocketAddr, uint16 *PktsSent, uint32 *BytesSent)
+{
 
-    Status = EdsLib_DataTypeDB_PackCompleteObject(EDS_DB, &EdsId, DestBuffer, SrcBuffer, 8 * SrcBufferSize,
-                                                  SrcMsgSize);
-    if (Status != EDSLIB_SUCCESS)
-    {
-        return CFE_SB_INTERNAL_ERR;
-    }
+   uint16  Slot;
+   uint16  SentCnt = 0;
+   PKTMGR_LvcEntry_t *Entry;
+   PKTTBL_Data_t     *Tbl = &(PktMgr->PktTbl.Data);
+   
+   while ((PktMgr->SnapshotIdx < Tbl->ActiveCnt) && (PktMgr->SuppressSend == false) &&
+          (PktMgr->RetryQueueCnt == 0) &&
+          ((PktMgr->SnapshotPkts == 0) || (SentCnt < PktMgr->SnapshotPkts)))
+   {
+      
+      Slot  = Tbl->ActiveIdx[PktMgr->SnapshotIdx++];
+      Entry = &PktMgr->Priv.LvcEntry[Slot];
+      
+      if ((Entry->MsgId == Tbl->Pkt[Slot].MsgId) && PKTTBL_IN_PROFILE(&(Tbl->Pkt[Slot]), PktMgr->ActiveProfile))
+      {
+         SendDatagram(PktMgr, &PktMgr->Priv.LvcPool[Entry->Offset], Entry->Len, Entry->MsgLen, SocketAddr,
+                      PktsSent, BytesSent);
+         ++SentCnt;
+      }
+   
+   } /* End while snapshot entries */
+   
+   PktMgr->SnapshotSentCnt += SentCnt;
+   
+   if (PktMgr->SnapshotIdx >= Tbl->ActiveCnt)
+   {
+      PktMgr->SnapshotActive = false;
+      CFE_EVS_SendEvent(PKTMGR_SNAPSHOT_EID, CFE_EVS_EventType_INFORMATION,
+                        "Snapshot completed, sent %d cached packets", PktMgr->SnapshotSentCnt);
+   }
+   
+} /* End SnapshotSend() */
 
-    Status = EdsLib_DataTypeDB_GetTypeInfo(EDS_DB, EdsId, &TypeInfo);
-    if (Status != EDSLIB_SUCCESS)
-    {
-        return CFE_SB_INTERNAL_ERR;
-    }
 
-    *EdsDataSize = (TypeInfo.Size.Bits + 7) / 8;
-    
-    return CFE_SUCCESS;
-}
+/******************************************************************************
+** Function: StartSnapshot
+**
+** The snapshot is sent by PKTMGR_OutputTelemetry() while output is enabled.
+** A snapshot in progress is restarted.
+*/
+static void StartSnapshot(PKTMGR_Class_t *PktMgr)
+{
+
+   PktMgr->SnapshotActive  = true;
+   PktMgr->SnapshotIdx     = 0;
+   PktMgr->SnapshotSentCnt = 0;
+   
+   CFE_EVS_SendEvent(PKTMGR_SNAPSHOT_EID, CFE_EVS_EventType_INFORMATION,
+                     "Snapshot started with %d cached packets. Cache uses %d of %d pool bytes plus %d index bytes",
+                     PktMgr->LvcEntryCnt, (int)PktMgr->LvcPoolUsed, PKTMGR_LVC_POOL_SIZE, (int)sizeof(PktMgr->Priv.LvcEntry));
+   
+} /* End StartSnapshot() */
 
 
 /******************************************************************************
 ** Function: SubscribeNewPkt
 **
 */
-static int32 SubscribeNewPkt(PKTTBL_Pkt_t *NewPkt)
+static int32 SubscribeNewPkt(PKTMGR_Class_t *PktMgr, PKTTBL_Pkt_t *NewPkt)
 {
 
    int32 Status;
 
-   Status = CFE_SB_SubscribeEx(CFE_SB_ValueToMsgId(NewPkt->MsgId), PktMgr->TlmPipe, NewPkt->Qos, NewPkt->BufLim);
+   Status = CFE_SB_SubscribeEx(CFE_SB_ValueToMsgId(NewPkt->MsgId), PktPipe(PktMgr, NewPkt->MsgId), NewPkt->Qos, NewPkt->BufLim);
 
    return Status;
 
 } /* End SubscribeNewPkt(() */
 
 
+/******************************************************************************
+** Function: StopPipeline
+**
+** Stop a channel's output pipeline stages and move the channel's output to
+** the app task. Reason completes the event message.
+**
+** Notes:
+**   1. A stage may be blocked in a send or waiting on a ring so both stage
+**      tasks are deleted before their semaphores. The packets left in the
+**      rings are dropped and counted. Packets in the input pipe are output
+**      by the app task starting with the next receive.
+*/
+static void StopPipeline(PKTMGR_Class_t *PktMgr, const char *Reason)
+{
+
+   uint32 DropCnt;
+   PKTMGR_Pipeline_t *Pipe = &PktMgr->Priv.Pipeline;
+   
+   CFE_ES_DeleteChildTask(Pipe->PackTaskId);
+   CFE_ES_DeleteChildTask(Pipe->SendTaskId);
+   OS_BinSemDelete(Pipe->StartSem);
+   OS_BinSemDelete(Pipe->MsgRing.DataSem);
+   OS_BinSemDelete(Pipe->DatagramRing.DataSem);
+   OS_BinSemDelete(Pipe->DatagramRing.SpaceSem);
+   
+   DropCnt = RingCnt(&Pipe->MsgRing) + RingCnt(&Pipe->DatagramRing);
+   Pipe->MsgRing.Head      = Pipe->MsgRing.Tail;
+   Pipe->DatagramRing.Head = Pipe->DatagramRing.Tail;
+   
+   PktMgr->PipeDropCnt     += DropCnt;
+   PktMgr->PipeMsgCnt       = 0;
+   PktMgr->PipeDatagramCnt  = 0;
+   PktMgr->PipelineEna      = false;
+   
+   CFE_EVS_SendEvent(PKTMGR_PIPELINE_ERR_EID, CFE_EVS_EventType_ERROR,
+                     "Channel %d output pipeline stopped because %s. %d ring packets dropped and output moved to the app task",
+                     PktMgr->Channel, Reason, (int)DropCnt);
+
+} /* End StopPipeline() */
+
+
+/******************************************************************************
+** Function: StopWorkers
+**
+** Stop a channel's output workers after LateWorker missed the join deadline
+** and move the channel's output to the app task.
+**
+** Notes:
+**   1. A late worker may be blocked in a send or still reading its pipe and
+**      workers after it weren't joined, so every worker is deleted before
+**      the app task uses the channel's state again.
+**   2. Deleting a worker's pipe drops its queued packets and subscriptions.
+**      WorkerCnt is cleared first so SubscribeNewPkt() subscribes the active
+**      profile's packets on the channel's input pipe.
+*/
+static void StopWorkers(PKTMGR_Class_t *PktMgr, uint16 LateWorker, uint32 JoinTimeout)
+{
+
+   uint16 i;
+   uint16 WorkerCnt = PktMgr->WorkerCnt;
+   uint16 FailedCnt = 0;
+   PKTTBL_Data_t    *Tbl = &(PktMgr->PktTbl.Data);
+   PKTTBL_Pkt_t     *Pkt;
+   PKTMGR_Worker_t  *Worker;
+   
+   for (i=0; i < WorkerCnt; i++)
+   {
+      
+      Worker = &PktMgr->Worker[i];
+      
+      CFE_ES_DeleteChildTask(Worker->TaskId);
+      CFE_SB_DeletePipe(Worker->Pipe);
+      OS_BinSemDelete(Worker->WakeSem);
+      OS_BinSemDelete(Worker->DoneSem);
+      if (Worker->SockOpen) OS_close(Worker->SockId);
+      Worker->SockOpen = false;
+   
+   }
+   
+   PktMgr->WorkerCnt = 0;
+   
+   for (i=0; i < Tbl->ActiveCnt; i++)
+   {
+      Pkt = &(Tbl->Pkt[Tbl->ActiveIdx[i]]);
+      if (PKTTBL_IN_PROFILE(Pkt, PktMgr->ActiveProfile))
+      {
+         if (SubscribeNewPkt(PktMgr, Pkt) != CFE_SUCCESS) ++FailedCnt;
+      }
+   }
+   
+   CFE_EVS_SendEvent(PKTMGR_WORKER_ERR_EID, CFE_EVS_EventType_ERROR,
+                     "Channel %d output worker %d missed its %d ms join deadline. %d workers stopped and output moved to the app task, %d subscriptions failed",
+                     PktMgr->Channel, LateWorker, (int)JoinTimeout, WorkerCnt, FailedCnt);
+
+} /* End StopWorkers() */
+
+
+/******************************************************************************
+** Function: WorkerOutput
+**
+** Read a worker's pipe and send its packets until the pipe is empty, the
+** output budget is reached or a send fails.
+**
+** Notes:
+**   1. Runs on the worker's task. Only the worker's own fields, buffer and
+**      PktStats[] entries are written. Events are sent by RunWorkers().
+**   2. A datagram that fails with a transient error is held in the worker's
+**      buffer and the cycle ends. It's sent before any new packet in the
+**      next cycle so the worker's packets stay in order and the worker's
+**      pipe provides the backpressure.
+*/
+static void WorkerOutput(PKTMGR_Class_t *PktMgr, uint16 WorkerIdx)
+{
+
+   int32   SbStatus = CFE_SUCCESS;
+   size_t  EdsDataSize;
+   uint8   *Buffer = (uint8 *)PktMgr->Priv.WorkerBuffer[WorkerIdx];
+   
+   CFE_SB_MsgId_t   MsgId;
+   CFE_MSG_Size_t   MsgLen;
+   PKTTBL_Pkt_t     *PktPtr;
+   CFE_SB_Buffer_t  *SbBufPtr;
+   PKTMGR_Worker_t  *Worker = &PktMgr->Worker[WorkerIdx];
+   PKTMGR_PktStats_t  *Stats;
+   CFE_TIME_SysTime_t StartTime = CFE_TIME_GetTime();
+
+   Worker->PktsRead      = 0;
+   Worker->PktsSent      = 0;
+   Worker->BytesSent     = 0;
+   Worker->StaleDrops    = 0;
+   Worker->TransientErrs = 0;
+   Worker->BudgetReached = false;
+   Worker->SendErrStatus = 0;
+   
+   if (Worker->RetryLen > 0)
+   {
+      WorkerSend(Worker, &PktMgr->Priv.WorkerAddr, Buffer, Worker->RetryLen, Worker->RetryMsgLen);
+   }
+   
+   while ((SbStatus == CFE_SUCCESS) && !Worker->BudgetReached && (Worker->SendErrStatus == 0) &&
+          (Worker->RetryLen == 0))
+   {
+      
+      SbStatus = CFE_SB_ReceiveBuffer(&SbBufPtr, Worker->Pipe, CFE_SB_POLL);
+      
+      if (SbStatus == CFE_SUCCESS)
+      {
+         
+         CFE_MSG_GetSize(&SbBufPtr->Msg, &MsgLen);
+         CFE_MSG_GetMsgId(&SbBufPtr->Msg, &MsgId);
+         
+         PktPtr = PKTTBL_GetPkt(&(PktMgr->PktTbl.Data), CFE_SB_MsgIdToValue(MsgId));
+         if (PktPtr != NULL)
+         {
+            Stats = GetPktStats(PktMgr, PktPtr);
+            Stats->Pkts++;
+            Stats->Bytes += MsgLen;
+         }
+         
+         if ((PktPtr != NULL) && PKTTBL_IN_PROFILE(PktPtr, PktMgr->ActiveProfile) &&
+             PktMgr->DownlinkOn && (PktMgr->SuppressSend == false) &&
+             !PktUtil_IsPacketFiltered(&SbBufPtr->Msg, &(PktPtr->Filter)))
+         {
+            
+            if ((PktPtr->MaxAge > 0) && PktExpired(&SbBufPtr->Msg, PktPtr->MaxAge, StartTime))
+            {
+               Stats->StaleDrops++;
+               ++Worker->StaleDrops;
+            }
+            else if (PackEdsOutputMessage(Buffer, &SbBufPtr->Msg, sizeof(PktMgr->Priv.WorkerBuffer[WorkerIdx]), &EdsDataSize) == CFE_SUCCESS)
+            {
+               WorkerSend(Worker, &PktMgr->Priv.WorkerAddr, Buffer, EdsDataSize, MsgLen);
+            }
+         } /* End if packet is output */
+         
+         ++Worker->PktsRead;
+         Worker->BudgetReached = OutputBudgetReached(PktMgr, Worker->PktsRead, StartTime);
+      
+      } /* End if SB received msg */
+      
+   } /* End while pipe not empty */
+
+} /* End WorkerOutput() */
+
+
+/******************************************************************************
+** Function: WorkerSend
+**
+** Send a worker's datagram and record the result. A datagram that fails with
+** a transient error is held for a retry.
+*/
+static void WorkerSend(PKTMGR_Worker_t *Worker, const OS_SockAddr_t *SocketAddr, const void *Datagram,
+                       size_t DatagramLen, uint32 MsgLen)
+{
+
+   int32 SocketStatus = SendSocket(Worker->SockId, Datagram, DatagramLen, SocketAddr);
+   
+   Worker->RetryLen = 0;
+   
+   if (SocketStatus >= 0)
+   {
+      ++Worker->PktsSent;
+      Worker->BytesSent += MsgLen;
+      Worker->SendErrRun = 0;
+   }
+   else if (IsTransientSendErr(SocketStatus, &Worker->SendErrRun))
+   {
+      ++Worker->TransientErrs;
+      Worker->RetryLen    = DatagramLen;
+      Worker->RetryMsgLen = MsgLen;
+   }
+   else
+   {
+      Worker->SendErrStatus = SocketStatus;
+   }
+
+} /* End WorkerSend() */
+
+
+/******************************************************************************
+** Function: WorkerTask
+**
+** Output worker child task. Performs an output cycle each time the app task
+** gives the worker's WakeSem.
+*/
+static void WorkerTask(void)
+{
+
+   uint16 WorkerIdx;
+   PKTMGR_Class_t  *PktMgr = GetTaskInstance(&WorkerIdx);
+   PKTMGR_Worker_t *Worker;
+   
+   if (PktMgr == NULL) return;
+   Worker = &PktMgr->Worker[WorkerIdx];
+   OS_BinSemGive(Worker->DoneSem);
+   
+   while (OS_BinSemTake(Worker->WakeSem) == OS_SUCCESS)
+   {
+      WorkerOutput(PktMgr, WorkerIdx);
+      OS_BinSemGive(Worker->DoneSem);
+   }
+   
+   CFE_EVS_SendEvent(PKTMGR_WORKER_ERR_EID, CFE_EVS_EventType_ERROR,
+                     "Channel %d output worker %d terminating", PktMgr->Channel, WorkerIdx);
+   CFE_ES_ExitChildTask();
+
+} /* End WorkerTask() */
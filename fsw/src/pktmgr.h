@@ -41,6 +41,7 @@
 
 #include "app_cfg.h"
 #include "pkttbl.h"
+#include "tlm_rec.h"
 
 
 /***********************/
@@ -49,6 +50,11 @@
 
 #define PKTMGR_IP_STR_LEN  16
 
+#define PKTMGR_FEEDBACK_MAGIC  0x4B544642  /* "KTFB" */
+
+#define PKTMGR_CDS_NAME     "PKTMGR"
+#define PKTMGR_CDS_VERSION  4
+
 
 /*
 ** Event Message IDs
@@ -71,6 +77,22 @@
 #define PKTMGR_UPDATE_FILTER_CMD_SUCCESS_EID     (PKTMGR_BASE_EID + 15)
 #define PKTMGR_UPDATE_FILTER_CMD_ERR_EID         (PKTMGR_BASE_EID + 16)
 #define PKTMGR_DEBUG_EID                         (PKTMGR_BASE_EID + 17)
+#define PKTMGR_SOCKET_SEND_RETRY_EID             (PKTMGR_BASE_EID + 18)
+#define PKTMGR_CDS_RESTORE_EID                   (PKTMGR_BASE_EID + 19)
+#define PKTMGR_CDS_RESTORE_ERR_EID               (PKTMGR_BASE_EID + 20)
+#define PKTMGR_PLAN_TBL_EID                      (PKTMGR_BASE_EID + 21)
+#define PKTMGR_LOAD_TBL_BUDGET_ERR_EID           (PKTMGR_BASE_EID + 22)
+#define PKTMGR_BULK_CMD_EID                      (PKTMGR_BASE_EID + 23)
+#define PKTMGR_BULK_CMD_ERR_EID                  (PKTMGR_BASE_EID + 24)
+#define PKTMGR_SWITCH_PROFILE_EID                (PKTMGR_BASE_EID + 25)
+#define PKTMGR_SWITCH_PROFILE_ERR_EID            (PKTMGR_BASE_EID + 26)
+#define PKTMGR_FEEDBACK_EID                      (PKTMGR_BASE_EID + 27)
+#define PKTMGR_FEEDBACK_ERR_EID                  (PKTMGR_BASE_EID + 28)
+#define PKTMGR_SNAPSHOT_EID                      (PKTMGR_BASE_EID + 29)
+#define PKTMGR_WORKER_EID                        (PKTMGR_BASE_EID + 30)
+#define PKTMGR_WORKER_ERR_EID                    (PKTMGR_BASE_EID + 31)
+#define PKTMGR_PIPELINE_EID                      (PKTMGR_BASE_EID + 32)
+#define PKTMGR_PIPELINE_ERR_EID                  (PKTMGR_BASE_EID + 33)
 
 
 /**********************/
@@ -138,6 +160,87 @@ typedef struct
 #define PKKTMGR_UPDATE_FILTER_CMD_DATA_LEN  (sizeof(PKTMGR_UpdateFilterCmdMsg_t) - sizeof(CFE_MSG_CommandHeader_t))
 
 
+typedef struct
+{
+
+   CFE_MSG_CommandHeader_t CmdHeader;
+   char                    Filename[OS_MAX_PATH_LEN];
+
+} PKTMGR_PlanTblCmdMsg_t;
+#define PKKTMGR_PLAN_TBL_CMD_DATA_LEN  (sizeof(PKTMGR_PlanTblCmdMsg_t) - sizeof(CFE_MSG_CommandHeader_t))
+
+
+typedef struct
+{
+
+   CFE_MSG_CommandHeader_t CmdHeader;
+   char                    Name[PKTTBL_PROFILE_NAME_LEN];
+
+} PKTMGR_SwitchProfileCmdMsg_t;
+#define PKKTMGR_SWITCH_PROFILE_CMD_DATA_LEN  (sizeof(PKTMGR_SwitchProfileCmdMsg_t) - sizeof(CFE_MSG_CommandHeader_t))
+
+
+/*
+** Bulk commands
+** - Commands always carry PKTMGR_BULK_ENTRY_MAX entries and EntryCnt 
+**   defines how many are used
+** - Entries are processed in order and the summary event identifies failed
+**   entries by their array index
+*/
+
+typedef struct
+{
+
+   uint16                  MsgId;
+   CFE_SB_Qos_t            Qos;
+   uint8                   BufLim;
+   uint16                  FilterType;
+   PktUtil_FilterParam_t   FilterParam;
+
+} PKTMGR_BulkAddPktEntry_t;
+
+typedef struct
+{
+
+   CFE_MSG_CommandHeader_t   CmdHeader;
+   uint16                    EntryCnt;
+   PKTMGR_BulkAddPktEntry_t  Entry[PKTMGR_BULK_ENTRY_MAX];
+
+} PKTMGR_BulkAddPktCmdMsg_t;
+#define PKKTMGR_BULK_ADD_PKT_CMD_DATA_LEN  (sizeof(PKTMGR_BulkAddPktCmdMsg_t) - sizeof(CFE_MSG_CommandHeader_t))
+
+
+typedef struct
+{
+
+   CFE_MSG_CommandHeader_t  CmdHeader;
+   uint16                   EntryCnt;
+   uint16                   MsgId[PKTMGR_BULK_ENTRY_MAX];
+
+} PKTMGR_BulkRemovePktCmdMsg_t;
+#define PKKTMGR_BULK_REMOVE_PKT_CMD_DATA_LEN  (sizeof(PKTMGR_BulkRemovePktCmdMsg_t) - sizeof(CFE_MSG_CommandHeader_t))
+
+
+typedef struct
+{
+
+   uint16                  MsgId;
+   uint16                  FilterType;
+   PktUtil_FilterParam_t   FilterParam;
+
+} PKTMGR_BulkUpdateFilterEntry_t;
+
+typedef struct
+{
+
+   CFE_MSG_CommandHeader_t         CmdHeader;
+   uint16                          EntryCnt;
+   PKTMGR_BulkUpdateFilterEntry_t  Entry[PKTMGR_BULK_ENTRY_MAX];
+
+} PKTMGR_BulkUpdateFilterCmdMsg_t;
+#define PKKTMGR_BULK_UPDATE_FILTER_CMD_DATA_LEN  (sizeof(PKTMGR_BulkUpdateFilterCmdMsg_t) - sizeof(CFE_MSG_CommandHeader_t))
+
+
 /******************************************************************************
 ** Telemetry Packets
 */
@@ -154,11 +257,109 @@ typedef struct
    uint16                 FilterType;
    PktUtil_FilterParam_t  FilterParam;
 
+   uint16        MaxAge;        /* Milliseconds, 0=No limit */
+   uint16        Coalesce;      /* 1=Only the newest packet per output cycle is sent */
+   uint32        StaleDropCnt;  /* Packets dropped for exceeding MaxAge since the last reset */
+   uint32        SupersededCnt; /* Coalesced packets replaced by a newer packet since the last reset */
+
 } PKTMGR_PktTlm_t;
 
 #define PKTMGR_PKT_TLM_LEN sizeof (PKTMGR_PktTlm_t)
 
 
+/*
+** Table plan
+** - Predictions combine each entry's observed per-AppId input rate with its
+**   filter's pass ratio. Entries whose AppId hasn't been observed since the
+**   last reset are counted in UnobservedCnt and predicted as zero.
+** - The peak backlog assumes every entry's per-cycle packets arrive in the
+**   same output cycle.
+*/
+typedef struct
+{
+
+   uint16  MsgId;
+   uint16  BufLim;
+   uint16  RecBufLim;
+
+} PKTMGR_PlanEntry_t;
+
+typedef struct
+{
+
+   CFE_MSG_TelemetryHeader_t TlmHeader;
+
+   uint16  PktCnt;
+   uint16  UnobservedCnt;
+   uint32  InBytesPerSec;      /* Predicted input before filtering */
+   uint32  OutBytesPerSec;     /* Predicted output after filtering */
+   uint16  OutPktsPerSec;
+   uint16  PeakBacklog;        /* Predicted packets queued in one output cycle */
+   uint16  PipeDepth;
+   uint16  RecPipeDepth;
+   uint16  BufLimLowCnt;       /* Entries with a BufLim below the recommendation */
+   uint8   OverBudget;
+   uint8   SpareAlignByte;
+   uint32  LinkBudget;         /* Bytes/sec, 0=No limit */
+   
+   PKTMGR_PlanEntry_t Entry[PKTMGR_PLAN_ENTRY_MAX];  /* First BufLimLowCnt entries in msg ID order */
+
+} PKTMGR_PlanTlm_t;
+
+#define PKTMGR_PLAN_TLM_LEN sizeof (PKTMGR_PlanTlm_t)
+
+
+/******************************************************************************
+** Critical Data Store
+**
+** - Mirror of the active packet table, output destination and output
+**   enable state that is used to restore the packet manager after a
+**   processor reset. Output that was disabled stays disabled.
+** - Entries use the binary table image layout in active index order
+** - The CRC is computed over the image with the Crc field set to zero and
+**   only includes the PktCnt valid entries
+*/
+
+typedef struct
+{
+
+   uint16  Version;
+   uint16  PktCnt;
+   uint16  Crc;
+   uint8   DownlinkOn;
+   uint8   ActiveProfile;
+   char    TlmDestIp[PKTMGR_IP_STR_LEN];
+   uint16  ProfileCnt;
+   uint8   SuppressSend;
+   uint8   Spare;
+   char    ProfileName[PKTTBL_PROFILE_MAX][PKTTBL_PROFILE_NAME_LEN];
+   PKTTBL_BinPkt_t  Pkt[PKTTBL_MAX_SLOTS];
+
+} PKTMGR_CdsImage_t;
+
+
+/******************************************************************************
+** Ground Feedback Report
+**
+** - Sent by the ground receiver to the optional feedback UDP port. All fields
+**   are big endian.
+** - RcvSeq is the highest receive sequence, the receiver's running count of
+**   datagrams received. LossCnt is the receiver's running count of missing
+**   packets detected from CCSDS sequence count gaps. A decrease in either
+**   means the receiver restarted.
+** - See tools/feedback_rcvr.py for a reference receiver.
+*/
+
+typedef struct
+{
+
+   uint32  Magic;     /* PKTMGR_FEEDBACK_MAGIC */
+   uint32  RcvSeq;
+   uint32  LossCnt;
+
+} PKTMGR_FeedbackRpt_t;
+
+
 /******************************************************************************
 ** Packet Manager Class
 */
@@ -166,6 +367,8 @@ typedef struct
 /*
 ** Packet Manager Statistics
 ** - Stats are computed over the OutputTlmInterval
+** - When the app is driven by scheduler wakeups the OutputTlmInterval tracks
+**   the measured time between calls to PKTMGR_OutputTelemetry()
 */
 typedef enum
 {
@@ -180,6 +383,7 @@ typedef struct
 {
 
    uint16  InitCycles;         /* 0: Init done, >0: Number of remaining init cycles  */  
+   bool    MeasureInterval;    /* Derive OutputTlmInterval from measured call times  */
    
    double  OutputTlmInterval;  /* ms between calls to PKTMGR_OutputTelemetry()    */  
    double  IntervalMilliSecs;  /* Number of ms in the current computational cycle */
@@ -197,6 +401,242 @@ typedef struct
    
 } PKTMGR_Stats_t;
 
+/*
+** Output worker
+** - A worker reads its pipe and sends on its socket when the app task gives
+**   WakeSem and gives DoneSem when it's done. The cycle results are only
+**   read by the app task after it takes DoneSem.
+*/
+typedef struct
+{
+
+   CFE_ES_TaskId_t  TaskId;
+   osal_id_t        WakeSem;
+   osal_id_t        DoneSem;
+   CFE_SB_PipeId_t  Pipe;
+   osal_id_t        SockId;
+   bool             SockOpen;
+
+   uint16           PktsRead;       /* Output cycle results */
+   uint16           PktsSent;
+   uint32           BytesSent;
+   uint16           StaleDrops;
+   uint16           TransientErrs;  /* Held datagram is retried in the next cycle */
+   uint16           SendErrRun;     /* Consecutive OS_ERROR send failures */
+   size_t           RetryLen;       /* Datagram held in the worker's buffer for a retry, 0=None */
+   uint32           RetryMsgLen;
+   bool             BudgetReached;
+   int32            SendErrStatus;  /* Hard socket error that ended the cycle, 0=None */
+
+   uint32           PktCnt;         /* Packets sent since the last reset */
+
+} PKTMGR_Worker_t;
+
+/*
+** Time ordered output heap entry. Key is the packet's CCSDS header time with
+** seconds in the upper 32 bits and subseconds in the lower 32 bits.
+*/
+typedef struct
+{
+
+   uint64  Key;
+   uint64  ArrivalKey;    /* Time the packet was held */
+   uint32  Seq;           /* Keeps packets with equal times in arrival order */
+   size_t  DatagramLen;
+   uint32  MsgLen;
+   CFE_HDR_TelemetryHeader_PackedBuffer_t Datagram;
+
+} PKTMGR_ReorderEntry_t;
+
+/*
+** Output pipeline lock-free single producer single consumer ring. Head is
+** only written by the consumer and Tail by the producer, and both count up
+** so Tail-Head is the number of slots in use. A stage that waits sets its
+** waiting flag and rechecks the ring before taking its semaphore. The other
+** stage gives the semaphore after a push or pop if the flag was set.
+*/
+typedef struct
+{
+
+   uint32     Head;
+   uint32     Tail;
+   uint32     Peak;
+   bool       ConsumerWaiting;
+   bool       ProducerWaiting;
+   osal_id_t  DataSem;
+   osal_id_t  SpaceSem;
+
+} PKTMGR_Ring_t;
+
+/*
+** Output pipeline stage counters. Counters written by a stage task only
+** increase and the app task accumulates their change since its previous
+** read.
+*/
+typedef struct
+{
+
+   osal_id_t        StartSem;
+   CFE_ES_TaskId_t  PackTaskId;
+   CFE_ES_TaskId_t  SendTaskId;
+   
+   PKTMGR_Ring_t    MsgRing;        /* App task to pack stage  */
+   PKTMGR_Ring_t    DatagramRing;   /* Pack stage to send stage */
+
+   uint32  PackStarveCnt;           /* Pack stage */
+   uint32  PackStallCnt;
+   uint32  PackErrCnt;
+   uint32  SendStarveCnt;           /* Send stage */
+   uint32  SentPkts;
+   uint32  SentBytes;
+   uint32  TransientErrs;
+   int32   SendErrStatus;           /* Hard socket error, cleared when output is enabled */
+   bool    PackExited;              /* Set by a stage before it exits */
+   bool    SendExited;
+
+   uint32  PrevPackStarveCnt;       /* App task */
+   uint32  PrevPackStallCnt;
+   uint32  PrevPackErrCnt;
+   uint32  PrevSendStarveCnt;
+   uint32  PrevSentPkts;
+   uint32  PrevSentBytes;
+   uint32  PrevTransientErrs;
+
+} PKTMGR_Pipeline_t;
+
+/*
+** Packets and bytes read from the pipe, packets dropped because they
+** exceeded MaxAge and coalesced packets replaced by a newer packet per
+** packet table entry since PktStatsStart. PktStats[] is indexed by packet
+** table slot and MsgId is the entry the counts belong to, see GetPktStats().
+*/
+typedef struct
+{
+   
+   uint16  MsgId;
+   uint32  Pkts;
+   uint32  Bytes;
+   uint32  StaleDrops;
+   uint32  Superseded;
+
+} PKTMGR_PktStats_t;
+
+typedef struct
+{
+   
+   size_t  DatagramLen;
+   uint32  MsgLen;
+   CFE_HDR_TelemetryHeader_PackedBuffer_t Datagram;
+
+} PKTMGR_RetryEntry_t;
+
+/*
+** Newest packet read in the current output cycle for each coalescing
+** message ID. Slots are assigned in arrival order and all slots are released
+** when they're sent at the end of the cycle.
+*/
+typedef struct
+{
+
+   uint16          MsgId;
+   CFE_MSG_Size_t  MsgLen;
+   union
+   {
+      CFE_MSG_Message_t  Msg;
+      uint8              Byte[PKTMGR_COALESCE_MSG_MAX_LEN];
+   } Buf;
+
+} PKTMGR_CoalesceSlot_t;
+
+/*
+** Last value cache. LvcEntry[] is indexed by packet table slot and locates
+** the entry's last packed datagram in LvcPool[].
+*/
+typedef struct
+{
+
+   uint16  MsgId;     /* PKTTBL_UNUSED_MSG_ID when nothing is cached */
+   uint16  Len;       /* Packed datagram bytes */
+   uint16  MsgLen;    /* Unpacked message bytes used for output statistics */
+   uint16  Cap;       /* Pool bytes allocated */
+   uint32  Offset;
+
+} PKTMGR_LvcEntry_t;
+
+/*
+** Output pipeline ring slots. Each slot carries the destination address
+** that was current when the packet was received.
+*/
+typedef struct
+{
+
+   CFE_MSG_Size_t  MsgLen;
+   OS_SockAddr_t   SocketAddr;
+   union
+   {
+      CFE_MSG_Message_t  Msg;
+      uint8              Byte[PKTMGR_PIPELINE_MSG_MAX_LEN];
+   } Buf;
+
+} PKTMGR_PipeMsg_t;
+
+typedef struct
+{
+
+   size_t         DatagramLen;
+   uint32         MsgLen;
+   OS_SockAddr_t  SocketAddr;
+   CFE_HDR_TelemetryHeader_PackedBuffer_t Datagram;
+
+} PKTMGR_PipeDatagram_t;
+
+/*
+** Each channel's datagram storage. It's only accessed by pktmgr.c and is
+** part of the class so each channel instance owns its buffers.
+*/
+typedef struct
+{
+
+   CFE_HDR_TelemetryHeader_PackedBuffer_t SocketBuffer;
+
+   PKTMGR_RetryEntry_t    RetryQueue[PKTMGR_RETRY_QUEUE_LEN];
+   PKTMGR_CdsImage_t      CdsImage;
+
+   PKTMGR_CoalesceSlot_t  CoalesceSlot[PKTMGR_COALESCE_SLOTS];
+   uint16                 CoalesceSlotCnt;
+
+   PKTMGR_LvcEntry_t      LvcEntry[PKTTBL_MAX_SLOTS];
+   uint8                  LvcPool[PKTMGR_LVC_POOL_SIZE];
+
+   PKTMGR_PktStats_t      PktStats[PKTTBL_MAX_SLOTS];
+
+   /*
+   ** Time ordered output. ReorderHeap[] holds ReorderEntry[] indices. The
+   ** first ReorderCnt indices form a min-heap and the rest are free entries.
+   ** ReorderLastKey is the key of the last packet released.
+   */
+   PKTMGR_ReorderEntry_t  ReorderEntry[PKTMGR_REORDER_LEN];
+   uint16                 ReorderHeap[PKTMGR_REORDER_LEN];
+   uint32                 ReorderSeq;
+   uint64                 ReorderLastKey;
+   uint64                 ReorderWindowKey;
+
+   /*
+   ** Output workers pack into their own buffer. WorkerAddr is set by the
+   ** app task before the workers are started.
+   */
+   CFE_HDR_TelemetryHeader_PackedBuffer_t WorkerBuffer[PKTMGR_MAX_WORKERS];
+   OS_SockAddr_t          WorkerAddr;
+
+   /*
+   ** Output pipeline ring slots
+   */
+   PKTMGR_Pipeline_t      Pipeline;
+   PKTMGR_PipeMsg_t       PipeMsg[PKTMGR_PIPELINE_LEN];
+   PKTMGR_PipeDatagram_t  PipeDatagram[PKTMGR_PIPELINE_LEN];
+
+} PKTMGR_Storage_t;
+
 
 typedef struct
 {
@@ -207,11 +647,21 @@ typedef struct
 
    INITBL_Class_t *IniTbl;
    
+   /*
+   ** Channel number and the channel's datagram storage that is private to
+   ** pktmgr.c
+   */
+   
+   uint16            Channel;
+   PKTMGR_Storage_t  Priv;
+   TLM_REC_Class_t  *TlmRec;    /* Recorder fed and served by the channel, NULL if none */
+   
    /*
    ** Telemetry Packets
    */
    
    PKTMGR_PktTlm_t   PktTlm;
+   PKTMGR_PlanTlm_t  PlanTlm;
 
    /*
    ** PktMgr Data
@@ -226,6 +676,154 @@ typedef struct
    bool              SuppressSend;
    PKTMGR_Stats_t    Stats;
 
+   uint16            OutputPktLimit;     /* Max packets read per output cycle, 0=No limit */
+   uint16            OutputTimeLimit;    /* Max ms spent per output cycle, 0=No limit     */
+   uint32            OutputBoundCycles;  /* Number of output cycles that hit a limit      */
+   uint16            OutputPktsRead;     /* Packets read from the pipe in the last cycle  */
+   
+   uint32              LinkBudget;       /* Max predicted bytes/sec for a table load, 0=No limit */
+
+   /*
+   ** Output rate limit token bucket. Tokens accrue at RateLimit bytes/sec up
+   ** to one second's worth and a cycle stops reading the pipe when they run
+   ** out. HoldOutput leaves packets in the pipe, e.g. ahead of a contact.
+   */
+   uint32              RateLimit;        /* Bytes/sec, 0=No limit */
+   int32               RateTokens;
+   CFE_TIME_SysTime_t  RateRefillTime;
+   uint32              RateLimitCycles;  /* Output cycles that ran out of tokens */
+   bool                HoldOutput;
+
+   /*
+   ** Optional ground feedback additive-increase/multiplicative-decrease (AIMD)
+   ** controller. A report with new losses cuts FeedbackRate to a percentage
+   ** of its value, a loss-free report adds FeedbackIncrease if the output
+   ** was rate limited since the previous report. The output rate limit is
+   ** the lower of FeedbackRate and RateLimit.
+   */
+   bool                FeedbackEna;
+   osal_id_t           FeedbackSockId;
+   uint32              FeedbackRate;       /* Bytes/sec */
+   uint32              FeedbackMinRate;
+   uint32              FeedbackMaxRate;
+   uint32              FeedbackIncrease;   /* Bytes/sec added per loss-free report */
+   uint32              FeedbackDecrease;   /* Percent of rate kept after a loss report */
+   uint32              FeedbackTimeout;    /* Ms without a report before falling back to the min rate, 0=No timeout */
+   CFE_TIME_SysTime_t  FeedbackTime;
+   bool                FeedbackTimedOut;
+   uint32              FeedbackRcvSeq;
+   uint32              FeedbackLossCnt;    /* Last reported receiver loss count */
+   uint32              FeedbackLimitCycles;/* RateLimitCycles at the last report */
+   uint32              FeedbackLossSum;    /* Losses reported since the last reset */
+   uint16              FeedbackRptCnt;
+   uint16              FeedbackTimeoutCnt;
+
+   CFE_TIME_SysTime_t  PktStatsStart;    /* Start of per-entry input rate observations */
+
+   /*
+   ** Only entries that belong to the active profile are subscribed and
+   ** output. Always less than the table's profile count or 0.
+   */
+   uint16            ActiveProfile;
+
+   /*
+   ** Datagrams that failed to send due to a transient socket error are
+   ** queued and retried at the start of the next output cycle. The oldest
+   ** datagram is dropped when a full queue receives a new one. The datagram
+   ** storage is private to pktmgr.c.
+   */
+   uint16            RetryQueueHead;
+   uint16            RetryQueueCnt;
+   uint16            SendErrRun;         /* Consecutive OS_ERROR send failures by the app task */
+   uint32            RetryDropCnt;       /* Datagrams dropped due to a full queue         */
+   uint32            SendTransientErrCnt;
+   uint32            StaleDropCnt;       /* Packets dropped for exceeding their entry's MaxAge */
+   uint32            SupersededCnt;      /* Coalesced packets replaced by a newer packet  */
+   uint32            CoalesceFullCnt;    /* Coalescing packets sent normally, no slot     */
+
+   /*
+   ** Last value cache (LVC). The last packed datagram of each table entry
+   ** is kept in a PKTMGR_LVC_POOL_SIZE byte pool private to pktmgr.c. A
+   ** snapshot sends every cached datagram, SnapshotPkts per output cycle,
+   ** so a ground display that connects mid-pass doesn't wait for slow
+   ** packets. The cache is cleared when a table is loaded.
+   */
+   uint16            LvcEntryCnt;
+   uint32            LvcPoolUsed;        /* Pool bytes allocated to entries */
+   uint32            LvcFullCnt;         /* Datagrams not cached because the pool was full */
+   uint16            SnapshotPkts;       /* 0=No limit */
+   bool              SnapshotOnEnable;
+   bool              SnapshotActive;
+   uint16            SnapshotIdx;        /* Next active index entry to send */
+   uint16            SnapshotSentCnt;
+
+   /*
+   ** Optional time ordered output. Packets ready to send are held in a
+   ** min-heap keyed by their CCSDS header time and released oldest first
+   ** once they're ReorderWindow ms old. A packet older than the last packet
+   ** released missed the window. It's counted as late and sent immediately.
+   ** The heap storage is private to pktmgr.c.
+   */
+   uint16            ReorderWindow;      /* Ms, 0=Disabled */
+   uint16            ReorderCnt;         /* Packets held */
+   uint32            ReorderLateCnt;
+   uint32            ReorderFullCnt;     /* Packets released early because the heap was full */
+
+   /*
+   ** Optional output workers. Each message ID is assigned to worker
+   ** (MsgId % WorkerCnt) and is subscribed on that worker's pipe, so one
+   ** task reads and sends all of a message ID's packets and their order is
+   ** preserved. Each output cycle the app task starts every worker and waits
+   ** for them to finish. A worker holds one datagram for a retry. Workers
+   ** aren't created when time ordering, the recorder or the snapshot on
+   ** enable is configured, and a table with coalescing entries is rejected.
+   ** The rate limit is checked before the workers are started. If a worker
+   ** doesn't finish within OutputTimeLimit plus WorkerTimeout ms the workers
+   ** are stopped and the app task performs the channel's output.
+   */
+   uint16            WorkerCnt;          /* 0=Output is performed by the app task */
+   uint16            WorkerCycleMs;      /* Time from starting to joining the workers in the last cycle */
+   uint16            WorkerTimeout;      /* Ms beyond OutputTimeLimit the app task waits for the workers */
+   PKTMGR_Worker_t   Worker[PKTMGR_MAX_WORKERS];
+
+   /*
+   ** Optional output pipeline used when there are no workers. The app task
+   ** receives and filters packets and copies them to a ring read by the
+   ** pack stage task. It packs them into a ring read by the send stage task
+   ** so packing a packet overlaps sending the previous one. The rings are
+   ** lock-free single producer single consumer rings private to pktmgr.c.
+   ** A stall is a stage finding its output ring full and a starve is a
+   ** stage finding its input ring empty, so the bottleneck stage is the one
+   ** whose input ring stalls and whose output ring starves. The send stage
+   ** resends a datagram after a transient error and the rings fill behind
+   ** it. Like the workers the pipeline isn't created when time ordering, the
+   ** recorder or the snapshot on enable is configured, and a table with
+   ** coalescing entries is rejected. If a stage task exits or the rings
+   ** don't drain within WorkerTimeout ms for a packet too large for a ring
+   ** slot, the pipeline is stopped and the app task performs the channel's
+   ** output.
+   */
+   bool              PipelineEna;
+   uint16            PipeMsgCnt;         /* Receive to pack ring occupancy after the last receive */
+   uint16            PipeMsgPeak;
+   uint16            PipeDatagramCnt;    /* Pack to send ring occupancy after the last receive */
+   uint16            PipeDatagramPeak;
+   uint32            PipeRcvStallCnt;    /* Receive cycles ended by a full ring */
+   uint32            PipePackStarveCnt;
+   uint32            PipePackStallCnt;
+   uint32            PipeSendStarveCnt;
+   uint32            PipeInlineCnt;      /* Packets too large for a ring slot, sent by the app task */
+   uint32            PipePackErrCnt;     /* Packets that failed to pack */
+   uint32            PipeDropCnt;        /* Packets dropped when the pipeline was stopped */
+
+   /*
+   ** The CDS image is updated whenever the table or destination changes.
+   ** CdsExisted is set when the CDS block survived a reset.
+   */
+   bool                CdsValid;
+   bool                CdsExisted;
+   CFE_ES_CDSHandle_t  CdsHandle;
+
    /*
    ** Contained Objects
    */ 
@@ -241,16 +839,28 @@ typedef struct
 /******************************************************************************
 ** Function: PKTMGR_Constructor
 **
-** Construct a PKTMGR object. All table entries are cleared and the LoadTbl()
-** function should be used to load an initial table.
+** Construct a PKTMGR object for an output channel. All table entries are
+** cleared and the LoadTbl() function should be used to load an initial table.
 **
 ** Notes:
 **   1. This must be called prior to any other function.
 **   2. Decoupling the initial table load gives an app flexibility in file
 **      management during startup.
+**   3. Channel must be less than PKTMGR_MAX_CHANNELS and each channel can
+**      only be constructed once. Channel 0 uses the configured pipe name,
+**      ports and CDS name. Other channels add the channel number to the
+**      ports and append it to the names.
+**   4. TblId is the table manager ID of the channel's packet table. See
+**      PKTTBL_Constructor().
+**   5. TlmRec is the flight recorder the channel records to and dumps
+**      from, NULL if the channel has no recorder.
+**   6. The channel's output workers or pipeline stage tasks are created
+**      here. If a task can't be created the channel's output is performed
+**      by the app task.
 **
 */
-void PKTMGR_Constructor(PKTMGR_Class_t *PktMgrPtr, INITBL_Class_t *IniTbl);
+void PKTMGR_Constructor(PKTMGR_Class_t *PktMgr, INITBL_Class_t *IniTbl, uint16 Channel, uint8 TblId,
+                        TLM_REC_Class_t *TlmRec);
 
 
 /******************************************************************************
@@ -266,6 +876,67 @@ void PKTMGR_Constructor(PKTMGR_Class_t *PktMgrPtr, INITBL_Class_t *IniTbl);
 bool PKTMGR_AddPktCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
 
 
+/******************************************************************************
+** Function: PKTMGR_BulkAddPktCmd
+**
+** Add the command's packets to the table and subscribe for them on the SB.
+**
+** Notes:
+**   1. Each entry is processed like PKTMGR_AddPktCmd() but a single summary
+**      event is sent for the command.
+**   2. The command fails if any entry fails. Entries that succeeded remain
+**      in the table.
+** 
+*/
+bool PKTMGR_BulkAddPktCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: PKTMGR_BulkRemovePktCmd
+**
+** Remove the command's packets from the table and unsubscribe from them.
+**
+** Notes:
+**   1. Each entry is processed like PKTMGR_RemovePktCmd() but a single
+**      summary event is sent for the command.
+** 
+*/
+bool PKTMGR_BulkRemovePktCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: PKTMGR_BulkUpdateFilterCmd
+**
+** Update the filters of the command's packets.
+**
+** Notes:
+**   1. Each entry is processed like PKTMGR_UpdateFilterCmd() but a single
+**      summary event is sent for the command.
+** 
+*/
+bool PKTMGR_BulkUpdateFilterCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: PKTMGR_DisableOutput
+**
+** Suppress telemetry output. Packets continue to be read from the pipe and
+** are discarded. The socket is left open.
+**
+*/
+void PKTMGR_DisableOutput(PKTMGR_Class_t *PktMgr);
+
+
+/******************************************************************************
+** Function: PKTMGR_EnableOutput
+**
+** Enable telemetry output to DestIp. Same behavior as the enable output 
+** command. A snapshot is started if PKTMGR_SNAPSHOT_ON_ENABLE is set.
+**
+*/
+bool PKTMGR_EnableOutput(PKTMGR_Class_t *PktMgr, const char *DestIp);
+
+
 /******************************************************************************
 ** Function: PKTMGR_EnableOutputCmd
 **
@@ -284,17 +955,76 @@ bool PKTMGR_EnableOutputCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
 **                     If zero retain the last interval value
 ** InitDelay         - Number of ms to delay starting stats computation
 */
-void PKTMGR_InitStats(uint16 OutputTlmInterval, uint16 InitDelay);
+void PKTMGR_InitStats(PKTMGR_Class_t *PktMgr, uint16 OutputTlmInterval, uint16 InitDelay);
+
+
+/******************************************************************************
+** Function: PKTMGR_HoldOutput
+**
+** While Hold is true PKTMGR_OutputTelemetry() doesn't read the pipe so 
+** packets accumulate up to each subscription's BufLim.
+**
+*/
+void PKTMGR_HoldOutput(PKTMGR_Class_t *PktMgr, bool Hold);
 
 
 /******************************************************************************
 ** Function: PKTMGR_OutputTelemetry
 **
-** If downlink is enabled and output hasn't been suppressed it sends all of the
-** SB packets on the telemetry input pipe out the socket.
+** If downlink is enabled and output hasn't been suppressed it sends the SB
+** packets on the telemetry input pipe out the socket.
+**
+** Notes:
+**   1. The pipe is read until it is empty or until the per-cycle packet count
+**      or time budget is reached. Packets left in the pipe are sent during the
+**      next cycle so command processing is not starved under heavy load.
+**   2. Datagrams that fail to send with a transient socket error are queued
+**      and resent ahead of new packets. Only hard socket errors suppress
+**      output.
+**   3. When a rate limit is set the pipe is also left unread once the 
+**      cycle's bytes sent reach the available tokens.
+**   4. Pending ground feedback reports are processed before the output
+**      so a rate change applies to the current cycle.
+**   5. With output workers each worker reads up to the packet and time
+**      limits from its own pipe and the function returns after every
+**      worker finishes.
+**   6. With the output pipeline the function returns once the packets are
+**      in the receive ring. The packets and bytes output are the ones the
+**      send stage sent since the previous call.
+**
+*/
+uint16 PKTMGR_OutputTelemetry(PKTMGR_Class_t *PktMgr);
+
+
+/******************************************************************************
+** Function: PKTMGR_RestoreFromCds
+**
+** Restore the packet table, subscriptions and output destination from the
+** Critical Data Store. Returns true if the table was restored.
+**
+** Notes:
+**   1. Only attempted after a processor reset. The caller should load the
+**      default table file when this returns false.
+**   2. The image's version and CRC are verified before any subscriptions
+**      are made.
 **
 */
-uint16 PKTMGR_OutputTelemetry(void);
+bool PKTMGR_RestoreFromCds(PKTMGR_Class_t *PktMgr);
+
+
+/******************************************************************************
+** Function: PKTMGR_PlanTblCmd
+**
+** Read a table file without loading it and report the predicted output rate,
+** pipe backlog and recommended buffer limits in an event and the plan
+** telemetry packet.
+**
+** Notes:
+**   1. The file is read by the PKTTBL child task. The plan is reported when
+**      the read completes.
+** 
+*/
+bool PKTMGR_PlanTblCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
 
 
 /******************************************************************************
@@ -307,7 +1037,7 @@ uint16 PKTMGR_OutputTelemetry(void);
 **      change the functional behavior should be reset.
 **
 */
-void PKTMGR_ResetStatus(void);
+void PKTMGR_ResetStatus(PKTMGR_Class_t *PktMgr);
 
 
 /******************************************************************************
@@ -342,11 +1072,54 @@ bool PKTMGR_RemovePktCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
 bool PKTMGR_SendPktTblTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
 
 
+/******************************************************************************
+** Function: PKTMGR_SetRateLimit
+**
+** Limit telemetry output to BytesPerSec. Zero removes the limit. The token
+** bucket starts full.
+**
+*/
+void PKTMGR_SetRateLimit(PKTMGR_Class_t *PktMgr, uint32 BytesPerSec);
+
+
+/******************************************************************************
+** Function: PKTMGR_SnapshotCmd
+**
+** Send the last value of every entry in the active profile. The snapshot is
+** sent over several output cycles once output is enabled. Rejected when
+** output workers or the output pipeline are configured because they don't
+** cache values.
+**
+*/
+bool PKTMGR_SnapshotCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: PKTMGR_SwitchProfile
+**
+** Make the named packet table profile active. Entries that are only in the
+** new profile are subscribed and entries that are only in the previous 
+** profile are unsubscribed. Returns false if the profile isn't defined or a
+** subscription change failed.
+**
+*/
+bool PKTMGR_SwitchProfile(PKTMGR_Class_t *PktMgr, const char *Name);
+
+
+/******************************************************************************
+** Function: PKTMGR_SwitchProfileCmd
+**
+** Command wrapper for PKTMGR_SwitchProfile().
+**
+*/
+bool PKTMGR_SwitchProfileCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
 /******************************************************************************
 ** Function: PKTMGR_UpdateFilterCmd
 **
 ** Notes:
-**   1. Command rejected if AppId packet entry has not been loaded 
+**   1. Command rejected if the message ID packet entry has not been loaded 
 **   2. The filter type is verified but the filter parameter values are not 
 ** 
 */
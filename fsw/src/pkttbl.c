@@ -35,52 +35,131 @@
 /** Macro Definitions **/
 /***********************/
 
-#define JSON_DATA_WORD_STR_MAX 32
+#define JSON_READ_BUF_LEN   512   /* File read chunk size                */
+#define JSON_MAX_DEPTH      16    /* Max nested objects and arrays       */
+#define JSON_STR_MAX        32    /* Longer strings are a parse error    */
+#define JSON_DIGIT_MAX      9     /* Longer integers are a parse error   */
+
+#define JSON_PKT_ATTR_CNT   7     /* Required attributes in addition to topic-id */
+
+#define DUMP_BUF_LEN        2048  /* Dump file write chunk size */
 
 
 /**********************/
 /** Type Definitions **/
 /**********************/
 
-/* See LoadJsonData()prologue for details */
+/* See LoadJsonFile() prologue for details */
+
+typedef enum
+{
+   
+   JSON_TOKEN_ERROR = 0,
+   JSON_TOKEN_EOF,
+   JSON_TOKEN_OBJ_START,
+   JSON_TOKEN_OBJ_END,
+   JSON_TOKEN_ARRAY_START,
+   JSON_TOKEN_ARRAY_END,
+   JSON_TOKEN_COLON,
+   JSON_TOKEN_COMMA,
+   JSON_TOKEN_STRING,
+   JSON_TOKEN_NUMBER,
+   JSON_TOKEN_LITERAL
+
+} JsonTokenType_t;
+
+typedef struct
+{
+
+   JsonTokenType_t  Type;
+   int32            Number;
+   char             Str[JSON_STR_MAX];
+
+} JsonToken_t;
+
+typedef struct
+{
+   
+   osal_id_t  FileHandle;
+   int32      BufLen;
+   int32      BufIdx;
+   int        UngetChar;     /* -1 if no character saved */
+   uint32     LineNum;
+   bool       TokenTooLong;  /* Set with a JSON_TOKEN_ERROR for an oversized string or number */
+   char       Buf[JSON_READ_BUF_LEN];
+
+} JsonReader_t;
+
+/* Dump files are written in DUMP_BUF_LEN chunks */
+typedef struct
+{
+   
+   osal_id_t  FileHandle;
+   size_t     Len;
+   bool       WriteErr;
+   char       Buf[DUMP_BUF_LEN];
 
-typedef CJSON_IntObj_t JsonTopicId_t;
-typedef CJSON_IntObj_t JsonPriority_t;
-typedef CJSON_IntObj_t JsonReliability_t;
-typedef CJSON_IntObj_t JsonBufLimit_t;
-typedef CJSON_IntObj_t JsonFilterType_t;
-typedef CJSON_IntObj_t JsonFilterX_t;
-typedef CJSON_IntObj_t JsonFilterN_t;
-typedef CJSON_IntObj_t JsonFilterO_t;
+} DumpBuf_t;
 
+/* Packet being assembled from the "packet" object currently being parsed */
 typedef struct
 {
-   JsonTopicId_t      TopicId;
-   JsonPriority_t     Priority;
-   JsonReliability_t  Reliability;
-   JsonBufLimit_t     BufLimit;
-   JsonFilterType_t   FilterType;
-   JsonFilterX_t      FilterX;
-   JsonFilterN_t      FilterN;
-   JsonFilterO_t      FilterO;
-     
+   
+   bool          TopicIdDefined;
+   int32         TopicId;
+   uint16        AttributeMask;
+   uint16        AttributeCnt;
+   PKTTBL_Pkt_t  Pkt;
+
 } JsonPacket_t;
 
 /**********************/
 /** Global File Data **/
 /**********************/
 
-static PKTTBL_Class_t  *PktTbl = NULL;
-static PKTTBL_Data_t   TblData;        /* Working buffer for loads */
+/*
+** Each output channel owns a table instance. One child task performs file
+** I/O for every instance so the binary image and dump buffer, which are only
+** used during file I/O, are shared. Instances are indexed by table ID.
+*/
+static PKTTBL_Class_t  *Instance[PKTTBL_MAX_INSTANCES];
+static uint16          InstanceCnt = 0;
+static bool            ChildActive = false;  /* False if the child couldn't be created, I/O is done inline */
+static CFE_ES_TaskId_t ChildTaskId;
+static osal_id_t       WakeSem;              /* Given by main task to start a request */
+static PKTTBL_BinImage_t BinImage;           /* Binary load/dump image  */
+static DumpBuf_t       DumpBuf;
+
+static const char *FileIoOpStr[] = { "undefined", "load", "dump", "plan" };
 
 
 /******************************/
 /** File Function Prototypes **/
 /******************************/
 
-static void ConstructJsonPacket(JsonPacket_t *JsonPacket, uint16 PktArrayIdx);
-static bool LoadJsonData(size_t JsonFileLen);
-static bool WriteJsonPkt(int32 FileHandle, const PKTTBL_Pkt_t* Pkt, bool FirstPktWritten);
+static void   ChildTask(void);
+static PKTTBL_Class_t *GetInstance(const TBLMGR_Tbl_t *Tbl);
+static void   DumpBufFlush(DumpBuf_t *Dump);
+static void   DumpBufWrite(DumpBuf_t *Dump, const char *Str);
+static bool   DumpBinFile(const PKTTBL_Data_t *TblData, const char *Filename);
+static bool   DumpJsonFile(const PKTTBL_Data_t *TblData, const char *Filename);
+static uint16 FindActivePos(const PKTTBL_Data_t *TblPtr, uint16 MsgId, bool *Found);
+static uint16 FindSlot(const PKTTBL_Data_t *TblPtr, uint16 MsgId);
+static uint16 HashMsgId(uint16 MsgId);
+static bool   IsBinFile(const char *Filename);
+static int    JsonGetChar(JsonReader_t *Reader);
+static void   JsonNextToken(JsonReader_t *Reader, JsonToken_t *Token);
+static bool   JsonStorePacket(PKTTBL_Data_t *TblData, JsonPacket_t *JsonPacket, uint16 PktArrayIdx, bool *ReadPkt);
+static bool   JsonStorePktProfile(PKTTBL_Data_t *TblData, JsonPacket_t *JsonPacket, uint16 PktArrayIdx, const char *Name);
+static bool   JsonStoreProfileName(PKTTBL_Data_t *TblData, const char *Name);
+static void   JsonStoreValue(JsonPacket_t *JsonPacket, bool InFilter, const char *Key, int32 Value);
+static bool   LoadBinFile(PKTTBL_Data_t *TblData, const char *Filename, uint16 *PktCnt);
+static bool   LoadJsonFile(PKTTBL_Data_t *TblData, const char *Filename, uint16 *PktArrayCnt);
+static void   LockFileIo(PKTTBL_FileIo_t *FileIo);
+static void   PerformFileIo(PKTTBL_Class_t *PktTbl);
+static bool   StartFileIo(PKTTBL_Class_t *PktTbl, PKTTBL_FileIoOp_t Op, const char *Filename);
+static void   UnlockFileIo(PKTTBL_FileIo_t *FileIo);
+static bool   WriteJsonPkt(const PKTTBL_Data_t *TblData, DumpBuf_t *Dump, const PKTTBL_Pkt_t* Pkt, bool FirstPktWritten);
 
 
 /******************************************************************************
@@ -88,21 +167,71 @@ static bool WriteJsonPkt(int32 FileHandle, const PKTTBL_Pkt_t* Pkt, bool FirstPk
 **
 ** Notes:
 **    1. This must be called prior to any other functions
+**    2. The first instance constructed creates the shared child task
 **
 */
-void PKTTBL_Constructor(PKTTBL_Class_t *ObjPtr, const char *AppName,
-                        PKTTBL_LoadNewTbl_t LoadNewTbl)
+void PKTTBL_Constructor(PKTTBL_Class_t *PktTbl, INITBL_Class_t *IniTbl,
+                        const char *AppName, uint8 TblId, void *Owner,
+                        PKTTBL_LoadNewTbl_t LoadNewTbl, PKTTBL_PlanNewTbl_t PlanNewTbl)
 {
    
-   PktTbl = ObjPtr;
-
+   int32 Status = OS_SUCCESS;
+   char  MutexName[OS_MAX_API_NAME];
+   PKTTBL_FileIo_t *FileIo = &(PktTbl->FileIo);
+   
    CFE_PSP_MemSet(PktTbl, 0, sizeof(PKTTBL_Class_t));
    PKTTBL_SetTblToUnused(&(PktTbl->Data));
 
    PktTbl->AppName        = AppName;
+   PktTbl->TblId          = TblId;
+   PktTbl->Owner          = Owner;
    PktTbl->LoadNewTbl     = LoadNewTbl;
+   PktTbl->PlanNewTbl     = PlanNewTbl;
    PktTbl->LastLoadStatus = TBLMGR_STATUS_UNDEF;
    
+   FileIo->State = PKTTBL_FILE_IO_IDLE;
+   
+   if (InstanceCnt >= PKTTBL_MAX_INSTANCES)
+   {
+      CFE_EVS_SendEvent(PKTTBL_INSTANCE_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Packet table instance limit %d exceeded. Table ID %d can't be loaded or dumped",
+                        PKTTBL_MAX_INSTANCES, TblId);
+      return;
+   }
+   
+   snprintf(MutexName, OS_MAX_API_NAME, "KIT_TO_TBL_MUT%d", InstanceCnt);
+   Status = OS_MutSemCreate(&FileIo->StateMutex, MutexName, 0);
+   if (Status != OS_SUCCESS)
+   {
+      FileIo->Inline = true;
+      CFE_EVS_SendEvent(PKTTBL_CHILD_TASK_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating table ID %d file I/O mutex, status %d. Its loads and dumps will be performed inline",
+                        TblId, (int)Status);
+   }
+   
+   Instance[InstanceCnt++] = PktTbl;
+   
+   if (InstanceCnt == 1)
+   {
+      Status = OS_BinSemCreate(&WakeSem, "KIT_TO_TBL_WAKE", OS_SEM_EMPTY, 0);
+      if (Status == OS_SUCCESS)
+      {
+         Status = CFE_ES_CreateChildTask(&ChildTaskId,
+                                         INITBL_GetStrConfig(IniTbl, CFG_PKTTBL_CHILD_NAME),
+                                         ChildTask, 0,
+                                         INITBL_GetIntConfig(IniTbl, CFG_PKTTBL_CHILD_STACK_SIZE),
+                                         INITBL_GetIntConfig(IniTbl, CFG_PKTTBL_CHILD_PRIORITY), 0);
+      }
+      
+      ChildActive = (Status == CFE_SUCCESS);
+      if (!ChildActive)
+      {
+         CFE_EVS_SendEvent(PKTTBL_CHILD_TASK_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Error creating table file I/O child task, status 0x%08X. Loads and dumps will be performed inline",
+                           (unsigned int)Status);
+      }
+   }
+   
 } /* End PKTTBL_Constructor() */
 
 
@@ -123,67 +252,138 @@ void PKTTBL_Constructor(PKTTBL_Class_t *ObjPtr, const char *AppName,
 bool PKTTBL_DumpCmd(TBLMGR_Tbl_t *Tbl, uint8 DumpType, const char *Filename)
 {
 
-   bool          RetStatus = false;
-   osal_id_t     FileHandle;
-   int32         OsStatus;
-   bool          FirstPktWritten = false;
-   uint16        AppId;
-   char          DumpRecord[512];
-   char          SysTimeStr[256];
-   os_err_name_t OsErrStr;
-
-   OsStatus = OS_OpenCreate(&FileHandle, Filename, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_READ_WRITE);
+   PKTTBL_Class_t *PktTbl = GetInstance(Tbl);
    
-   if (OsStatus == OS_SUCCESS)
-   {
+   if (PktTbl == NULL) return false;
+   
+   return StartFileIo(PktTbl, PKTTBL_FILE_IO_DUMP, Filename);
+   
+} /* End of PKTTBL_DumpCmd() */
 
-      sprintf(DumpRecord,"\n{\n\"name\": \"Kit Telemetry Output (KIT_TO) Packet Table\",\n");
-      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
 
-      CFE_TIME_Print(SysTimeStr, CFE_TIME_GetTime());
+/******************************************************************************
+** Function: PKTTBL_Execute
+**
+*/
+void PKTTBL_Execute(PKTTBL_Class_t *PktTbl)
+{
+
+   PKTTBL_FileIo_t *FileIo  = &(PktTbl->FileIo);
+   PKTTBL_Data_t   *TblData = &(FileIo->Stage);
+   PKTTBL_FileIoState_t State;
+   uint32 IoMs;
+   
+   LockFileIo(FileIo);
+   State = FileIo->State;
+   UnlockFileIo(FileIo);
+   
+   if (State != PKTTBL_FILE_IO_DONE) return;
+   
+   if (FileIo->Op == PKTTBL_FILE_IO_LOAD)
+   {
       
-      sprintf(DumpRecord,"\"description\": \"KIT_TO dumped at %s\",\n",SysTimeStr);
-      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+      /* The owner may reject the table, e.g. when it exceeds a link budget */
+      if (FileIo->Result)
+      {
+         FileIo->Result = PktTbl->LoadNewTbl(PktTbl->Owner, TblData);
+      }
+      
+      if (FileIo->Result)
+      {
+         PktTbl->Loaded         = true;
+         PktTbl->LastLoadStatus = TBLMGR_STATUS_VALID;
+         PktTbl->LastLoadCnt    = FileIo->PktCnt;
+      }
+      else
+      {
+         PktTbl->LastLoadStatus = TBLMGR_STATUS_INVALID;
+      }
+      PktTbl->LastLoadMs = KIT_TO_ElapsedMilliSecs(FileIo->StartTime);
+      IoMs = PktTbl->LastLoadMs;
+   
+   }
+   else
+   {
+      if ((FileIo->Op == PKTTBL_FILE_IO_PLAN) && FileIo->Result)
+      {
+         PktTbl->PlanNewTbl(PktTbl->Owner, TblData, FileIo->Filename);
+      }
+      IoMs = KIT_TO_ElapsedMilliSecs(FileIo->StartTime);
+   }
+   
+   CFE_EVS_SendEvent(PKTTBL_FILE_IO_DONE_EID, 
+                     (FileIo->Result ? CFE_EVS_EventType_INFORMATION : CFE_EVS_EventType_ERROR),
+                     "Packet table %s of %s '%s' %s in %d ms with %d entries",
+                     FileIoOpStr[FileIo->Op],
+                     (IsBinFile(FileIo->Filename) ? "binary file" : "file"), FileIo->Filename,
+                     (FileIo->Result ? "completed" : "failed"), (int)IoMs, FileIo->PktCnt);
+   
+   LockFileIo(FileIo);
+   FileIo->State = PKTTBL_FILE_IO_IDLE;
+   UnlockFileIo(FileIo);
+   
+} /* End PKTTBL_Execute() */
 
 
-      /* 
-      ** Packet Array 
-      **
-      ** - Not all fields in ground table are saved in FSW so they are not
-      **   populated in the dump file. However, the dump file can still
-      **   be loaded.
-      */
+/******************************************************************************
+** Function: PKTTBL_GetHashStats
+**
+*/
+void PKTTBL_GetHashStats(const PKTTBL_Data_t *TblPtr, uint16 *Collisions, uint16 *MaxProbe)
+{
+
+   uint16 i;
+   uint16 Slot;
+   uint16 Probe;
+   
+   *Collisions = 0;
+   *MaxProbe   = 0;
+   
+   for (i=0; i < TblPtr->ActiveCnt; i++)
+   {
       
-      sprintf(DumpRecord,"\"packet-array\": [\n");
-      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+      Slot  = TblPtr->ActiveIdx[i];
+      Probe = (Slot - HashMsgId(TblPtr->Pkt[Slot].MsgId)) & PKTTBL_SLOT_MASK;
       
-      for (AppId=0; AppId < PKTUTIL_MAX_APP_ID; AppId++)
-      {
-               
-         if (WriteJsonPkt(FileHandle, &(PktTbl->Data.Pkt[AppId]), FirstPktWritten)) FirstPktWritten = true;
-              
-      } /* End packet loop */
+      if (Probe > 0) ++(*Collisions);
+      if ((Probe + 1) > *MaxProbe) *MaxProbe = Probe + 1;
+   
+   }
+   
+} /* End PKTTBL_GetHashStats() */
+
+
+/******************************************************************************
+** Function: PKTTBL_GetPkt
+**
+*/
+PKTTBL_Pkt_t *PKTTBL_GetPkt(PKTTBL_Data_t *TblPtr, uint16 MsgId)
+{
 
-      sprintf(DumpRecord,"\n]}\n");
-      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+   uint16 Slot = FindSlot(TblPtr, MsgId);
+   
+   return (Slot < PKTTBL_MAX_SLOTS) ? &(TblPtr->Pkt[Slot]) : NULL;
+   
+} /* End PKTTBL_GetPkt() */
 
-      RetStatus = true;
 
-      OS_close(FileHandle);
+/******************************************************************************
+** Function: PKTTBL_GetProfile
+**
+*/
+uint16 PKTTBL_GetProfile(const PKTTBL_Data_t *TblPtr, const char *Name)
+{
 
-   } /* End if file create */
-   else
+   uint16 Profile;
+   
+   for (Profile=0; Profile < TblPtr->ProfileCnt; Profile++)
    {
-      OS_GetErrorName(OsStatus, &OsErrStr);
-      CFE_EVS_SendEvent(PKTTBL_CREATE_FILE_ERR_EID, CFE_EVS_EventType_ERROR,
-                        "Error creating dump file '%s', Status = %s", 
-                        Filename, OsErrStr);
+      if (strncmp(TblPtr->ProfileName[Profile], Name, PKTTBL_PROFILE_NAME_LEN) == 0) return Profile;
+   }
    
-   } /* End if file create error */
-
-   return RetStatus;
+   return PKTTBL_PROFILE_MAX;
    
-} /* End of PKTTBL_DumpCmd() */
+} /* End PKTTBL_GetProfile() */
 
 
 /******************************************************************************
@@ -197,15 +397,14 @@ bool PKTTBL_DumpCmd(TBLMGR_Tbl_t *Tbl, uint8 DumpType, const char *Filename)
 bool PKTTBL_LoadCmd(TBLMGR_Tbl_t *Tbl, uint8 LoadType, const char *Filename)
 {
 
-   bool  RetStatus = false;
-
-   if (CJSON_ProcessFile(Filename, PktTbl->JsonBuf, PKTTBL_JSON_FILE_MAX_CHAR, LoadJsonData))
-   {
-      PktTbl->Loaded = true;
-      PktTbl->LastLoadStatus = TBLMGR_STATUS_VALID;
-      RetStatus = true;
-   }
-   else
+   bool RetStatus;
+   PKTTBL_Class_t *PktTbl = GetInstance(Tbl);
+   
+   if (PktTbl == NULL) return false;
+   
+   RetStatus = StartFileIo(PktTbl, PKTTBL_FILE_IO_LOAD, Filename);
+   
+   if (!RetStatus)
    {
       PktTbl->LastLoadStatus = TBLMGR_STATUS_INVALID;
    }
@@ -215,15 +414,108 @@ bool PKTTBL_LoadCmd(TBLMGR_Tbl_t *Tbl, uint8 LoadType, const char *Filename)
 } /* End PKTTBL_LoadCmd() */
 
 
+/******************************************************************************
+** Function: PKTTBL_PackBinPkt
+**
+*/
+void PKTTBL_PackBinPkt(PKTTBL_BinPkt_t *BinPkt, const PKTTBL_Pkt_t *Pkt)
+{
+
+   BinPkt->MsgId       = Pkt->MsgId;
+   BinPkt->Priority    = Pkt->Qos.Priority;
+   BinPkt->Reliability = Pkt->Qos.Reliability;
+   BinPkt->BufLim      = Pkt->BufLim;
+   BinPkt->FilterType  = Pkt->Filter.Type;
+   BinPkt->FilterN     = Pkt->Filter.Param.N;
+   BinPkt->FilterX     = Pkt->Filter.Param.X;
+   BinPkt->FilterO     = Pkt->Filter.Param.O;
+   BinPkt->ProfileMask = Pkt->ProfileMask;
+   BinPkt->Flags       = Pkt->Coalesce ? PKTTBL_BIN_FLAG_COALESCE : 0;
+   BinPkt->MaxAge      = Pkt->MaxAge;
+
+} /* End PKTTBL_PackBinPkt() */
+
+
+/******************************************************************************
+** Function: PKTTBL_PlanCmd
+**
+*/
+bool PKTTBL_PlanCmd(PKTTBL_Class_t *PktTbl, const char *Filename)
+{
+
+   return StartFileIo(PktTbl, PKTTBL_FILE_IO_PLAN, Filename);
+   
+} /* End PKTTBL_PlanCmd() */
+
+
+/******************************************************************************
+** Function: PKTTBL_RemovePkt
+**
+** Notes:
+**   1. Uses backward shift deletion. Each following entry up to the next
+**      empty slot is moved back into the hole unless its home slot lies
+**      between the hole and its current slot, which would make it
+**      unreachable. Moved entries have their active index slot updated.
+*/
+bool PKTTBL_RemovePkt(PKTTBL_Data_t *TblPtr, uint16 MsgId)
+{
+
+   bool   Found;
+   uint16 Slot = FindSlot(TblPtr, MsgId);
+   uint16 Next;
+   uint16 Home;
+   uint16 Pos;
+   
+   if (Slot >= PKTTBL_MAX_SLOTS) return false;
+   
+   Pos = FindActivePos(TblPtr, MsgId, &Found);
+   if (Found)
+   {
+      memmove(&TblPtr->ActiveIdx[Pos], &TblPtr->ActiveIdx[Pos+1], 
+              (TblPtr->ActiveCnt - Pos - 1)*sizeof(uint16));
+      --TblPtr->ActiveCnt;
+   }
+   
+   PKTTBL_SetPacketToUnused(&(TblPtr->Pkt[Slot]));
+   
+   Next = (Slot + 1) & PKTTBL_SLOT_MASK;
+   while (TblPtr->Pkt[Next].MsgId != PKTTBL_UNUSED_MSG_ID)
+   {
+      
+      Home = HashMsgId(TblPtr->Pkt[Next].MsgId);
+      
+      if (((Next - Home) & PKTTBL_SLOT_MASK) >= ((Next - Slot) & PKTTBL_SLOT_MASK))
+      {
+         
+         TblPtr->Pkt[Slot] = TblPtr->Pkt[Next];
+         
+         Pos = FindActivePos(TblPtr, TblPtr->Pkt[Slot].MsgId, &Found);
+         if (Found) TblPtr->ActiveIdx[Pos] = Slot;
+         
+         PKTTBL_SetPacketToUnused(&(TblPtr->Pkt[Next]));
+         Slot = Next;
+      
+      }
+      
+      Next = (Next + 1) & PKTTBL_SLOT_MASK;
+   
+   } /* End shift loop */
+   
+   return true;
+   
+} /* End PKTTBL_RemovePkt() */
+
+
 /******************************************************************************
 ** Function: PKTTBL_ResetStatus
 **
 */
-void PKTTBL_ResetStatus(void)
+void PKTTBL_ResetStatus(PKTTBL_Class_t *PktTbl)
 {
    
    PktTbl->LastLoadStatus = TBLMGR_STATUS_UNDEF;
    PktTbl->LastLoadCnt = 0;
+   PktTbl->LastLoadMs  = 0;
     
 } /* End PKTTBL_ResetStatus() */
 
@@ -244,6 +536,58 @@ void PKTTBL_SetPacketToUnused(PKTTBL_Pkt_t *PktPtr)
 } /* End PKTTBL_SetPacketToUnused() */
 
 
+/******************************************************************************
+** Function: PKTTBL_SetPkt
+**
+** Notes:
+**   1. A new entry uses the first empty slot in its probe sequence.
+*/
+bool PKTTBL_SetPkt(PKTTBL_Data_t *TblPtr, const PKTTBL_Pkt_t *PktPtr)
+{
+
+   bool   Found;
+   uint16 Slot;
+   uint16 FreeSlot = PKTTBL_MAX_SLOTS;
+   uint16 Probe;
+   uint16 Pos;
+   
+   if (PktPtr->MsgId == PKTTBL_UNUSED_MSG_ID) return false;
+   
+   Slot = HashMsgId(PktPtr->MsgId);
+   for (Probe=0; Probe < PKTTBL_MAX_SLOTS; Probe++)
+   {
+      
+      if (TblPtr->Pkt[Slot].MsgId == PktPtr->MsgId)
+      {
+         TblPtr->Pkt[Slot] = *PktPtr;
+         return true;
+      }
+      
+      if (TblPtr->Pkt[Slot].MsgId == PKTTBL_UNUSED_MSG_ID)
+      {
+         FreeSlot = Slot;
+         break;
+      }
+      
+      Slot = (Slot + 1) & PKTTBL_SLOT_MASK;
+   
+   } /* End probe loop */
+   
+   if (FreeSlot >= PKTTBL_MAX_SLOTS) return false;
+   
+   Pos = FindActivePos(TblPtr, PktPtr->MsgId, &Found);
+   memmove(&TblPtr->ActiveIdx[Pos+1], &TblPtr->ActiveIdx[Pos], 
+           (TblPtr->ActiveCnt - Pos)*sizeof(uint16));
+   TblPtr->ActiveIdx[Pos] = FreeSlot;
+   ++TblPtr->ActiveCnt;
+   
+   TblPtr->Pkt[FreeSlot] = *PktPtr;
+   
+   return true;
+   
+} /* End PKTTBL_SetPkt() */
+
+
 /******************************************************************************
 ** Function: PKTTBL_SetTblToUnused
 **
@@ -252,190 +596,1187 @@ void PKTTBL_SetPacketToUnused(PKTTBL_Pkt_t *PktPtr)
 void PKTTBL_SetTblToUnused(PKTTBL_Data_t *TblPtr)
 {
   
-   uint16 AppId;
+   uint16 Slot;
    
    CFE_PSP_MemSet(TblPtr, 0, sizeof(PKTTBL_Data_t));
 
-   for (AppId=0; AppId < PKTUTIL_MAX_APP_ID; AppId++)
+   for (Slot=0; Slot < PKTTBL_MAX_SLOTS; Slot++)
    {
       
-      TblPtr->Pkt[AppId].MsgId       = PKTTBL_UNUSED_MSG_ID;
-      TblPtr->Pkt[AppId].Filter.Type = PKTUTIL_FILTER_ALWAYS;
+      TblPtr->Pkt[Slot].MsgId       = PKTTBL_UNUSED_MSG_ID;
+      TblPtr->Pkt[Slot].Filter.Type = PKTUTIL_FILTER_ALWAYS;
    
    }
    
+   TblPtr->ActiveCnt = 0;
+   
 } /* End PKTTBL_SetTblToUnused() */
 
 
 /******************************************************************************
-** Function: ConstructJsonPacket
+** Function: PKTTBL_UnpackBinPkt
 **
 */
-static void ConstructJsonPacket(JsonPacket_t* JsonPacket, uint16 PktArrayIdx)
+void PKTTBL_UnpackBinPkt(PKTTBL_Pkt_t *Pkt, const PKTTBL_BinPkt_t *BinPkt)
 {
 
-   char KeyStr[64];
-   
-   sprintf(KeyStr,"packet-array[%d].packet.topic-id", PktArrayIdx);
-   CJSON_ObjConstructor(&JsonPacket->TopicId.Obj, KeyStr, JSONNumber, &JsonPacket->TopicId.Value, 4);
-
-   sprintf(KeyStr,"packet-array[%d].packet.priority", PktArrayIdx);
-   CJSON_ObjConstructor(&JsonPacket->Priority.Obj, KeyStr, JSONNumber, &JsonPacket->Priority.Value, 4);
-
-   sprintf(KeyStr,"packet-array[%d].packet.reliability", PktArrayIdx);
-   CJSON_ObjConstructor(&JsonPacket->Reliability.Obj, KeyStr, JSONNumber, &JsonPacket->Reliability.Value, 4);
-
-   sprintf(KeyStr,"packet-array[%d].packet.buf-limit", PktArrayIdx);
-   CJSON_ObjConstructor(&JsonPacket->BufLimit.Obj, KeyStr, JSONNumber, &JsonPacket->BufLimit.Value, 4);
+   Pkt->MsgId           = BinPkt->MsgId;
+   Pkt->Qos.Priority    = BinPkt->Priority;
+   Pkt->Qos.Reliability = BinPkt->Reliability;
+   Pkt->BufLim          = BinPkt->BufLim;
+   Pkt->Filter.Type     = BinPkt->FilterType;
+   Pkt->Filter.Param.N  = BinPkt->FilterN;
+   Pkt->Filter.Param.X  = BinPkt->FilterX;
+   Pkt->Filter.Param.O  = BinPkt->FilterO;
+   Pkt->ProfileMask     = BinPkt->ProfileMask;
+   Pkt->MaxAge          = BinPkt->MaxAge;
+   Pkt->Coalesce        = ((BinPkt->Flags & PKTTBL_BIN_FLAG_COALESCE) != 0);
 
-   sprintf(KeyStr,"packet-array[%d].packet.filter.type", PktArrayIdx);
-   CJSON_ObjConstructor(&JsonPacket->FilterType.Obj, KeyStr, JSONNumber, &JsonPacket->FilterType.Value, 4);
+} /* End PKTTBL_UnpackBinPkt() */
 
-   sprintf(KeyStr,"packet-array[%d].packet.filter.X", PktArrayIdx);
-   CJSON_ObjConstructor(&JsonPacket->FilterX.Obj, KeyStr, JSONNumber, &JsonPacket->FilterX.Value, 4);
 
-   sprintf(KeyStr,"packet-array[%d].packet.filter.N", PktArrayIdx);
-   CJSON_ObjConstructor(&JsonPacket->FilterN.Obj, KeyStr, JSONNumber, &JsonPacket->FilterN.Value, 4);
+/******************************************************************************
+** Function: ChildTask
+**
+** Wait for the main task to start a file I/O request and perform the
+** pending request of each table instance.
+*/
+static void ChildTask(void)
+{
 
-   sprintf(KeyStr,"packet-array[%d].packet.filter.O", PktArrayIdx);
-   CJSON_ObjConstructor(&JsonPacket->FilterO.Obj, KeyStr, JSONNumber, &JsonPacket->FilterO.Value, 4);
+   uint16 i;
+   PKTTBL_FileIoState_t State;
+   
+   while (OS_BinSemTake(WakeSem) == OS_SUCCESS)
+   {
+      for (i=0; i < InstanceCnt; i++)
+      {
+         if (Instance[i]->FileIo.Inline) continue;
+         
+         LockFileIo(&Instance[i]->FileIo);
+         State = Instance[i]->FileIo.State;
+         UnlockFileIo(&Instance[i]->FileIo);
+         
+         if (State == PKTTBL_FILE_IO_PENDING) PerformFileIo(Instance[i]);
+      }
+   }
+   
+   CFE_EVS_SendEvent(PKTTBL_CHILD_TASK_ERR_EID, CFE_EVS_EventType_ERROR,
+                     "Table file I/O child task terminating");
+   CFE_ES_ExitChildTask();
 
-} /* ConstructJsonPacket() */
+} /* End ChildTask() */
 
 
 /******************************************************************************
-** Function: LoadJsonData
+** Function: DumpBinFile
 **
 ** Notes:
-**  1. The JSON file can contain 1 to PKTUTIL_MAX_APP_ID entries. The table can
-**     be sparsely populated. 
-**  2. JSON "packet-array" contains the following "packet" object entries
-**       {"packet": {
-**          "name": "ES_APP_TLM_TOPICID",  # Not saved
-**          "topic-id-N": 0,               # Not saved
-**          "topic-id": 0,
-**          "priority": 0,
-**          "reliability": 0,
-**          "buf-limit": 4,
-**          "filter": { "type": 2, "X": 1, "N": 1, "O": 0}
-**       }},
-**
+**   1. The image is built in memory and written with a single write.
+**   2. Called by the child task to write the staged copy of the table.
 */
-static bool LoadJsonData(size_t JsonFileLen)
+static bool DumpBinFile(const PKTTBL_Data_t *TblData, const char *Filename)
 {
 
-   bool    RetStatus = true;
-   bool    ReadPkt = true;
-   uint16  AttributeCnt;
-   uint16  PktArrayIdx;
-   uint16  AppIdIdx;
+   bool          RetStatus = false;
+   osal_id_t     FileHandle;
+   int32         OsStatus;
+   size_t        ImageLen;
+   uint16        Crc;
+   uint16        i;
+   os_err_name_t OsErrStr;
    
-   JsonPacket_t  JsonPacket;
-   PKTTBL_Pkt_t  Pkt;
-
-
-   PktTbl->JsonFileLen = JsonFileLen;
-
-   /* 
-   ** 1. Copy table owner data into local table buffer
-   ** 2. Process JSON file which updates local table buffer with JSON supplied values
-   ** 3. If valid, copy local buffer over owner's data 
-   */
    
-   memcpy(&TblData, &PktTbl->Data, sizeof(PKTTBL_Data_t));
-
-   PktArrayIdx = 0;
-   while (ReadPkt)
+   OsStatus = OS_OpenCreate(&FileHandle, Filename, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_READ_WRITE);
+   
+   if (OsStatus == OS_SUCCESS)
    {
-
-      ConstructJsonPacket(&JsonPacket, PktArrayIdx);
-      memset((void*)&Pkt,0,sizeof(PKTTBL_Pkt_t));
-
-      /*
-      ** Use 'topic-id' field to determine whether processing the file
-      ** is complete. A missing or malformed 'topic-id' field error will
-      ** not be caught or reported.
-      ** The 'topic-id' field is required but CJSON_LoadObjOptional() is
-      ** used so the 'object not found' event will be suppressed 
-      */      
       
-      if (CJSON_LoadObjOptional(&JsonPacket.TopicId.Obj, PktTbl->JsonBuf, PktTbl->JsonFileLen))
+      for (i=0; i < TblData->ActiveCnt; i++)
       {
          
-         AppIdIdx = JsonPacket.TopicId.Value & PKTTBL_APP_ID_MASK;
-         
-         if (AppIdIdx < PKTUTIL_MAX_APP_ID)
+         PKTTBL_PackBinPkt(&BinImage.Pkt[i], &(TblData->Pkt[TblData->ActiveIdx[i]]));
+      }
+      
+      BinImage.Hdr.Magic     = PKTTBL_BIN_MAGIC;
+      BinImage.Hdr.Version   = PKTTBL_BIN_VERSION;
+      BinImage.Hdr.EntrySize = sizeof(PKTTBL_BinPkt_t);
+      BinImage.Hdr.EntryCnt  = TblData->ActiveCnt;
+      BinImage.Hdr.ProfileCnt = TblData->ProfileCnt;
+      BinImage.Hdr.Spare      = 0;
+      memcpy(BinImage.Hdr.ProfileName, TblData->ProfileName, sizeof(BinImage.Hdr.ProfileName));
+      
+      Crc = CFE_ES_CalculateCRC(BinImage.Hdr.ProfileName, sizeof(BinImage.Hdr.ProfileName), 
+                                0, CFE_MISSION_ES_DEFAULT_CRC);
+      BinImage.Hdr.Crc = CFE_ES_CalculateCRC(BinImage.Pkt, BinImage.Hdr.EntryCnt*sizeof(PKTTBL_BinPkt_t), 
+                                             Crc, CFE_MISSION_ES_DEFAULT_CRC);
+      
+      ImageLen = sizeof(PKTTBL_BinHdr_t) + BinImage.Hdr.EntryCnt*sizeof(PKTTBL_BinPkt_t);
+      
+      OsStatus = OS_write(FileHandle, &BinImage, ImageLen);
+      OS_close(FileHandle);
+      
+      if (OsStatus == (int32)ImageLen)
+      {
+         RetStatus = true;
+      }
+      else
+      {
+         CFE_EVS_SendEvent(PKTTBL_CREATE_FILE_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Error writing binary dump file '%s', Status = %d", 
+                           Filename, OsStatus);
+      }
+
+   } /* End if file create */
+   else
+   {
+      OS_GetErrorName(OsStatus, &OsErrStr);
+      CFE_EVS_SendEvent(PKTTBL_CREATE_FILE_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating dump file '%s', Status = %s", 
+                        Filename, OsErrStr);
+   
+   } /* End if file create error */
+   
+   return RetStatus;
+   
+} /* End DumpBinFile() */
+
+
+/******************************************************************************
+** Function: DumpBufFlush
+**
+*/
+static void DumpBufFlush(DumpBuf_t *Dump)
+{
+
+   if (Dump->Len > 0)
+   {
+      if (OS_write(Dump->FileHandle, Dump->Buf, Dump->Len) != (int32)Dump->Len) Dump->WriteErr = true;
+      Dump->Len = 0;
+   }
+   
+} /* End DumpBufFlush() */
+
+
+/******************************************************************************
+** Function: DumpBufWrite
+**
+*/
+static void DumpBufWrite(DumpBuf_t *Dump, const char *Str)
+{
+
+   size_t StrLen = strlen(Str);
+   
+   if ((Dump->Len + StrLen) > DUMP_BUF_LEN) DumpBufFlush(Dump);
+   
+   memcpy(&Dump->Buf[Dump->Len], Str, StrLen);
+   Dump->Len += StrLen;
+   
+} /* End DumpBufWrite() */
+
+
+/******************************************************************************
+** Function: DumpJsonFile
+**
+** Notes:
+**   1. Records are collected in DumpBuf and written in DUMP_BUF_LEN chunks
+**      rather than with a file write per record.
+**   2. Called by the child task to write the staged copy of the table.
+*/
+static bool DumpJsonFile(const PKTTBL_Data_t *TblData, const char *Filename)
+{
+
+   bool          RetStatus = false;
+   int32         OsStatus;
+   bool          FirstPktWritten = false;
+   uint16        i;
+   char          DumpRecord[512];
+   char          SysTimeStr[256];
+   os_err_name_t OsErrStr;
+
+   OsStatus = OS_OpenCreate(&DumpBuf.FileHandle, Filename, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_READ_WRITE);
+   
+   if (OsStatus == OS_SUCCESS)
+   {
+      
+      DumpBuf.Len      = 0;
+      DumpBuf.WriteErr = false;
+      
+      DumpBufWrite(&DumpBuf, "\n{\n\"name\": \"Kit Telemetry Output (KIT_TO) Packet Table\",\n");
+
+      CFE_TIME_Print(SysTimeStr, CFE_TIME_GetTime());
+      
+      sprintf(DumpRecord,"\"description\": \"KIT_TO dumped at %s\",\n",SysTimeStr);
+      DumpBufWrite(&DumpBuf, DumpRecord);
+
+      if (TblData->ProfileCnt > 0)
+      {
+         DumpBufWrite(&DumpBuf, "\"profiles\": [");
+         for (i=0; i < TblData->ProfileCnt; i++)
+         {
+            sprintf(DumpRecord, "%s\"%s\"", (i == 0 ? " " : ", "), TblData->ProfileName[i]);
+            DumpBufWrite(&DumpBuf, DumpRecord);
+         }
+         DumpBufWrite(&DumpBuf, " ],\n");
+      }
+
+
+      /* 
+      ** Packet Array 
+      **
+      ** - Not all fields in ground table are saved in FSW so they are not
+      **   populated in the dump file. However, the dump file can still
+      **   be loaded.
+      */
+      
+      DumpBufWrite(&DumpBuf, "\"packet-array\": [\n");
+      
+      for (i=0; i < TblData->ActiveCnt; i++)
+      {
+               
+         if (WriteJsonPkt(TblData, &DumpBuf, &(TblData->Pkt[TblData->ActiveIdx[i]]), FirstPktWritten)) FirstPktWritten = true;
+              
+      } /* End packet loop */
+
+      DumpBufWrite(&DumpBuf, "\n]}\n");
+      DumpBufFlush(&DumpBuf);
+
+      OS_close(DumpBuf.FileHandle);
+
+      if (DumpBuf.WriteErr)
+      {
+         CFE_EVS_SendEvent(PKTTBL_CREATE_FILE_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Error writing dump file '%s'", Filename);
+      }
+      else
+      {
+         RetStatus = true;
+      }
+
+   } /* End if file create */
+   else
+   {
+      OS_GetErrorName(OsStatus, &OsErrStr);
+      CFE_EVS_SendEvent(PKTTBL_CREATE_FILE_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating dump file '%s', Status = %s", 
+                        Filename, OsErrStr);
+   
+   } /* End if file create error */
+
+   return RetStatus;
+   
+} /* End DumpJsonFile() */
+
+
+/******************************************************************************
+** Function: FindActivePos
+**
+** Binary search of the active index which is sorted by message ID. Returns 
+** the position of MsgId if it is found, otherwise the position where MsgId
+** should be inserted.
+*/
+static uint16 FindActivePos(const PKTTBL_Data_t *TblPtr, uint16 MsgId, bool *Found)
+{
+
+   uint16 Low  = 0;
+   uint16 High = TblPtr->ActiveCnt;
+   uint16 Mid;
+   uint16 MidMsgId;
+   
+   *Found = false;
+   
+   while (Low < High)
+   {
+      
+      Mid = Low + (High - Low)/2;
+      MidMsgId = TblPtr->Pkt[TblPtr->ActiveIdx[Mid]].MsgId;
+      
+      if (MidMsgId == MsgId)
+      {
+         *Found = true;
+         return Mid;
+      }
+      else if (MidMsgId < MsgId)
+      {
+         Low = Mid + 1;
+      }
+      else
+      {
+         High = Mid;
+      }
+   
+   } /* End while */
+   
+   return Low;
+   
+} /* End FindActivePos() */
+
+
+/******************************************************************************
+** Function: FindSlot
+**
+** Return the slot containing MsgId or PKTTBL_MAX_SLOTS if MsgId is not in the
+** table. The probe stops at the first empty slot.
+*/
+static uint16 FindSlot(const PKTTBL_Data_t *TblPtr, uint16 MsgId)
+{
+
+   uint16 Slot;
+   uint16 Probe;
+   
+   if (MsgId == PKTTBL_UNUSED_MSG_ID) return PKTTBL_MAX_SLOTS;
+   
+   Slot = HashMsgId(MsgId);
+   for (Probe=0; Probe < PKTTBL_MAX_SLOTS; Probe++)
+   {
+      
+      if (TblPtr->Pkt[Slot].MsgId == MsgId) return Slot;
+      
+      if (TblPtr->Pkt[Slot].MsgId == PKTTBL_UNUSED_MSG_ID) break;
+      
+      Slot = (Slot + 1) & PKTTBL_SLOT_MASK;
+   
+   }
+   
+   return PKTTBL_MAX_SLOTS;
+   
+} /* End FindSlot() */
+
+
+/******************************************************************************
+** Function: GetInstance
+**
+** Return the table instance registered with the table manager as Tbl, NULL
+** if there isn't one.
+*/
+static PKTTBL_Class_t *GetInstance(const TBLMGR_Tbl_t *Tbl)
+{
+
+   uint16 i;
+   
+   for (i=0; i < InstanceCnt; i++)
+   {
+      if (Instance[i]->TblId == Tbl->Id) return Instance[i];
+   }
+   
+   CFE_EVS_SendEvent(PKTTBL_INSTANCE_ERR_EID, CFE_EVS_EventType_ERROR,
+                     "No packet table instance has table ID %d", Tbl->Id);
+   
+   return NULL;
+
+} /* End GetInstance() */
+
+
+/******************************************************************************
+** Function: HashMsgId
+**
+** Fibonacci hash of the full message ID so IDs that only differ in their
+** upper bits, for example the same AppId on different processors, are
+** spread across the table.
+*/
+static uint16 HashMsgId(uint16 MsgId)
+{
+
+   return (uint16)(((uint32)MsgId * 2654435769u) >> 21) & PKTTBL_SLOT_MASK;
+   
+} /* End HashMsgId() */
+
+
+/******************************************************************************
+** Function: IsBinFile
+**
+*/
+static bool IsBinFile(const char *Filename)
+{
+
+   size_t NameLen = strlen(Filename);
+   size_t ExtLen  = strlen(PKTTBL_BIN_FILE_EXT);
+   
+   return ((NameLen > ExtLen) && (strcmp(&Filename[NameLen-ExtLen], PKTTBL_BIN_FILE_EXT) == 0));
+   
+} /* End IsBinFile() */
+
+
+/******************************************************************************
+** Function: JsonGetChar
+**
+** Return the next character from the file or -1 at the end of the file. The
+** file is read in JSON_READ_BUF_LEN chunks so there is no file size limit.
+*/
+static int JsonGetChar(JsonReader_t *Reader)
+{
+
+   int Char;
+   
+   if (Reader->UngetChar >= 0)
+   {
+      Char = Reader->UngetChar;
+      Reader->UngetChar = -1;
+      return Char;
+   }
+   
+   if (Reader->BufIdx >= Reader->BufLen)
+   {
+      Reader->BufLen = OS_read(Reader->FileHandle, Reader->Buf, JSON_READ_BUF_LEN);
+      Reader->BufIdx = 0;
+      if (Reader->BufLen <= 0) return -1;
+   }
+   
+   Char = (unsigned char)Reader->Buf[Reader->BufIdx++];
+   if (Char == '\n') ++Reader->LineNum;
+   
+   return Char;
+   
+} /* End JsonGetChar() */
+
+
+/******************************************************************************
+** Function: JsonNextToken
+**
+** Notes:
+**   1. Numbers are converted to integers. Fractions and exponents are
+**      consumed but ignored since all table values are integers.
+**   2. Escaped characters are copied without translation.
+**   3. A number must have at least one integer digit, a '-' without one is
+**      a syntax error.
+**   4. A string or literal longer than JSON_STR_MAX-1 characters or an
+**      integer with more than JSON_DIGIT_MAX digits is an error token with
+**      the reader's TokenTooLong flag set. Nothing is written beyond the
+**      token's buffer and the integer can't overflow.
+*/
+static void JsonNextToken(JsonReader_t *Reader, JsonToken_t *Token)
+{
+
+   int    Char;
+   int32  Sign = 1;
+   uint16 StrLen = 0;
+   uint16 DigitCnt = 0;
+   
+   Token->Type   = JSON_TOKEN_ERROR;
+   Token->Number = 0;
+   Token->Str[0] = '\0';
+   
+   do
+   {
+      Char = JsonGetChar(Reader);
+   } while ((Char == ' ') || (Char == '\t') || (Char == '\r') || (Char == '\n'));
+   
+   switch (Char)
+   {
+      
+      case -1:  Token->Type = JSON_TOKEN_EOF;          break;
+      case '{': Token->Type = JSON_TOKEN_OBJ_START;    break;
+      case '}': Token->Type = JSON_TOKEN_OBJ_END;      break;
+      case '[': Token->Type = JSON_TOKEN_ARRAY_START;  break;
+      case ']': Token->Type = JSON_TOKEN_ARRAY_END;    break;
+      case ':': Token->Type = JSON_TOKEN_COLON;        break;
+      case ',': Token->Type = JSON_TOKEN_COMMA;        break;
+      
+      case '"':
+         while (((Char = JsonGetChar(Reader)) != '"') && (Char >= 0))
+         {
+            if (Char == '\\') Char = JsonGetChar(Reader);
+            if (StrLen >= (JSON_STR_MAX-1))
+            {
+               Reader->TokenTooLong = true;
+               break;
+            }
+            Token->Str[StrLen++] = (char)Char;
+         }
+         Token->Str[StrLen] = '\0';
+         if ((Char == '"') && !Reader->TokenTooLong) Token->Type = JSON_TOKEN_STRING;
+         break;
+      
+      default:
+         
+         if ((Char == '-') || ((Char >= '0') && (Char <= '9')))
+         {
+            
+            if (Char == '-')
+            {
+               Sign = -1;
+               Char = JsonGetChar(Reader);
+            }
+            while ((Char >= '0') && (Char <= '9') && (DigitCnt < JSON_DIGIT_MAX))
+            {
+               Token->Number = Token->Number*10 + (Char - '0');
+               Char = JsonGetChar(Reader);
+               ++DigitCnt;
+            }
+            if ((Char >= '0') && (Char <= '9'))
+            {
+               Reader->TokenTooLong = true;
+               break;
+            }
+            if (DigitCnt == 0)
+            {
+               Reader->UngetChar = Char;
+               break;
+            }
+            while ((Char == '.') || (Char == 'e') || (Char == 'E') || (Char == '+') || (Char == '-') ||
+                   ((Char >= '0') && (Char <= '9')))
+            {
+               Char = JsonGetChar(Reader);
+            }
+            Reader->UngetChar = Char;
+            Token->Number *= Sign;
+            Token->Type = JSON_TOKEN_NUMBER;
+         
+         }
+         else if ((Char >= 'a') && (Char <= 'z'))
+         {
+         
+            /* true, false, null */
+            while ((Char >= 'a') && (Char <= 'z') && (StrLen < (JSON_STR_MAX-1)))
+            {
+               Token->Str[StrLen++] = (char)Char;
+               Char = JsonGetChar(Reader);
+            }
+            Token->Str[StrLen] = '\0';
+            if ((Char >= 'a') && (Char <= 'z'))
+            {
+               Reader->TokenTooLong = true;
+               break;
+            }
+            Reader->UngetChar = Char;
+            Token->Type = JSON_TOKEN_LITERAL;
+         }
+         break;
+   
+   } /* End switch */
+   
+} /* End JsonNextToken() */
+
+
+/******************************************************************************
+** Function: JsonStorePacket
+**
+** Validate a completed "packet" object and store it in the working table.
+**
+** Notes:
+**   1. A packet without a 'topic-id' terminates processing without an error
+**      which is consistent with previous versions of the table loader.
+*/
+static bool JsonStorePacket(PKTTBL_Data_t *TblData, JsonPacket_t *JsonPacket, uint16 PktArrayIdx, bool *ReadPkt)
+{
+
+   bool RetStatus = true;
+   
+   if (!JsonPacket->TopicIdDefined)
+   {
+      *ReadPkt = false;
+   }
+   else if ((JsonPacket->TopicId >= 0) && (JsonPacket->TopicId <= 0xFFFF) &&
+            (JsonPacket->TopicId != PKTTBL_UNUSED_MSG_ID))
+   {
+   
+      if (JsonPacket->AttributeCnt == JSON_PKT_ATTR_CNT)
+      {
+         
+         JsonPacket->Pkt.MsgId = JsonPacket->TopicId;
+         
+         if (!PKTTBL_SetPkt(TblData, &JsonPacket->Pkt))
+         {
+            CFE_EVS_SendEvent(PKTTBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "Packet[%d]'s topic-id %d not loaded, packet table is full with %d entries",
+                              PktArrayIdx, JsonPacket->TopicId, TblData->ActiveCnt);
+         }
+            
+      } /* End if valid attributes */
+      else
+      {
+         CFE_EVS_SendEvent(PKTTBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Packet[%d] has mising attributes, only %d of %d defined",
+                           PktArrayIdx, JsonPacket->AttributeCnt, JSON_PKT_ATTR_CNT);
+         *ReadPkt  = false;
+         RetStatus = false;
+      }
+   } /* End if valid ID */
+   else
+   {
+      CFE_EVS_SendEvent(PKTTBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Packet[%d]'s topic-id %d is not a valid message ID",
+                        PktArrayIdx, JsonPacket->TopicId);
+      RetStatus = false;
+   }
+   
+   return RetStatus;
+   
+} /* End JsonStorePacket() */
+
+
+/******************************************************************************
+** Function: JsonStorePktProfile
+**
+** Add a profile named in a "packet" object's "profiles" array to the
+** packet's profile mask.
+*/
+static bool JsonStorePktProfile(PKTTBL_Data_t *TblData, JsonPacket_t *JsonPacket, uint16 PktArrayIdx, const char *Name)
+{
+
+   uint16 Profile = PKTTBL_GetProfile(TblData, Name);
+   
+   if (Profile < PKTTBL_PROFILE_MAX)
+   {
+      JsonPacket->Pkt.ProfileMask |= (1 << Profile);
+      return true;
+   }
+   
+   CFE_EVS_SendEvent(PKTTBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                     "Packet[%d] references undefined profile '%s'", PktArrayIdx, Name);
+   
+   return false;
+   
+} /* End JsonStorePktProfile() */
+
+
+/******************************************************************************
+** Function: JsonStoreProfileName
+**
+** Append a name from the table's "profiles" array to the staged table.
+*/
+static bool JsonStoreProfileName(PKTTBL_Data_t *TblData, const char *Name)
+{
+
+   if (TblData->ProfileCnt >= PKTTBL_PROFILE_MAX)
+   {
+      CFE_EVS_SendEvent(PKTTBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Profile '%s' exceeds the maximum of %d profiles", Name, PKTTBL_PROFILE_MAX);
+   }
+   else if ((Name[0] == '\0') || (strlen(Name) >= PKTTBL_PROFILE_NAME_LEN))
+   {
+      CFE_EVS_SendEvent(PKTTBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Profile name '%s' must have 1 to %d characters", Name, PKTTBL_PROFILE_NAME_LEN-1);
+   }
+   else if (PKTTBL_GetProfile(TblData, Name) < PKTTBL_PROFILE_MAX)
+   {
+      CFE_EVS_SendEvent(PKTTBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Profile '%s' is defined more than once", Name);
+   }
+   else
+   {
+      strcpy(TblData->ProfileName[TblData->ProfileCnt++], Name);
+      return true;
+   }
+   
+   return false;
+   
+} /* End JsonStoreProfileName() */
+
+
+/******************************************************************************
+** Function: JsonStoreValue
+**
+** Store a numeric "packet" or "filter" attribute. Unknown keys such as 
+** "topic-id-N" are ignored. "max-age" and "coalesce" are optional so they
+** aren't counted as required attributes.
+*/
+static void JsonStoreValue(JsonPacket_t *JsonPacket, bool InFilter, const char *Key, int32 Value)
+{
+
+   uint16 Attribute = 0;
+   
+   if (InFilter)
+   {
+   
+      if      (strcmp(Key, "type") == 0) { JsonPacket->Pkt.Filter.Type    = Value; Attribute = 0x01; }
+      else if (strcmp(Key, "X")    == 0) { JsonPacket->Pkt.Filter.Param.X = Value; Attribute = 0x02; }
+      else if (strcmp(Key, "N")    == 0) { JsonPacket->Pkt.Filter.Param.N = Value; Attribute = 0x04; }
+      else if (strcmp(Key, "O")    == 0) { JsonPacket->Pkt.Filter.Param.O = Value; Attribute = 0x08; }
+   
+   }
+   else
+   {
+      
+      if (strcmp(Key, "topic-id") == 0)
+      {
+         JsonPacket->TopicIdDefined = true;
+         JsonPacket->TopicId = Value;
+      }
+      else if (strcmp(Key, "priority")    == 0) { JsonPacket->Pkt.Qos.Priority    = Value; Attribute = 0x10; }
+      else if (strcmp(Key, "reliability") == 0) { JsonPacket->Pkt.Qos.Reliability = Value; Attribute = 0x20; }
+      else if (strcmp(Key, "buf-limit")   == 0) { JsonPacket->Pkt.BufLim          = Value; Attribute = 0x40; }
+      else if (strcmp(Key, "max-age")     == 0) { JsonPacket->Pkt.MaxAge          = Value; }
+      else if (strcmp(Key, "coalesce")    == 0) { JsonPacket->Pkt.Coalesce        = (Value != 0); }
+   
+   }
+   
+   if ((Attribute != 0) && ((JsonPacket->AttributeMask & Attribute) == 0))
+   {
+      JsonPacket->AttributeMask |= Attribute;
+      JsonPacket->AttributeCnt++;
+   }
+   
+} /* End JsonStoreValue() */
+
+
+/******************************************************************************
+** Function: LoadBinFile
+**
+** Notes:
+**   1. The file is read into the image buffer with a single read and 
+**      validated in place before any table entries are touched.
+**   2. A binary image defines the complete table so it replaces the staged
+**      table contents.
+*/
+static bool LoadBinFile(PKTTBL_Data_t *TblData, const char *Filename, uint16 *PktCnt)
+{
+
+   bool          RetStatus = false;
+   osal_id_t     FileHandle;
+   int32         OsStatus;
+   int32         ReadLen;
+   uint16        Crc;
+   uint16        i;
+   os_err_name_t OsErrStr;
+   
+   PKTTBL_Pkt_t     Pkt;
+   PKTTBL_BinHdr_t  *Hdr = &BinImage.Hdr;
+
+
+   *PktCnt = 0;
+
+   OsStatus = OS_OpenCreate(&FileHandle, Filename, OS_FILE_FLAG_NONE, OS_READ_ONLY);
+   if (OsStatus != OS_SUCCESS)
+   {
+      OS_GetErrorName(OsStatus, &OsErrStr);
+      CFE_EVS_SendEvent(PKTTBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Error opening table file '%s', Status = %s", Filename, OsErrStr);
+      return false;
+   }
+   
+   ReadLen = OS_read(FileHandle, &BinImage, sizeof(PKTTBL_BinImage_t));
+   OS_close(FileHandle);
+   
+   if (ReadLen < (int32)sizeof(PKTTBL_BinHdr_t))
+   {
+      CFE_EVS_SendEvent(PKTTBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Binary table file '%s' is too short, read %d bytes", Filename, ReadLen);
+   }
+   else if ((Hdr->Magic != PKTTBL_BIN_MAGIC) || (Hdr->Version != PKTTBL_BIN_VERSION) ||
+            (Hdr->EntrySize != sizeof(PKTTBL_BinPkt_t)))
+   {
+      CFE_EVS_SendEvent(PKTTBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Binary table file '%s' header mismatch. Magic 0x%08X, version %d, entry size %d. Expected 0x%08X, %d, %d",
+                        Filename, (unsigned int)Hdr->Magic, Hdr->Version, Hdr->EntrySize,
+                        PKTTBL_BIN_MAGIC, PKTTBL_BIN_VERSION, (int)sizeof(PKTTBL_BinPkt_t));
+   }
+   else if ((Hdr->EntryCnt == 0) || (Hdr->EntryCnt > PKTTBL_MAX_SLOTS) || (Hdr->ProfileCnt > PKTTBL_PROFILE_MAX) ||
+            (ReadLen != (int32)(sizeof(PKTTBL_BinHdr_t) + Hdr->EntryCnt*sizeof(PKTTBL_BinPkt_t))))
+   {
+      CFE_EVS_SendEvent(PKTTBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Binary table file '%s' has %d entries, %d profiles and %d bytes which is inconsistent or exceeds the table limits of %d and %d",
+                        Filename, Hdr->EntryCnt, Hdr->ProfileCnt, ReadLen, PKTTBL_MAX_SLOTS, PKTTBL_PROFILE_MAX);
+   }
+   else
+   {
+      
+      Crc = CFE_ES_CalculateCRC(Hdr->ProfileName, sizeof(Hdr->ProfileName), 0, CFE_MISSION_ES_DEFAULT_CRC);
+      Crc = CFE_ES_CalculateCRC(BinImage.Pkt, Hdr->EntryCnt*sizeof(PKTTBL_BinPkt_t), Crc, CFE_MISSION_ES_DEFAULT_CRC);
+      
+      if (Crc == Hdr->Crc)
+      {
+         
+         RetStatus = true;
+         PKTTBL_SetTblToUnused(TblData);
+         
+         TblData->ProfileCnt = Hdr->ProfileCnt;
+         for (i=0; i < Hdr->ProfileCnt; i++)
          {
+            strncpy(TblData->ProfileName[i], Hdr->ProfileName[i], PKTTBL_PROFILE_NAME_LEN);
+            TblData->ProfileName[i][PKTTBL_PROFILE_NAME_LEN-1] = '\0';
+         }
          
-            AttributeCnt = 0;
-            if (CJSON_LoadObj(&JsonPacket.Priority.Obj,    PktTbl->JsonBuf, PktTbl->JsonFileLen)) AttributeCnt++;
-            if (CJSON_LoadObj(&JsonPacket.Reliability.Obj, PktTbl->JsonBuf, PktTbl->JsonFileLen)) AttributeCnt++;
-            if (CJSON_LoadObj(&JsonPacket.BufLimit.Obj,    PktTbl->JsonBuf, PktTbl->JsonFileLen)) AttributeCnt++;
-            if (CJSON_LoadObj(&JsonPacket.FilterType.Obj,  PktTbl->JsonBuf, PktTbl->JsonFileLen)) AttributeCnt++;
-            if (CJSON_LoadObj(&JsonPacket.FilterX.Obj,     PktTbl->JsonBuf, PktTbl->JsonFileLen)) AttributeCnt++;
-            if (CJSON_LoadObj(&JsonPacket.FilterN.Obj,     PktTbl->JsonBuf, PktTbl->JsonFileLen)) AttributeCnt++;
-            if (CJSON_LoadObj(&JsonPacket.FilterO.Obj,     PktTbl->JsonBuf, PktTbl->JsonFileLen)) AttributeCnt++;
+         for (i=0; i < Hdr->EntryCnt; i++)
+         {
             
-            if (AttributeCnt == 7)
-            {
-               
-               Pkt.MsgId           = JsonPacket.TopicId.Value;
-               Pkt.Qos.Priority    = JsonPacket.Priority.Value;
-               Pkt.Qos.Reliability = JsonPacket.Reliability.Value;
-               Pkt.BufLim          = JsonPacket.BufLimit.Value;
-               Pkt.Filter.Type     = JsonPacket.FilterType.Value;
-               Pkt.Filter.Param.X  = JsonPacket.FilterX.Value; 
-               Pkt.Filter.Param.N  = JsonPacket.FilterN.Value; 
-               Pkt.Filter.Param.O  = JsonPacket.FilterO.Value; 
-                              
-               memcpy(&TblData.Pkt[AppIdIdx],&Pkt,sizeof(PKTTBL_Pkt_t));
-               
-            } /* End if valid attributes */
-            else
+            PKTTBL_UnpackBinPkt(&Pkt, &BinImage.Pkt[i]);
+            
+            if (!PKTTBL_SetPkt(TblData, &Pkt))
             {
                CFE_EVS_SendEvent(PKTTBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
-                                 "Packet[%d] has mising attributes, only %d of 7 defined",
-                                 PktArrayIdx, AttributeCnt);
-               ReadPkt = false;
+                                 "Binary table entry[%d] has an invalid message ID 0x%04X",
+                                 i, Pkt.MsgId);
                RetStatus = false;
+               break;
             }
-         } /* End if valid ID */
-         else
-         {
-            CFE_EVS_SendEvent(PKTTBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
-                              "Packet[%d]'s topic-id %d has an invlaid app-id value of %d. Valid range is 0 to %d",
-                              PktArrayIdx, JsonPacket.TopicId.Value, AppIdIdx, (PKTUTIL_MAX_APP_ID-1));
-         }
-
-         PktArrayIdx++;
          
-      } /* End if 'topic-id' */
+         } /* End entry loop */
+         
+         if (RetStatus) *PktCnt = Hdr->EntryCnt;
+      
+      } /* End if valid CRC */
       else
       {
-         ReadPkt = false;
+         CFE_EVS_SendEvent(PKTTBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Binary table file '%s' CRC 0x%04X doesn't match computed CRC 0x%04X",
+                           Filename, Hdr->Crc, Crc);
+      }
+   
+   } /* End if valid header */
+   
+   return RetStatus;
+   
+} /* End LoadBinFile() */
+
+
+/******************************************************************************
+** Function: LoadJsonFile
+**
+** Notes:
+**  1. The JSON file can contain 1 to PKTTBL_MAX_SLOTS entries. The table can
+**     be sparsely populated. 
+**  2. JSON "packet-array" contains the following "packet" object entries
+**       {"packet": {
+**          "name": "ES_APP_TLM_TOPICID",  # Not saved
+**          "topic-id-N": 0,               # Not saved
+**          "topic-id": 0,
+**          "priority": 0,
+**          "reliability": 0,
+**          "buf-limit": 4,
+**          "max-age": 5000,               # Optional, ms
+**          "coalesce": 1,                 # Optional, 1=Send newest per cycle
+**          "filter": { "type": 2, "X": 1, "N": 1, "O": 0}
+**       }},
+**  3. An optional "profiles" array of up to PKTTBL_PROFILE_MAX names must
+**     precede the "packet-array" and replaces the staged profile names. A
+**     packet's optional "profiles" array lists the profiles it belongs to, 
+**     packets without one belong to all profiles.
+**  4. The file is tokenized in a single pass while it is read so load time
+**     is linear in the file size and there's no file size limit. Objects
+**     outside of the "packet-array" are skipped.
+*/
+static bool LoadJsonFile(PKTTBL_Data_t *TblData, const char *Filename, uint16 *PktArrayCnt)
+{
+
+   bool    RetStatus = true;
+   bool    ReadPkt   = true;
+   bool    KeyDefined = false;
+   uint16  Depth = 0;
+   uint16  PktArrayDepth = 0;
+   uint16  PktDepth      = 0;
+   uint16  FilterDepth   = 0;
+   uint16  ProfileDepth    = 0;
+   uint16  PktProfileDepth = 0;
+   uint16  PktArrayIdx   = 0;
+   int32   OsStatus;
+   char    Key[JSON_STR_MAX] = "";
+   char    LastStr[JSON_STR_MAX] = "";
+   char    Container[JSON_MAX_DEPTH];
+   
+   os_err_name_t OsErrStr;
+   JsonReader_t  Reader;
+   JsonToken_t   Token;
+   JsonPacket_t  JsonPacket;
+
+
+   *PktArrayCnt = 0;
+
+   OsStatus = OS_OpenCreate(&Reader.FileHandle, Filename, OS_FILE_FLAG_NONE, OS_READ_ONLY);
+   if (OsStatus != OS_SUCCESS)
+   {
+      OS_GetErrorName(OsStatus, &OsErrStr);
+      CFE_EVS_SendEvent(PKTTBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Error opening table file '%s', Status = %s", Filename, OsErrStr);
+      return false;
+   }
+   
+   Reader.BufLen       = 0;
+   Reader.BufIdx       = 0;
+   Reader.UngetChar    = -1;
+   Reader.LineNum      = 1;
+   Reader.TokenTooLong = false;
+   
+   /* 
+   ** The staged table starts as a copy of the owner's table and the JSON
+   ** supplied values are merged into it. PKTTBL_Execute() applies it.
+   */
+
+   while (ReadPkt)
+   {
+      
+      JsonNextToken(&Reader, &Token);
+      
+      switch (Token.Type)
+      {
+         
+         case JSON_TOKEN_OBJ_START:
+         case JSON_TOKEN_ARRAY_START:
+            
+            if (Depth >= JSON_MAX_DEPTH)
+            {
+               Token.Type = JSON_TOKEN_ERROR;
+               break;
+            }
+            Container[Depth++] = (Token.Type == JSON_TOKEN_OBJ_START) ? '{' : '[';
+            
+            if (!KeyDefined) Key[0] = '\0';
+            KeyDefined = false;
+            
+            if (Token.Type == JSON_TOKEN_ARRAY_START)
+            {
+               if ((PktArrayDepth == 0) && (Depth == 2) && (strcmp(Key, "packet-array") == 0)) PktArrayDepth = Depth;
+               else if ((PktArrayDepth == 0) && (Depth == 2) && (strcmp(Key, "profiles") == 0))
+               {
+                  ProfileDepth = Depth;
+                  TblData->ProfileCnt = 0;
+                  CFE_PSP_MemSet(TblData->ProfileName, 0, sizeof(TblData->ProfileName));
+               }
+               else if ((PktDepth > 0) && (Depth == (PktDepth+1)) && (strcmp(Key, "profiles") == 0))
+               {
+                  PktProfileDepth = Depth;
+                  JsonPacket.Pkt.ProfileMask = 0;
+               }
+            }
+            else if ((PktArrayDepth > 0) && (PktDepth == 0) && (strcmp(Key, "packet") == 0))
+            {
+               PktDepth = Depth;
+               CFE_PSP_MemSet(&JsonPacket, 0, sizeof(JsonPacket_t));
+               JsonPacket.Pkt.ProfileMask = PKTTBL_ALL_PROFILES;
+            }
+            else if ((PktDepth > 0) && (Depth == (PktDepth+1)) && (strcmp(Key, "filter") == 0))
+            {
+               FilterDepth = Depth;
+            }
+            break;
+            
+         case JSON_TOKEN_OBJ_END:
+         case JSON_TOKEN_ARRAY_END:
+         
+            if ((Depth == 0) || (Container[Depth-1] != ((Token.Type == JSON_TOKEN_OBJ_END) ? '{' : '[')))
+            {
+               Token.Type = JSON_TOKEN_ERROR;
+               break;
+            }
+            
+            if (Depth == FilterDepth)
+            {
+               FilterDepth = 0;
+            }
+            else if (Depth == ProfileDepth)
+            {
+               ProfileDepth = 0;
+            }
+            else if (Depth == PktProfileDepth)
+            {
+               PktProfileDepth = 0;
+            }
+            else if (Depth == PktDepth)
+            {
+               PktDepth = 0;
+               if (!JsonStorePacket(TblData, &JsonPacket, PktArrayIdx, &ReadPkt)) RetStatus = false;
+               if (ReadPkt) PktArrayIdx++;
+            }
+            else if (Depth == PktArrayDepth)
+            {
+               ReadPkt = false;
+            }
+            --Depth;
+            KeyDefined = false;
+            break;
+         
+         case JSON_TOKEN_STRING:
+            strcpy(LastStr, Token.Str);
+            KeyDefined = false;
+            if ((ProfileDepth > 0) && (Depth == ProfileDepth))
+            {
+               if (!JsonStoreProfileName(TblData, Token.Str)) RetStatus = false;
+            }
+            else if ((PktProfileDepth > 0) && (Depth == PktProfileDepth))
+            {
+               if (!JsonStorePktProfile(TblData, &JsonPacket, PktArrayIdx, Token.Str)) RetStatus = false;
+            }
+            break;
+            
+         case JSON_TOKEN_COLON:
+            strcpy(Key, LastStr);
+            KeyDefined = true;
+            break;
+            
+         case JSON_TOKEN_NUMBER:
+            if (KeyDefined && (PktDepth > 0))
+            {
+               if (Depth == FilterDepth)
+               {
+                  JsonStoreValue(&JsonPacket, true, Key, Token.Number);
+               }
+               else if (Depth == PktDepth)
+               {
+                  JsonStoreValue(&JsonPacket, false, Key, Token.Number);
+               }
+            }
+            KeyDefined = false;
+            break;
+            
+         case JSON_TOKEN_COMMA:
+         case JSON_TOKEN_LITERAL:
+            KeyDefined = false;
+            break;
+            
+         case JSON_TOKEN_EOF:
+            if (Depth > 0) Token.Type = JSON_TOKEN_ERROR;
+            ReadPkt = false;
+            break;
+         
+         default:
+            break;
+            
+      } /* End token switch */
+      
+      if (Token.Type == JSON_TOKEN_ERROR)
+      {
+         CFE_EVS_SendEvent(PKTTBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "JSON %s in table file '%s' at line %d",
+                           Reader.TokenTooLong ? "string or number too long" : "syntax error",
+                           Filename, Reader.LineNum);
+         ReadPkt   = false;
+         RetStatus = false;
       }
       
    } /* End ReadPkt */
    
+   OS_close(Reader.FileHandle);
+   
    if (PktArrayIdx == 0)
    {
       CFE_EVS_SendEvent(PKTTBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
                         "JSON table file has no message entries");
+      RetStatus = false;
+   }
+   
+   *PktArrayCnt = PktArrayIdx;
+   
+   return RetStatus;
+   
+} /* End LoadJsonFile() */
+
+
+/******************************************************************************
+** Function: LockFileIo
+**
+** Take an instance's file I/O state mutex. Inline instances don't have one
+** and are only accessed by the caller's task.
+*/
+static void LockFileIo(PKTTBL_FileIo_t *FileIo)
+{
+
+   if (!FileIo->Inline) OS_MutSemTake(FileIo->StateMutex);
+
+} /* End LockFileIo() */
+
+
+/******************************************************************************
+** Function: PerformFileIo
+**
+** Perform the current file I/O request using the staging table. Called by
+** the child task or inline when the child task isn't running.
+*/
+static void PerformFileIo(PKTTBL_Class_t *PktTbl)
+{
+
+   PKTTBL_FileIo_t *FileIo  = &(PktTbl->FileIo);
+   PKTTBL_Data_t   *TblData = &(FileIo->Stage);
+   bool   Result;
+   uint16 PktCnt = 0;
+   
+   if (FileIo->Op != PKTTBL_FILE_IO_DUMP)
+   {
+      if (IsBinFile(FileIo->Filename))
+      {
+         Result = LoadBinFile(TblData, FileIo->Filename, &PktCnt);
+      }
+      else
+      {
+         Result = LoadJsonFile(TblData, FileIo->Filename, &PktCnt);
+      }
    }
    else
    {
-      if (RetStatus == true)
+      PktCnt = TblData->ActiveCnt;
+      if (IsBinFile(FileIo->Filename))
+      {
+         Result = DumpBinFile(TblData, FileIo->Filename);
+      }
+      else
       {
-         PktTbl->LoadNewTbl(&TblData);
-         PktTbl->LastLoadCnt = PktArrayIdx;
-         CFE_EVS_SendEvent(PKTTBL_LOAD_EID, CFE_EVS_EventType_INFORMATION,
-                           "Packet Table load updated %d entries", PktArrayIdx);
+         Result = DumpJsonFile(TblData, FileIo->Filename);
       }
    }
    
-   return RetStatus;
+   LockFileIo(FileIo);
+   FileIo->Result = Result;
+   FileIo->PktCnt = PktCnt;
+   FileIo->State  = PKTTBL_FILE_IO_DONE;
+   UnlockFileIo(FileIo);
+
+} /* End PerformFileIo() */
+
+
+/******************************************************************************
+** Function: StartFileIo
+**
+** Stage a copy of the table and start a load or dump request. Returns false
+** if a request is already in progress.
+**
+** Notes:
+**   1. If the child task isn't running or the instance has no mutex the
+**      request is performed and completed before returning.
+*/
+static bool StartFileIo(PKTTBL_Class_t *PktTbl, PKTTBL_FileIoOp_t Op, const char *Filename)
+{
+
+   PKTTBL_FileIo_t *FileIo  = &(PktTbl->FileIo);
+   PKTTBL_Data_t   *TblData = &(FileIo->Stage);
+   PKTTBL_FileIoState_t State;
+   
+   LockFileIo(FileIo);
+   State = FileIo->State;
+   UnlockFileIo(FileIo);
+   
+   if (State != PKTTBL_FILE_IO_IDLE)
+   {
+      CFE_EVS_SendEvent(PKTTBL_TBL_BUSY_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Packet table %s of '%s' rejected, %s of '%s' in progress",
+                        FileIoOpStr[Op], Filename, FileIoOpStr[FileIo->Op], FileIo->Filename);
+      return false;
+   }
+   
+   memcpy(TblData, &PktTbl->Data, sizeof(PKTTBL_Data_t));
+   
+   FileIo->Op        = Op;
+   FileIo->StartTime = CFE_TIME_GetTime();
+   strncpy(FileIo->Filename, Filename, OS_MAX_PATH_LEN);
+   FileIo->Filename[OS_MAX_PATH_LEN-1] = '\0';
+   
+   LockFileIo(FileIo);
+   FileIo->State     = PKTTBL_FILE_IO_PENDING;
+   UnlockFileIo(FileIo);
+   
+   if (ChildActive && !FileIo->Inline)
+   {
+      OS_BinSemGive(WakeSem);
+   }
+   else
+   {
+      PerformFileIo(PktTbl);
+      PKTTBL_Execute(PktTbl);
+   }
    
-} /* End LoadJsonData() */
+   return true;
+
+} /* End StartFileIo() */
+
+
+/******************************************************************************
+** Function: UnlockFileIo
+**
+*/
+static void UnlockFileIo(PKTTBL_FileIo_t *FileIo)
+{
+
+   if (!FileIo->Inline) OS_MutSemGive(FileIo->StateMutex);
+
+} /* End UnlockFileIo() */
 
 
 /******************************************************************************
@@ -444,32 +1785,61 @@ static bool LoadJsonData(size_t JsonFileLen)
 ** Notes:
 **   1. Can't end last record with a comma so logic checks that commas only
 **      start to be written after the first packet has been written
+**   2. Profile names are taken from the staged table being dumped
 */
-static bool WriteJsonPkt(int32 FileHandle, const PKTTBL_Pkt_t* Pkt, bool FirstPktWritten)
+static bool WriteJsonPkt(const PKTTBL_Data_t *TblData, DumpBuf_t *Dump, const PKTTBL_Pkt_t* Pkt, bool FirstPktWritten)
 {
    
-   bool PktWritten = false;
-   char DumpRecord[256];
+   bool   PktWritten = false;
+   bool   FirstProfile = true;
+   uint16 Profile;
+   uint8  ProfileMask = (uint8)((1 << TblData->ProfileCnt) - 1);
+   char   DumpRecord[256];
 
    if (Pkt->MsgId != PKTTBL_UNUSED_MSG_ID)
    {
       
       if (FirstPktWritten)
       {
-         sprintf(DumpRecord,",\n");
-         OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+         DumpBufWrite(Dump, ",\n");
       }
       
-      sprintf(DumpRecord,"\"packet\": {\n");
-      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+      DumpBufWrite(Dump, "\"packet\": {\n");
 
       sprintf(DumpRecord,"   \"topic-id\": %d,\n   \"priority\": %d,\n   \"reliability\": %d,\n   \"buf-limit\": %d,\n",
               Pkt->MsgId, Pkt->Qos.Priority, Pkt->Qos.Reliability, Pkt->BufLim);
-      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+      DumpBufWrite(Dump, DumpRecord);
+      
+      if (Pkt->MaxAge != 0)
+      {
+         sprintf(DumpRecord,"   \"max-age\": %d,\n", Pkt->MaxAge);
+         DumpBufWrite(Dump, DumpRecord);
+      }
+      
+      if (Pkt->Coalesce)
+      {
+         DumpBufWrite(Dump, "   \"coalesce\": 1,\n");
+      }
+      
+      /* Entries in every defined profile omit the list and default to all profiles when loaded */
+      if ((Pkt->ProfileMask & ProfileMask) != ProfileMask)
+      {
+         DumpBufWrite(Dump, "   \"profiles\": [");
+         for (Profile=0; Profile < TblData->ProfileCnt; Profile++)
+         {
+            if (PKTTBL_IN_PROFILE(Pkt, Profile))
+            {
+               sprintf(DumpRecord, "%s\"%s\"", (FirstProfile ? " " : ", "), TblData->ProfileName[Profile]);
+               DumpBufWrite(Dump, DumpRecord);
+               FirstProfile = false;
+            }
+         }
+         DumpBufWrite(Dump, " ],\n");
+      }
       
       sprintf(DumpRecord,"   \"filter\": { \"type\": %d, \"X\": %d, \"N\": %d, \"O\": %d}\n}",
               Pkt->Filter.Type, Pkt->Filter.Param.X, Pkt->Filter.Param.N, Pkt->Filter.Param.O);
-      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+      DumpBufWrite(Dump, DumpRecord);
    
       PktWritten = true;
       
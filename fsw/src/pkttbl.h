@@ -16,10 +16,10 @@
 **    Define KIT_TO's Packet Table management functions
 **
 **  Notes:
-**    1. Use the Singleton design pattern. A pointer to the table object
-**       is passed to the constructor and saved for all other operations.
-**       This is a table-specific file so it doesn't need to be re-entrant.
-**    2. The table file is a JSON text file.
+**    1. Each output channel constructs its own table object and a pointer
+**       to it is passed to every function. The table manager callbacks
+**       don't have a context so instances are also indexed by table ID.
+**    2. The table file is a JSON text file or a binary image.
 **
 **  References:
 **    1. OpenSatKit Object-based Application Developer's Guide
@@ -39,10 +39,38 @@
 /** Macro Definitions **/
 /***********************/
 
-#define PKTTBL_APP_ID_MASK   (0x07FF)  /* CCSDS v1 ApId mask    */
+#define PKTTBL_MAX_SLOTS     PKTUTIL_MAX_APP_ID   /* Must be a power of 2 */
+#define PKTTBL_SLOT_MASK     (PKTTBL_MAX_SLOTS-1)
+
+#define PKTTBL_MAX_INSTANCES PKTMGR_MAX_CHANNELS  /* One table per output channel */
 
 #define PKTTBL_UNUSED_MSG_ID CFE_SB_MsgIdToValue(CFE_SB_INVALID_MSG_ID)
 
+/*
+** Subscription profiles
+** - Each entry has a bit mask of the profiles it belongs to. Entries that
+**   don't specify profiles belong to all of them.
+** - A table without profile names has a single unnamed profile 0
+*/
+
+#define PKTTBL_PROFILE_MAX       8
+#define PKTTBL_PROFILE_NAME_LEN  16
+#define PKTTBL_ALL_PROFILES      0xFF
+
+#define PKTTBL_IN_PROFILE(PktPtr, Profile)  ((((PktPtr)->ProfileMask) >> (Profile)) & 1)
+
+/*
+** Binary table image
+** - Files with this extension are loaded and dumped as binary images
+** - The magic number is "KTPT" when written as a little endian uint32
+*/
+
+#define PKTTBL_BIN_FILE_EXT  ".bin"
+#define PKTTBL_BIN_MAGIC     0x5450544B
+#define PKTTBL_BIN_VERSION   3
+
+#define PKTTBL_BIN_FLAG_COALESCE  0x01
+
 /*
 ** Event Message IDs
 */
@@ -50,6 +78,10 @@
 #define PKTTBL_CREATE_FILE_ERR_EID (PKTTBL_BASE_EID + 0)
 #define PKTTBL_LOAD_EID            (PKTTBL_BASE_EID + 1)
 #define PKTTBL_LOAD_ERR_EID        (PKTTBL_BASE_EID + 2)
+#define PKTTBL_CHILD_TASK_ERR_EID  (PKTTBL_BASE_EID + 3)
+#define PKTTBL_TBL_BUSY_ERR_EID    (PKTTBL_BASE_EID + 4)
+#define PKTTBL_FILE_IO_DONE_EID    (PKTTBL_BASE_EID + 5)
+#define PKTTBL_INSTANCE_ERR_EID    (PKTTBL_BASE_EID + 6)
 
 
 /**********************/
@@ -70,19 +102,141 @@ typedef struct
 
    PktUtil_Filter_t Filter;
    
+   uint8         ProfileMask;
+   uint16        MaxAge;       /* Milliseconds, packets older than this are dropped, 0=No limit */
+   bool          Coalesce;     /* Only the newest packet read in an output cycle is sent */
+   
 } PKTTBL_Pkt_t;
 
 
+/*
+** Table data
+**
+** - Pkt[] is an open addressing hash table keyed by the full message ID
+**   using linear probing. Removing an entry shifts later entries of its
+**   probe sequence back into the freed slot so probe lengths don't grow
+**   with churn. An entry's slot can change when another entry is removed
+**   so owners that keep per-slot runtime data must check it against the
+**   slot's message ID.
+** - ActiveIdx[] is a dense list of the slots in use sorted by message ID.
+**   Table-wide operations iterate over ActiveIdx[] so their cost scales
+**   with the number of active entries rather than the table size.
+** - Use PKTTBL_SetPkt() and PKTTBL_RemovePkt() to modify entries so the 
+**   hash table and active index stay consistent.
+** - ProfileName[i] is the name of the profile selected by bit i of an
+**   entry's ProfileMask.
+*/
 typedef struct
 {
    
-   PKTTBL_Pkt_t Pkt[PKTUTIL_MAX_APP_ID];
+   PKTTBL_Pkt_t Pkt[PKTTBL_MAX_SLOTS];
+
+   uint16  ActiveCnt;
+   uint16  ActiveIdx[PKTTBL_MAX_SLOTS];
+
+   uint16  ProfileCnt;
+   char    ProfileName[PKTTBL_PROFILE_MAX][PKTTBL_PROFILE_NAME_LEN];
 
 } PKTTBL_Data_t;
 
 
+/*
+** Binary table image
+**
+** - The image contains a header followed by the active table entries. The
+**   entry layout is fixed so ground tools don't depend on the FSW structure
+**   definitions. Values are in the target's native byte order.
+** - The CRC is computed with CFE_ES_CalculateCRC() using the mission default
+**   CRC type over the profile names followed by the entry array.
+** - Entry Flags bits are defined by PKTTBL_BIN_FLAG_xxx. Undefined bits are
+**   zero so images written before a flag was defined load with it cleared.
+*/
+typedef struct
+{
+
+   uint32  Magic;
+   uint16  Version;
+   uint16  EntrySize;   /* sizeof(PKTTBL_BinPkt_t) */
+   uint16  EntryCnt;
+   uint16  Crc;
+   uint16  ProfileCnt;
+   uint16  Spare;
+   char    ProfileName[PKTTBL_PROFILE_MAX][PKTTBL_PROFILE_NAME_LEN];
+
+} PKTTBL_BinHdr_t;
+
+typedef struct
+{
+
+   uint16  MsgId;
+   uint8   Priority;
+   uint8   Reliability;
+   uint16  BufLim;
+   uint16  FilterType;
+   uint16  FilterN;
+   uint16  FilterX;
+   uint16  FilterO;
+   uint8   ProfileMask;
+   uint8   Flags;
+   uint16  MaxAge;
+
+} PKTTBL_BinPkt_t;
+
+typedef struct
+{
+
+   PKTTBL_BinHdr_t  Hdr;
+   PKTTBL_BinPkt_t  Pkt[PKTTBL_MAX_SLOTS];
+
+} PKTTBL_BinImage_t;
+
+
+/*
+** Table file I/O is performed by a child task shared by all table instances.
+** Only one load or dump can be in progress per instance. The child owns the
+** instance's staging table while the state is PENDING and the main task owns
+** it otherwise.
+*/
+typedef enum
+{
+
+   PKTTBL_FILE_IO_IDLE = 1,
+   PKTTBL_FILE_IO_PENDING,
+   PKTTBL_FILE_IO_DONE
+
+} PKTTBL_FileIoState_t;
+
+typedef enum
+{
+
+   PKTTBL_FILE_IO_LOAD = 1,
+   PKTTBL_FILE_IO_DUMP,
+   PKTTBL_FILE_IO_PLAN
+
+} PKTTBL_FileIoOp_t;
+
+typedef struct
+{
+
+   osal_id_t             StateMutex;
+   bool                  Inline;        /* True if the mutex couldn't be created, I/O is done by the caller */
+   
+   PKTTBL_FileIoState_t  State;
+   PKTTBL_FileIoOp_t     Op;
+   bool                  Result;
+   uint16                PktCnt;
+   CFE_TIME_SysTime_t    StartTime;
+   char                  Filename[OS_MAX_PATH_LEN];
+   PKTTBL_Data_t         Stage;         /* Staging table for file I/O */
+
+} PKTTBL_FileIo_t;
+
+
 /* Callback function for table owner to perform the load */
-typedef bool (*PKTTBL_LoadNewTbl_t)(PKTTBL_Data_t* NewTbl);
+typedef bool (*PKTTBL_LoadNewTbl_t)(void *Owner, PKTTBL_Data_t* NewTbl);
+
+/* Callback function for table owner to evaluate a table without loading it */
+typedef void (*PKTTBL_PlanNewTbl_t)(void *Owner, const PKTTBL_Data_t* NewTbl, const char *Filename);
 
 
 typedef struct
@@ -94,20 +248,22 @@ typedef struct
    
    PKTTBL_Data_t Data;
 
+   void                *Owner;    /* Passed to the owner's callbacks */
    PKTTBL_LoadNewTbl_t LoadNewTbl;
+   PKTTBL_PlanNewTbl_t PlanNewTbl;
 
    /*
-   ** Standard CJSON table data
+   ** Standard table data
    */
    
    const char  *AppName;
+   uint8       TblId;    /* Table manager ID used to route load and dump commands */
    bool        Loaded;   /* Has entire table been loaded? */
    uint8       LastLoadStatus;
    uint16      LastLoadCnt;
+   uint32      LastLoadMs;   /* Time from load command to the new table being applied */
    
-   size_t      JsonObjCnt;
-   char        JsonBuf[PKTTBL_JSON_FILE_MAX_CHAR];   
-   size_t      JsonFileLen;
+   PKTTBL_FileIo_t  FileIo;
 
 } PKTTBL_Class_t;
 
@@ -125,9 +281,15 @@ typedef struct
 ** Notes:
 **   1. The table values are not populated. This is done when the table is 
 **      registered with the table manager.
+**   2. The first instance creates the child task that performs table file
+**      I/O for all instances. If the child can't be created loads and dumps
+**      are performed on the caller's task.
+**   3. TblId must be the ID the table manager assigns when the instance is
+**      registered. IDs are assigned in registration order.
 */
-void PKTTBL_Constructor(PKTTBL_Class_t *ObjPtr, const char *AppName,
-                        PKTTBL_LoadNewTbl_t LoadNewTbl);
+void PKTTBL_Constructor(PKTTBL_Class_t *PktTbl, INITBL_Class_t *IniTbl,
+                        const char *AppName, uint8 TblId, void *Owner,
+                        PKTTBL_LoadNewTbl_t LoadNewTbl, PKTTBL_PlanNewTbl_t PlanNewTbl);
 
 
 /******************************************************************************
@@ -139,11 +301,60 @@ void PKTTBL_Constructor(PKTTBL_Class_t *ObjPtr, const char *AppName,
 **  1. Function signature must match TBLMGR_DumpTblFuncPtr_t.
 **  2. Can assume valid table file name because this is a callback from 
 **     the app framework table manager.
+**  3. A file name with the PKTTBL_BIN_FILE_EXT extension is dumped as a
+**     binary image, otherwise a JSON file is written.
+**  4. The table is copied and the file is written by the child task. A
+**     completion event is sent by PKTTBL_Execute().
 **
 */
 bool PKTTBL_DumpCmd(TBLMGR_Tbl_t *Tbl, uint8 DumpType, const char *Filename);
 
 
+/******************************************************************************
+** Function: PKTTBL_Execute
+**
+** Complete a table load, dump or plan that was performed by the child task.
+** A loaded table is passed to the table owner's LoadNewTbl() callback and a
+** planned table is passed to the PlanNewTbl() callback.
+**
+** Notes:
+**   1. Must be called by the main task at a point in its execution cycle
+**      where the packet table may change.
+**
+*/
+void PKTTBL_Execute(PKTTBL_Class_t *PktTbl);
+
+
+/******************************************************************************
+** Function: PKTTBL_GetHashStats
+**
+** Compute the number of active entries that are not in their home slot and
+** the longest probe sequence needed to find an active entry.
+**
+*/
+void PKTTBL_GetHashStats(const PKTTBL_Data_t *TblPtr, uint16 *Collisions, uint16 *MaxProbe);
+
+
+/******************************************************************************
+** Function: PKTTBL_GetPkt
+**
+** Return a pointer to the table entry for MsgId or NULL if MsgId is not in
+** the table.
+**
+*/
+PKTTBL_Pkt_t *PKTTBL_GetPkt(PKTTBL_Data_t *TblPtr, uint16 MsgId);
+
+
+/******************************************************************************
+** Function: PKTTBL_GetProfile
+**
+** Return the index of the profile named Name or PKTTBL_PROFILE_MAX if the
+** table doesn't define it.
+**
+*/
+uint16 PKTTBL_GetProfile(const PKTTBL_Data_t *TblPtr, const char *Name);
+
+
 /******************************************************************************
 ** Function: PKTTBL_LoadCmd
 **
@@ -153,11 +364,51 @@ bool PKTTBL_DumpCmd(TBLMGR_Tbl_t *Tbl, uint8 DumpType, const char *Filename);
 **  1. Function signature must match TBLMGR_LoadTblFuncPtr_t.
 **  2. Can assume valid table file name because this is a callback from 
 **     the app framework table manager.
+**  3. A file name with the PKTTBL_BIN_FILE_EXT extension is loaded as a
+**     binary image which replaces the table. JSON files update the current
+**     table with the file's entries.
+**  4. The file is read and parsed by the child task into a staging table.
+**     A true return means the load was started. The new table is applied
+**     and a completion event is sent by PKTTBL_Execute().
+**  5. Table changes made by commands while a JSON load is in progress are
+**     overwritten when the staged table is applied.
 **
 */
 bool PKTTBL_LoadCmd(TBLMGR_Tbl_t *Tbl, uint8 LoadType, const char *Filename);
 
 
+/******************************************************************************
+** Function: PKTTBL_PackBinPkt
+**
+** Copy a table entry into the fixed binary image entry layout.
+**
+*/
+void PKTTBL_PackBinPkt(PKTTBL_BinPkt_t *BinPkt, const PKTTBL_Pkt_t *Pkt);
+
+
+/******************************************************************************
+** Function: PKTTBL_PlanCmd
+**
+** Read a table file the same way as PKTTBL_LoadCmd() and pass the result to
+** the table owner's PlanNewTbl() callback rather than loading it.
+**
+** Notes:
+**   1. A true return means the file read was started. 
+**
+*/
+bool PKTTBL_PlanCmd(PKTTBL_Class_t *PktTbl, const char *Filename);
+
+
+/******************************************************************************
+** Function: PKTTBL_RemovePkt
+**
+** Remove MsgId's entry from the table. Returns false if MsgId is not in the
+** table.
+**
+*/
+bool PKTTBL_RemovePkt(PKTTBL_Data_t *TblPtr, uint16 MsgId);
+
+
 /******************************************************************************
 ** Function: PKTTBL_ResetStatus
 **
@@ -166,7 +417,7 @@ bool PKTTBL_LoadCmd(TBLMGR_Tbl_t *Tbl, uint8 LoadType, const char *Filename);
 ** and flags to a known default state for telemetry.
 **
 */
-void PKTTBL_ResetStatus(void);
+void PKTTBL_ResetStatus(PKTTBL_Class_t *PktTbl);
 
 
 /******************************************************************************
@@ -176,11 +427,34 @@ void PKTTBL_ResetStatus(void);
 void PKTTBL_SetPacketToUnused(PKTTBL_Pkt_t *PktPtr);
 
 
+/******************************************************************************
+** Function: PKTTBL_SetPkt
+**
+** Add a new entry or update an existing entry with the same message ID.
+**
+** Notes:
+**   1. Returns false if the table is full. The table is not modified.
+*/
+bool PKTTBL_SetPkt(PKTTBL_Data_t *TblPtr, const PKTTBL_Pkt_t *PktPtr);
+
+
 /******************************************************************************
 ** Function: PKTTBL_SetTblToUnused
 **
+** Initialize every table entry to unused. This clears the full table so it
+** is intended for object construction.
+**
 */
 void PKTTBL_SetTblToUnused(PKTTBL_Data_t *TblPtr);
 
 
+/******************************************************************************
+** Function: PKTTBL_UnpackBinPkt
+**
+** Copy a binary image entry into a table entry.
+**
+*/
+void PKTTBL_UnpackBinPkt(PKTTBL_Pkt_t *Pkt, const PKTTBL_BinPkt_t *BinPkt);
+
+
 #endif /* _pkttbl_ */
@@ -0,0 +1,534 @@
+/*
+**  Copyright 2022 bitValence, Inc.
+**  All Rights Reserved.
+**
+**  This program is free software; you can modify and/or redistribute it
+**  under the terms of the GNU Affero General Public License
+**  as published by the Free Software Foundation; version 3 with
+**  attribution addendums as found in the LICENSE.txt
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Affero General Public License for more details.
+**
+**  Purpose:
+**    Implement KIT_TO's telemetry flight recorder.
+**
+**  Notes:
+**    None
+**
+**  References:
+**    1. OpenSatKit Object-based Application Developer's Guide
+**    2. cFS Application Developer's Guide
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "tlm_rec.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define REC_HDR_LEN      sizeof(TLM_REC_RecHdr_t)
+#define REC_LEN(DgLen)   (REC_HDR_LEN + (((DgLen) + 3) & ~3))
+#define REC_HDR(TlmRec, Pos)  ((TLM_REC_RecHdr_t *)&(TlmRec)->Ring[Pos])
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static const char *StateStr[] = { "UNDEF", "DISABLED", "RECORDING", "DUMP-TLM", "DUMP-FILE" };
+
+
+/******************************/
+/** File Function Prototypes **/
+/******************************/
+
+static void   CheckTrigger(TLM_REC_Class_t *TlmRec);
+static void   ClearRing(TLM_REC_Class_t *TlmRec);
+static void   DropOldest(TLM_REC_Class_t *TlmRec);
+static void   EndDump(TLM_REC_Class_t *TlmRec, const char *Reason);
+static bool   Freeze(TLM_REC_Class_t *TlmRec, uint8 Dest, const char *Filename, const char *Source);
+static uint32 NextRecPos(const TLM_REC_Class_t *TlmRec, uint32 Pos);
+static void   WriteFileDump(TLM_REC_Class_t *TlmRec);
+
+
+/******************************************************************************
+** Function: TLM_REC_Constructor
+**
+*/
+void TLM_REC_Constructor(TLM_REC_Class_t *TlmRec, INITBL_Class_t *IniTbl)
+{
+
+   int32 Status;
+
+   memset((void*)TlmRec, 0, sizeof(TLM_REC_Class_t));
+
+   TlmRec->WindowSecs = INITBL_GetIntConfig(IniTbl, CFG_TLM_REC_WINDOW);
+   TlmRec->DumpPkts   = INITBL_GetIntConfig(IniTbl, CFG_TLM_REC_DUMP_PKTS);
+   strncpy(TlmRec->DumpFile, INITBL_GetStrConfig(IniTbl, CFG_TLM_REC_DUMP_FILE), OS_MAX_PATH_LEN);
+   TlmRec->DumpFile[OS_MAX_PATH_LEN-1] = '\0';
+   strncpy(TlmRec->TriggerApp, INITBL_GetStrConfig(IniTbl, CFG_TLM_REC_TRIGGER_APP), CFE_MISSION_MAX_API_LEN);
+   TlmRec->TriggerApp[CFE_MISSION_MAX_API_LEN-1] = '\0';
+   TlmRec->TriggerEid = INITBL_GetIntConfig(IniTbl, CFG_TLM_REC_TRIGGER_EID);
+
+   TlmRec->State = (TlmRec->WindowSecs > 0) ? TLM_REC_STATE_RECORDING : TLM_REC_STATE_DISABLED;
+   ClearRing(TlmRec);
+
+   /* An empty trigger app name disables the event trigger */
+   if ((TlmRec->WindowSecs > 0) && (TlmRec->TriggerApp[0] != '\0'))
+   {
+
+      Status = CFE_SB_CreatePipe(&TlmRec->TriggerPipe, INITBL_GetIntConfig(IniTbl, CFG_TLM_REC_PIPE_DEPTH),
+                                 INITBL_GetStrConfig(IniTbl, CFG_TLM_REC_PIPE_NAME));
+      if (Status == CFE_SUCCESS)
+      {
+         Status = CFE_SB_Subscribe(CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_EVS_LONG_EVENT_TOPICID)),
+                                   TlmRec->TriggerPipe);
+      }
+
+      TlmRec->TriggerEna = (Status == CFE_SUCCESS);
+      if (!TlmRec->TriggerEna)
+      {
+         CFE_EVS_SendEvent(TLM_REC_INIT_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Telemetry recorder event trigger disabled. Event pipe creation or subscription failed, status 0x%08X",
+                           (unsigned int)Status);
+      }
+   }
+
+} /* End TLM_REC_Constructor() */
+
+
+/******************************************************************************
+** Function: TLM_REC_Execute
+**
+*/
+void TLM_REC_Execute(TLM_REC_Class_t *TlmRec)
+{
+
+   if (TlmRec->TriggerEna)
+   {
+      CheckTrigger(TlmRec);
+   }
+
+   TlmRec->DumpCycleCnt = 0;
+
+   if (TlmRec->State == TLM_REC_STATE_DUMP_FILE)
+   {
+      WriteFileDump(TlmRec);
+   }
+
+} /* End TLM_REC_Execute() */
+
+
+/******************************************************************************
+** Function: TLM_REC_FreezeCmd
+**
+*/
+bool TLM_REC_FreezeCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   TLM_REC_Class_t *TlmRec = (TLM_REC_Class_t *)ObjDataPtr;
+   const TLM_REC_FreezeCmdMsg_t *FreezeCmd = (const TLM_REC_FreezeCmdMsg_t *) MsgPtr;
+   char  Filename[OS_MAX_PATH_LEN];
+
+   if ((FreezeCmd->Dest != TLM_REC_DEST_TLM) && (FreezeCmd->Dest != TLM_REC_DEST_FILE))
+   {
+      CFE_EVS_SendEvent(TLM_REC_FREEZE_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Freeze command rejected. Invalid destination %d, must be %d(Telemetry) or %d(File)",
+                        FreezeCmd->Dest, TLM_REC_DEST_TLM, TLM_REC_DEST_FILE);
+      return false;
+   }
+
+   strncpy(Filename, FreezeCmd->Filename, OS_MAX_PATH_LEN);
+   Filename[OS_MAX_PATH_LEN-1] = '\0';
+
+   return Freeze(TlmRec, FreezeCmd->Dest, (Filename[0] == '\0') ? TlmRec->DumpFile : Filename, "command");
+
+} /* End TLM_REC_FreezeCmd() */
+
+
+/******************************************************************************
+** Function: TLM_REC_ReadTlmDump
+**
+*/
+bool TLM_REC_ReadTlmDump(TLM_REC_Class_t *TlmRec, const void **Datagram, uint16 *DatagramLen, uint16 *MsgLen)
+{
+
+   TLM_REC_RecHdr_t *RecHdr;
+
+   if ((TlmRec->State != TLM_REC_STATE_DUMP_TLM) || (TlmRec->DumpCycleCnt >= TlmRec->DumpPkts))
+   {
+      return false;
+   }
+
+   RecHdr = REC_HDR(TlmRec, TlmRec->DumpPos);
+   *Datagram    = &TlmRec->Ring[TlmRec->DumpPos + REC_HDR_LEN];
+   *DatagramLen = RecHdr->DatagramLen;
+   *MsgLen      = RecHdr->MsgLen;
+
+   TlmRec->DumpPos = NextRecPos(TlmRec, TlmRec->DumpPos);
+   ++TlmRec->DumpCycleCnt;
+
+   /* The record stays in the ring until the caller writes a new record */
+   if (--TlmRec->DumpLeft == 0)
+   {
+      EndDump(TlmRec, "completed");
+   }
+
+   return true;
+
+} /* End TLM_REC_ReadTlmDump() */
+
+
+/******************************************************************************
+** Function: TLM_REC_Recording
+**
+*/
+bool TLM_REC_Recording(const TLM_REC_Class_t *TlmRec)
+{
+
+   return (TlmRec->State == TLM_REC_STATE_RECORDING);
+
+} /* End TLM_REC_Recording() */
+
+
+/******************************************************************************
+** Function: TLM_REC_ResetStatus
+**
+*/
+void TLM_REC_ResetStatus(TLM_REC_Class_t *TlmRec)
+{
+
+   TlmRec->FreezeCnt   = 0;
+   TlmRec->TooLargeCnt = 0;
+
+} /* End TLM_REC_ResetStatus() */
+
+
+/******************************************************************************
+** Function: TLM_REC_ResumeCmd
+**
+*/
+bool TLM_REC_ResumeCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   TLM_REC_Class_t *TlmRec = (TLM_REC_Class_t *)ObjDataPtr;
+
+   if ((TlmRec->State == TLM_REC_STATE_DUMP_TLM) || (TlmRec->State == TLM_REC_STATE_DUMP_FILE))
+   {
+      EndDump(TlmRec, "aborted by command");
+   }
+   else
+   {
+      CFE_EVS_SendEvent(TLM_REC_RESUME_EID, CFE_EVS_EventType_INFORMATION,
+                        "Telemetry recorder resume command accepted in state %s", StateStr[TlmRec->State]);
+   }
+
+   return true;
+
+} /* End TLM_REC_ResumeCmd() */
+
+
+/******************************************************************************
+** Function: TLM_REC_Write
+**
+** Notes:
+**   1. Records older than the window are dropped before space is made so a
+**      quiet period doesn't leave old records in the ring.
+**   2. Free space is [Tail, end of ring) when the records are contiguous and
+**      [Tail, Head) when they wrap. When a record doesn't fit at the end of
+**      the ring a wrap marker is written and Tail moves to the start.
+*/
+void TLM_REC_Write(TLM_REC_Class_t *TlmRec, const void *Datagram, size_t DatagramLen, uint32 MsgLen, uint32 Seconds)
+{
+
+   uint32 RecLen = REC_LEN(DatagramLen);
+   TLM_REC_RecHdr_t *RecHdr;
+
+   if (TlmRec->State != TLM_REC_STATE_RECORDING) return;
+
+   if (RecLen > (TLM_REC_BUF_SIZE/4))
+   {
+      ++TlmRec->TooLargeCnt;
+      return;
+   }
+
+   while ((TlmRec->RecCnt > 0) && ((REC_HDR(TlmRec, TlmRec->Head)->Seconds + TlmRec->WindowSecs) < Seconds))
+   {
+      DropOldest(TlmRec);
+   }
+
+   while (true)
+   {
+
+      if (TlmRec->RecCnt == 0)
+      {
+         TlmRec->Head = 0;
+         TlmRec->Tail = 0;
+      }
+
+      if ((TlmRec->RecCnt == 0) || (TlmRec->Tail > TlmRec->Head))
+      {
+         if ((TLM_REC_BUF_SIZE - TlmRec->Tail) >= RecLen) break;
+
+         if ((TLM_REC_BUF_SIZE - TlmRec->Tail) >= REC_HDR_LEN)
+         {
+            REC_HDR(TlmRec, TlmRec->Tail)->DatagramLen = TLM_REC_WRAP;
+         }
+         TlmRec->Tail = 0;
+      }
+      else
+      {
+         if ((TlmRec->Head - TlmRec->Tail) >= RecLen) break;
+
+         DropOldest(TlmRec);
+      }
+
+   } /* End while making space */
+
+   RecHdr = REC_HDR(TlmRec, TlmRec->Tail);
+   RecHdr->Seconds     = Seconds;
+   RecHdr->DatagramLen = DatagramLen;
+   RecHdr->MsgLen      = MsgLen;
+   memcpy(&TlmRec->Ring[TlmRec->Tail + REC_HDR_LEN], Datagram, DatagramLen);
+
+   TlmRec->Tail     += RecLen;
+   TlmRec->RecBytes += RecLen;
+   ++TlmRec->RecCnt;
+
+} /* End TLM_REC_Write() */
+
+
+/******************************************************************************
+** Function: CheckTrigger
+**
+** Freeze the recorder if the trigger event is in the event pipe. Events are
+** only checked while recording.
+*/
+static void CheckTrigger(TLM_REC_Class_t *TlmRec)
+{
+
+   CFE_SB_Buffer_t *SbBufPtr;
+   const CFE_EVS_LongEventTlm_t *EventTlm;
+
+   while (CFE_SB_ReceiveBuffer(&SbBufPtr, TlmRec->TriggerPipe, CFE_SB_POLL) == CFE_SUCCESS)
+   {
+
+      EventTlm = (const CFE_EVS_LongEventTlm_t *)&SbBufPtr->Msg;
+
+      if ((TlmRec->State == TLM_REC_STATE_RECORDING) &&
+          (EventTlm->Payload.PacketID.EventID == TlmRec->TriggerEid) &&
+          (strncmp(EventTlm->Payload.PacketID.AppName, TlmRec->TriggerApp, CFE_MISSION_MAX_API_LEN) == 0))
+      {
+         Freeze(TlmRec, TLM_REC_DEST_FILE, TlmRec->DumpFile, "trigger event");
+      }
+
+   } /* End while events */
+
+} /* End CheckTrigger() */
+
+
+/******************************************************************************
+** Function: ClearRing
+**
+*/
+static void ClearRing(TLM_REC_Class_t *TlmRec)
+{
+
+   TlmRec->Head     = 0;
+   TlmRec->Tail     = 0;
+   TlmRec->RecCnt   = 0;
+   TlmRec->RecBytes = 0;
+
+} /* End ClearRing() */
+
+
+/******************************************************************************
+** Function: DropOldest
+**
+** Notes:
+**   1. Head moves to the start of the ring when it reaches a wrap marker or
+**      there isn't room for a record header before the end of the ring.
+*/
+static void DropOldest(TLM_REC_Class_t *TlmRec)
+{
+
+   uint32 RecLen = REC_LEN(REC_HDR(TlmRec, TlmRec->Head)->DatagramLen);
+
+   TlmRec->Head     += RecLen;
+   TlmRec->RecBytes -= RecLen;
+   --TlmRec->RecCnt;
+
+   if (((TLM_REC_BUF_SIZE - TlmRec->Head) < REC_HDR_LEN) ||
+       (REC_HDR(TlmRec, TlmRec->Head)->DatagramLen == TLM_REC_WRAP))
+   {
+      TlmRec->Head = 0;
+   }
+
+} /* End DropOldest() */
+
+
+/******************************************************************************
+** Function: EndDump
+**
+** Close the dump file if one is open, clear the ring and resume recording.
+*/
+static void EndDump(TLM_REC_Class_t *TlmRec, const char *Reason)
+{
+
+   uint32 RecDumped = TlmRec->RecCnt - TlmRec->DumpLeft;
+
+   if (TlmRec->State == TLM_REC_STATE_DUMP_FILE)
+   {
+      OS_close(TlmRec->DumpFileHandle);
+   }
+
+   CFE_EVS_SendEvent(TLM_REC_DUMP_EID, CFE_EVS_EventType_INFORMATION,
+                     "Telemetry recorder %s dump %s after %d of %d records. Recording resumed",
+                     (TlmRec->State == TLM_REC_STATE_DUMP_FILE) ? TlmRec->DumpFilename : "telemetry",
+                     Reason, (int)RecDumped, (int)TlmRec->RecCnt);
+
+   ClearRing(TlmRec);
+   TlmRec->DumpLeft = 0;
+   TlmRec->State = TLM_REC_STATE_RECORDING;
+
+} /* End EndDump() */
+
+
+/******************************************************************************
+** Function: Freeze
+**
+** Stop recording and start dumping the frozen window to Dest.
+*/
+static bool Freeze(TLM_REC_Class_t *TlmRec, uint8 Dest, const char *Filename, const char *Source)
+{
+
+   int32 OsStatus;
+   TLM_REC_FileHdr_t FileHdr;
+   os_err_name_t     OsErrStr;
+
+   if (TlmRec->State != TLM_REC_STATE_RECORDING)
+   {
+      CFE_EVS_SendEvent(TLM_REC_FREEZE_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Telemetry recorder freeze by %s rejected in state %s",
+                        Source, StateStr[TlmRec->State]);
+      return false;
+   }
+
+   if (Dest == TLM_REC_DEST_FILE)
+   {
+
+      OsStatus = OS_OpenCreate(&TlmRec->DumpFileHandle, Filename, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_WRITE_ONLY);
+      if (OsStatus == OS_SUCCESS)
+      {
+         FileHdr.Magic      = TLM_REC_FILE_MAGIC;
+         FileHdr.Version    = TLM_REC_FILE_VERSION;
+         FileHdr.WindowSecs = TlmRec->WindowSecs;
+         FileHdr.RecCnt     = TlmRec->RecCnt;
+         OsStatus = OS_write(TlmRec->DumpFileHandle, &FileHdr, sizeof(FileHdr));
+         if (OsStatus != (int32)sizeof(FileHdr))
+         {
+            OS_close(TlmRec->DumpFileHandle);
+         }
+      }
+
+      if (OsStatus != (int32)sizeof(FileHdr))
+      {
+         OS_GetErrorName(OsStatus, &OsErrStr);
+         CFE_EVS_SendEvent(TLM_REC_FREEZE_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Telemetry recorder freeze by %s failed to create dump file %s, status %s",
+                           Source, Filename, OsErrStr);
+         return false;
+      }
+
+      strncpy(TlmRec->DumpFilename, Filename, OS_MAX_PATH_LEN);
+      TlmRec->DumpFilename[OS_MAX_PATH_LEN-1] = '\0';
+
+   } /* End if file destination */
+
+   ++TlmRec->FreezeCnt;
+   TlmRec->State    = (Dest == TLM_REC_DEST_FILE) ? TLM_REC_STATE_DUMP_FILE : TLM_REC_STATE_DUMP_TLM;
+   TlmRec->DumpPos  = TlmRec->Head;
+   TlmRec->DumpLeft = TlmRec->RecCnt;
+
+   CFE_EVS_SendEvent(TLM_REC_FREEZE_EID, CFE_EVS_EventType_INFORMATION,
+                     "Telemetry recorder frozen by %s with %d records, %d bytes. Dumping to %s",
+                     Source, (int)TlmRec->RecCnt, (int)TlmRec->RecBytes,
+                     (Dest == TLM_REC_DEST_FILE) ? TlmRec->DumpFilename : "telemetry");
+
+   if (TlmRec->DumpLeft == 0)
+   {
+      EndDump(TlmRec, "completed");
+   }
+
+   return true;
+
+} /* End Freeze() */
+
+
+/******************************************************************************
+** Function: NextRecPos
+**
+*/
+static uint32 NextRecPos(const TLM_REC_Class_t *TlmRec, uint32 Pos)
+{
+
+   Pos += REC_LEN(REC_HDR(TlmRec, Pos)->DatagramLen);
+
+   if (((TLM_REC_BUF_SIZE - Pos) < REC_HDR_LEN) || (REC_HDR(TlmRec, Pos)->DatagramLen == TLM_REC_WRAP))
+   {
+      Pos = 0;
+   }
+
+   return Pos;
+
+} /* End NextRecPos() */
+
+
+/******************************************************************************
+** Function: WriteFileDump
+**
+** Write up to DumpPkts records to the dump file.
+*/
+static void WriteFileDump(TLM_REC_Class_t *TlmRec)
+{
+
+   int32   OsStatus;
+   size_t  WriteLen;
+
+   while ((TlmRec->DumpLeft > 0) && (TlmRec->DumpCycleCnt < TlmRec->DumpPkts))
+   {
+
+      WriteLen = REC_HDR_LEN + REC_HDR(TlmRec, TlmRec->DumpPos)->DatagramLen;
+      OsStatus = OS_write(TlmRec->DumpFileHandle, &TlmRec->Ring[TlmRec->DumpPos], WriteLen);
+
+      if (OsStatus != (int32)WriteLen)
+      {
+         CFE_EVS_SendEvent(TLM_REC_DUMP_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Telemetry recorder write to %s failed, status %d",
+                           TlmRec->DumpFilename, (int)OsStatus);
+         EndDump(TlmRec, "failed");
+         return;
+      }
+
+      TlmRec->DumpPos = NextRecPos(TlmRec, TlmRec->DumpPos);
+      --TlmRec->DumpLeft;
+      ++TlmRec->DumpCycleCnt;
+
+   } /* End while records */
+
+   if (TlmRec->DumpLeft == 0)
+   {
+      EndDump(TlmRec, "completed");
+   }
+
+} /* End WriteFileDump() */
@@ -0,0 +1,295 @@
+/*
+**  Copyright 2022 bitValence, Inc.
+**  All Rights Reserved.
+**
+**  This program is free software; you can modify and/or redistribute it
+**  under the terms of the GNU Affero General Public License
+**  as published by the Free Software Foundation; version 3 with
+**  attribution addendums as found in the LICENSE.txt
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Affero General Public License for more details.
+**
+**  Purpose:
+**    Define a flight recorder that keeps the last few seconds of unfiltered
+**    telemetry so it can be retrieved after an anomaly.
+**
+**  Notes:
+**    1. PKTMGR records the packed image of every subscribed packet before
+**       it's filtered. Records are kept in a TLM_REC_BUF_SIZE byte ring and
+**       the oldest records are dropped when they're older than the window
+**       or when space is needed.
+**    2. A freeze stops recording and dumps the frozen window to the
+**       downlink or to a file, TLM_REC_DUMP_PKTS records per output cycle,
+**       while normal output continues. Recording resumes with an empty
+**       ring when the dump completes.
+**    3. A freeze is triggered by command or when the configured app sends
+**       the configured event ID. Event triggered freezes are dumped to
+**       the default dump file so they're kept when there's no contact.
+**
+**  References:
+**    1. OpenSatKit Object-based Application Developer's Guide
+**    2. cFS Application Developer's Guide
+**
+*/
+#ifndef _tlm_rec_
+#define _tlm_rec_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/*
+** Event Message IDs
+*/
+
+#define TLM_REC_FREEZE_EID         (TLM_REC_BASE_EID + 0)
+#define TLM_REC_FREEZE_ERR_EID     (TLM_REC_BASE_EID + 1)
+#define TLM_REC_DUMP_EID           (TLM_REC_BASE_EID + 2)
+#define TLM_REC_DUMP_ERR_EID       (TLM_REC_BASE_EID + 3)
+#define TLM_REC_RESUME_EID         (TLM_REC_BASE_EID + 4)
+#define TLM_REC_INIT_ERR_EID       (TLM_REC_BASE_EID + 5)
+
+/*
+** Recorder states reported in telemetry
+*/
+
+#define TLM_REC_STATE_DISABLED   1
+#define TLM_REC_STATE_RECORDING  2
+#define TLM_REC_STATE_DUMP_TLM   3   /* Frozen, sending records with telemetry output */
+#define TLM_REC_STATE_DUMP_FILE  4   /* Frozen, writing records to a file             */
+
+/*
+** Freeze command destinations
+*/
+
+#define TLM_REC_DEST_TLM   1
+#define TLM_REC_DEST_FILE  2
+
+/*
+** Dump file
+** - The magic number is "KTRC" when written as a little endian uint32
+** - Each record is a TLM_REC_RecHdr_t followed by DatagramLen bytes.
+**   Values are in the target's native byte order.
+*/
+
+#define TLM_REC_FILE_MAGIC    0x4352544B
+#define TLM_REC_FILE_VERSION  1
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** Command Packets
+*/
+
+typedef struct
+{
+
+   CFE_MSG_CommandHeader_t  CmdHeader;
+   uint8   Dest;                         /* TLM_REC_DEST_xxx */
+   char    Filename[OS_MAX_PATH_LEN];    /* Used with TLM_REC_DEST_FILE, empty uses the default file */
+
+} TLM_REC_FreezeCmdMsg_t;
+#define TLM_REC_FREEZE_CMD_DATA_LEN  (sizeof(TLM_REC_FreezeCmdMsg_t) - sizeof(CFE_MSG_CommandHeader_t))
+
+
+typedef struct
+{
+
+   CFE_MSG_CommandHeader_t  CmdHeader;
+
+} TLM_REC_NoParamCmdMsg_t;
+#define TLM_REC_NO_PARAM_CMD_DATA_LEN  (sizeof(TLM_REC_NoParamCmdMsg_t) - sizeof(CFE_MSG_CommandHeader_t))
+#define TLM_REC_RESUME_CMD_DATA_LEN    (TLM_REC_NO_PARAM_CMD_DATA_LEN)
+
+
+/******************************************************************************
+** Ring records and dump file header
+**
+** - A record's datagram is padded to a 4 byte boundary in the ring. The pad
+**   isn't written to dump files.
+** - DatagramLen TLM_REC_WRAP marks the end of the used part of the ring.
+*/
+
+#define TLM_REC_WRAP  0xFFFF
+
+typedef struct
+{
+
+   uint32  Seconds;       /* Spacecraft time the packet was read */
+   uint16  DatagramLen;   /* Packed bytes */
+   uint16  MsgLen;        /* Unpacked bytes, used for output statistics */
+
+} TLM_REC_RecHdr_t;
+
+typedef struct
+{
+
+   uint32  Magic;
+   uint16  Version;
+   uint16  WindowSecs;
+   uint32  RecCnt;
+
+} TLM_REC_FileHdr_t;
+
+
+/******************************************************************************
+** Class
+*/
+
+typedef struct
+{
+
+   /*
+   ** Configuration
+   */
+
+   uint16  WindowSecs;       /* 0=Recorder disabled */
+   uint16  DumpPkts;         /* Records dumped per output cycle */
+   char    DumpFile[OS_MAX_PATH_LEN];
+   char    TriggerApp[CFE_MISSION_MAX_API_LEN];
+   uint16  TriggerEid;
+   bool    TriggerEna;
+   CFE_SB_PipeId_t  TriggerPipe;
+
+   /*
+   ** Ring state. Head is the oldest record and Tail is where the next record
+   ** is written.
+   */
+
+   uint8   State;
+   uint32  Head;
+   uint32  Tail;
+   uint32  RecCnt;
+   uint32  RecBytes;         /* Ring bytes held by records */
+
+   /*
+   ** Dump state
+   */
+
+   uint32     DumpPos;
+   uint32     DumpLeft;       /* Records remaining */
+   uint16     DumpCycleCnt;   /* Records dumped in the current output cycle */
+   osal_id_t  DumpFileHandle;
+   char       DumpFilename[OS_MAX_PATH_LEN];
+
+   /*
+   ** Status
+   */
+
+   uint16  FreezeCnt;
+   uint32  TooLargeCnt;      /* Packets larger than a quarter of the ring */
+
+   /*
+   ** Record ring, only accessed by tlm_rec.c
+   */
+
+   uint8   Ring[TLM_REC_BUF_SIZE] __attribute__ ((aligned (4)));
+
+} TLM_REC_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: TLM_REC_Constructor
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**   2. The ring is part of the object so each instance records
+**      independently. Only one instance can use the event trigger because
+**      the trigger pipe name is configured.
+**
+*/
+void TLM_REC_Constructor(TLM_REC_Class_t *TlmRec, INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: TLM_REC_Execute
+**
+** Check for a trigger event, start a new dump cycle and write the next
+** group of records when dumping to a file.
+**
+** Notes:
+**   1. Must be called before PKTMGR_OutputTelemetry() each main loop cycle.
+**
+*/
+void TLM_REC_Execute(TLM_REC_Class_t *TlmRec);
+
+
+/******************************************************************************
+** Function: TLM_REC_FreezeCmd
+**
+** Freeze the recorder and dump the frozen window to the commanded
+** destination. Rejected if a dump is in progress.
+**
+*/
+bool TLM_REC_FreezeCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: TLM_REC_ReadTlmDump
+**
+** Return the next record to send when dumping to telemetry. Returns false
+** when no record is available in this output cycle.
+**
+** Notes:
+**   1. Called by PKTMGR_OutputTelemetry(). The dump completes and recording
+**      resumes when the last record has been read.
+**
+*/
+bool TLM_REC_ReadTlmDump(TLM_REC_Class_t *TlmRec, const void **Datagram, uint16 *DatagramLen, uint16 *MsgLen);
+
+
+/******************************************************************************
+** Function: TLM_REC_Recording
+**
+** Return true if packets passed to TLM_REC_Write() are recorded. Callers
+** use this to avoid packing packets that won't be recorded.
+**
+*/
+bool TLM_REC_Recording(const TLM_REC_Class_t *TlmRec);
+
+
+/******************************************************************************
+** Function: TLM_REC_ResetStatus
+**
+*/
+void TLM_REC_ResetStatus(TLM_REC_Class_t *TlmRec);
+
+
+/******************************************************************************
+** Function: TLM_REC_ResumeCmd
+**
+** Abort a dump in progress and resume recording with an empty ring.
+**
+*/
+bool TLM_REC_ResumeCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: TLM_REC_Write
+**
+** Record a packed packet read at spacecraft time Seconds.
+**
+*/
+void TLM_REC_Write(TLM_REC_Class_t *TlmRec, const void *Datagram, size_t DatagramLen, uint32 MsgLen, uint32 Seconds);
+
+
+#endif /* _tlm_rec_ */
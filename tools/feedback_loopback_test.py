@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""
+    Copyright 2022 bitValence, Inc.
+    All Rights Reserved.
+
+    This program is free software; you can modify and/or redistribute it
+    under the terms of the GNU Affero General Public License
+    as published by the Free Software Foundation; version 3 with
+    attribution addendums as found in the LICENSE.txt.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    Purpose:
+      Loopback convergence test for KIT_TO's feedback rate controller. It
+      receives KIT_TO's telemetry through a simulated bottleneck link, sends
+      feedback reports like feedback_rcvr.py and checks that KIT_TO's output
+      rate converges to the bottleneck rate.
+
+    Notes:
+      1. Run KIT_TO on the same host with output enabled for 127.0.0.1,
+         PKTMGR_FEEDBACK_PORT set to --feedback-port and a telemetry source
+         that exceeds the bottleneck rate.
+      2. --sim-sender replaces KIT_TO with a sender that uses the same AIMD
+         rules as PKTMGR's ProcessFeedbackRpt() and the default ini
+         settings. It checks the receiver and test without flight software.
+      3. The offered rate is measured before the bottleneck and the
+         delivered rate after it. The test passes if over the final
+         --window seconds the mean delivered rate is at least --min-util of
+         the bottleneck rate and the mean offered rate doesn't exceed
+         --max-offered of it. The exit status is 0 on a pass.
+
+    Usage:
+      feedback_loopback_test.py --feedback-port 1236 --bottleneck 20000
+      feedback_loopback_test.py --feedback-port 1236 --bottleneck 20000 --sim-sender
+"""
+
+import argparse
+import socket
+import struct
+import sys
+import threading
+import time
+
+from feedback_rcvr import Bottleneck, FEEDBACK_FMT, FEEDBACK_MAGIC, LossCounter, load_strides
+
+SIM_PKT_LEN    = 200   # Bytes per simulated telemetry packet
+SIM_APP_IDS    = 8     # Simulated AppIds sent round robin
+SIM_CYCLE_SECS = 0.05  # Simulated output cycle
+
+
+class SimSender(threading.Thread):
+    """KIT_TO stand-in that is always rate limited and applies feedback reports with PKTMGR's AIMD rules"""
+
+    def __init__(self, tlm_port, feedback_port, min_rate, max_rate, increase, decrease):
+        super().__init__(daemon=True)
+        self.tlm_addr = ('127.0.0.1', tlm_port)
+        self.min_rate = min_rate
+        self.max_rate = max_rate
+        self.increase = increase
+        self.decrease = decrease
+        self.rate = min_rate
+        self.loss_cnt = 0
+        self.seq = [0] * SIM_APP_IDS
+        self.tlm_sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.fb_sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.fb_sock.bind(('127.0.0.1', feedback_port))
+        self.fb_sock.setblocking(False)
+
+    def process_feedback(self):
+        while True:
+            try:
+                rpt = self.fb_sock.recv(64)
+            except BlockingIOError:
+                return
+            if len(rpt) != struct.calcsize(FEEDBACK_FMT):
+                continue
+            magic, _, loss_cnt = struct.unpack(FEEDBACK_FMT, rpt)
+            if magic != FEEDBACK_MAGIC:
+                continue
+            new_loss = loss_cnt - self.loss_cnt if loss_cnt >= self.loss_cnt else 0
+            self.loss_cnt = loss_cnt
+            if new_loss > 0:
+                self.rate = max(self.min_rate, self.rate * self.decrease // 100)
+            else:
+                self.rate = min(self.max_rate, self.rate + self.increase)
+
+    def run(self):
+        app_id = 0
+        tokens = 0.0
+        while True:
+            self.process_feedback()
+            tokens = min(tokens + self.rate * SIM_CYCLE_SECS, self.rate * SIM_CYCLE_SECS)
+            while tokens >= SIM_PKT_LEN:
+                hdr = struct.pack('>HHH', 0x0800 | app_id, 0xC000 | self.seq[app_id], SIM_PKT_LEN - 7)
+                self.tlm_sock.sendto(hdr + bytes(SIM_PKT_LEN - len(hdr)), self.tlm_addr)
+                self.seq[app_id] = (self.seq[app_id] + 1) & 0x3FFF
+                app_id = (app_id + 1) % SIM_APP_IDS
+                tokens -= SIM_PKT_LEN
+            time.sleep(SIM_CYCLE_SECS)
+
+
+def main():
+
+    parser = argparse.ArgumentParser(description='KIT_TO feedback rate controller loopback convergence test')
+    parser.add_argument('--tlm-port', type=int, default=1235, help='KIT_TO telemetry UDP port (PKTMGR_UDP_TLM_PORT)')
+    parser.add_argument('--feedback-port', type=int, required=True, help='KIT_TO feedback UDP port (PKTMGR_FEEDBACK_PORT)')
+    parser.add_argument('--bottleneck', type=int, required=True, help='Simulated link rate in bytes/sec')
+    parser.add_argument('--queue', type=int, default=8192, help='Simulated link queue length in bytes')
+    parser.add_argument('--period', type=float, default=1.0, help='Seconds between feedback reports')
+    parser.add_argument('--duration', type=float, default=60.0, help='Test length in seconds')
+    parser.add_argument('--window', type=float, default=30.0, help='Final seconds used to check convergence')
+    parser.add_argument('--min-util', type=float, default=0.5, help='Min delivered rate as a fraction of the bottleneck')
+    parser.add_argument('--max-offered', type=float, default=1.2, help='Max offered rate as a fraction of the bottleneck')
+    parser.add_argument('--pkt-tbl', default='', help='KIT_TO JSON packet table used to set sequence count strides')
+    parser.add_argument('--sim-sender', action='store_true', help='Use a simulated KIT_TO sender')
+    parser.add_argument('--min-rate', type=int, default=4000, help='Simulated PKTMGR_FEEDBACK_MIN_RATE')
+    parser.add_argument('--max-rate', type=int, default=1000000, help='Simulated PKTMGR_FEEDBACK_MAX_RATE')
+    parser.add_argument('--increase', type=int, default=4000, help='Simulated PKTMGR_FEEDBACK_INCREASE')
+    parser.add_argument('--decrease', type=int, default=50, help='Simulated PKTMGR_FEEDBACK_DECREASE')
+    args = parser.parse_args()
+
+    if args.window >= args.duration:
+        parser.error('--window must be less than --duration')
+
+    tlm_sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    tlm_sock.bind(('127.0.0.1', args.tlm_port))
+    tlm_sock.settimeout(args.period)
+    fb_sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+
+    if args.sim_sender:
+        SimSender(args.tlm_port, args.feedback_port, args.min_rate, args.max_rate,
+                  args.increase, args.decrease).start()
+
+    link = Bottleneck(args.bottleneck, args.queue)
+    losses = LossCounter(*load_strides(args.pkt_tbl)) if args.pkt_tbl else LossCounter()
+    rcv_seq = 0
+    offered_bytes = 0
+    delivered_bytes = 0
+    samples = []  # (end time, offered bytes/sec, delivered bytes/sec)
+
+    start = time.monotonic()
+    period_start = start
+    print('Bottleneck %d bytes/sec, reporting to 127.0.0.1:%d every %.1f sec for %.0f sec'
+          % (args.bottleneck, args.feedback_port, args.period, args.duration))
+
+    while time.monotonic() - start < args.duration:
+
+        try:
+            datagram = tlm_sock.recv(65535)
+            offered_bytes += len(datagram)
+            if link.accept(len(datagram)):
+                rcv_seq += 1
+                delivered_bytes += len(datagram)
+                losses.update(datagram)
+        except socket.timeout:
+            pass
+
+        now = time.monotonic()
+        if now - period_start >= args.period:
+            fb_sock.sendto(struct.pack(FEEDBACK_FMT, FEEDBACK_MAGIC, rcv_seq & 0xFFFFFFFF,
+                                       losses.loss_cnt & 0xFFFFFFFF),
+                           ('127.0.0.1', args.feedback_port))
+            secs = now - period_start
+            samples.append((now - start, offered_bytes / secs, delivered_bytes / secs))
+            print('%6.1f sec  offered %8.0f  delivered %8.0f bytes/sec  loss %6d'
+                  % (samples[-1][0], samples[-1][1], samples[-1][2], losses.loss_cnt))
+            offered_bytes = 0
+            delivered_bytes = 0
+            period_start = now
+
+    window = [s for s in samples if s[0] > args.duration - args.window]
+    if not window:
+        print('FAIL: no samples in the convergence window')
+        return 1
+
+    offered = sum(s[1] for s in window) / len(window)
+    delivered = sum(s[2] for s in window) / len(window)
+    passed = (delivered >= args.min_util * args.bottleneck) and (offered <= args.max_offered * args.bottleneck)
+
+    print('%s: final %.0f sec mean offered %.0f (%.0f%%), delivered %.0f (%.0f%%) of %d bytes/sec'
+          % ('PASS' if passed else 'FAIL', args.window, offered, 100.0 * offered / args.bottleneck,
+             delivered, 100.0 * delivered / args.bottleneck, args.bottleneck))
+
+    return 0 if passed else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""
+    Copyright 2022 bitValence, Inc.
+    All Rights Reserved.
+
+    This program is free software; you can modify and/or redistribute it
+    under the terms of the GNU Affero General Public License
+    as published by the Free Software Foundation; version 3 with
+    attribution addendums as found in the LICENSE.txt.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    Purpose:
+      Reference ground receiver for KIT_TO's feedback rate controller. It
+      receives KIT_TO telemetry datagrams, counts missing packets from CCSDS
+      sequence count gaps and periodically sends a feedback report defined by
+      PKTMGR_FeedbackRpt_t in fsw/src/pktmgr.h to KIT_TO's feedback port.
+
+    Notes:
+      1. The report is three big endian uint32s: magic, receive sequence
+         (datagrams received) and loss count. Both counts are cumulative.
+      2. Each AppId's sequence count stride defaults to 1. With --pkt-tbl
+         the stride of a sequence count filter that passes 1 of every X
+         packets is X. AppIds with other sequence count or time filters
+         don't have a fixed stride and aren't counted.
+      3. --bottleneck simulates a constrained link. Datagrams that would
+         exceed the bottleneck rate after the queue is full are dropped
+         before they are counted. feedback_loopback_test.py uses this to
+         check that KIT_TO's output rate converges below the bottleneck.
+
+    Usage:
+      feedback_rcvr.py --tlm-port 1235 --fsw-ip 127.0.0.1 --feedback-port 1236
+      feedback_rcvr.py --feedback-port 1236 --bottleneck 20000 --pkt-tbl cpu1_kit_to_pkt_tbl.json
+"""
+
+import argparse
+import json
+import socket
+import struct
+import time
+
+FEEDBACK_MAGIC = 0x4B544642  # PKTMGR_FEEDBACK_MAGIC
+FEEDBACK_FMT   = '>III'
+
+CCSDS_HDR_LEN   = 6
+APP_ID_MASK     = 0x07FF
+SEQ_CNT_MASK    = 0x3FFF
+SEQ_CNT_MOD     = 0x4000
+
+FILTER_BY_SEQ_CNT = 2   # PKTUTIL_FILTER_BY_SEQ_CNT
+FILTER_BY_TIME    = 3   # PKTUTIL_FILTER_BY_TIME
+
+
+def load_strides(pkt_tbl_file):
+    """Return the per-AppId strides and the AppIds without a fixed stride defined by a packet table's filters"""
+
+    strides = {}
+    ignored = set()
+    with open(pkt_tbl_file) as tbl_file:
+        tbl = json.load(tbl_file)
+    for entry in tbl.get('packet-array', []):
+        pkt = entry['packet']
+        app_id = pkt['topic-id'] & APP_ID_MASK
+        pkt_filter = pkt.get('filter', {})
+        filter_type = pkt_filter.get('type', FILTER_BY_SEQ_CNT)
+        n = pkt_filter.get('N', 1)
+        x = pkt_filter.get('X', 1)
+        if filter_type == FILTER_BY_SEQ_CNT and n == 1 and x > 1:
+            strides[app_id] = x
+        elif (filter_type == FILTER_BY_SEQ_CNT and n > 1 and n < x) or filter_type == FILTER_BY_TIME:
+            ignored.add(app_id)
+    return strides, ignored
+
+
+class LossCounter:
+    """Count missing packets from per-AppId CCSDS sequence count gaps"""
+
+    def __init__(self, strides=None, ignored=None):
+        self.last_seq = {}
+        self.stride = strides if strides is not None else {}
+        self.ignored = ignored if ignored is not None else set()
+        self.loss_cnt = 0
+
+    def update(self, datagram):
+        if len(datagram) < CCSDS_HDR_LEN:
+            return
+        stream_id, seq, _ = struct.unpack_from('>HHH', datagram)
+        app_id = stream_id & APP_ID_MASK
+        if app_id in self.ignored:
+            return
+        seq &= SEQ_CNT_MASK
+        if app_id in self.last_seq:
+            delta = (seq - self.last_seq[app_id]) % SEQ_CNT_MOD
+            stride = self.stride.get(app_id, 1)
+            if delta > stride and delta < SEQ_CNT_MOD // 2:
+                self.loss_cnt += delta // stride - 1
+        self.last_seq[app_id] = seq
+
+
+class Bottleneck:
+    """Token bucket link model: a queue of queue_len bytes drained at rate bytes/sec"""
+
+    def __init__(self, rate, queue_len):
+        self.rate = rate
+        self.queue_len = queue_len
+        self.queued = 0.0
+        self.time = time.monotonic()
+        self.drop_cnt = 0
+
+    def accept(self, length):
+        now = time.monotonic()
+        self.queued = max(0.0, self.queued - (now - self.time) * self.rate)
+        self.time = now
+        if self.queued + length > self.queue_len:
+            self.drop_cnt += 1
+            return False
+        self.queued += length
+        return True
+
+
+def main():
+
+    parser = argparse.ArgumentParser(description='Reference KIT_TO ground feedback receiver')
+    parser.add_argument('--tlm-port', type=int, default=1235, help='KIT_TO telemetry UDP port (PKTMGR_UDP_TLM_PORT)')
+    parser.add_argument('--fsw-ip', default='127.0.0.1', help='KIT_TO host address')
+    parser.add_argument('--feedback-port', type=int, required=True, help='KIT_TO feedback UDP port (PKTMGR_FEEDBACK_PORT)')
+    parser.add_argument('--period', type=float, default=1.0, help='Seconds between feedback reports')
+    parser.add_argument('--bottleneck', type=int, default=0, help='Simulated link rate in bytes/sec, 0=None')
+    parser.add_argument('--queue', type=int, default=8192, help='Simulated link queue length in bytes')
+    parser.add_argument('--pkt-tbl', default='', help='KIT_TO JSON packet table used to set sequence count strides')
+    args = parser.parse_args()
+
+    tlm_sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    tlm_sock.bind(('', args.tlm_port))
+    tlm_sock.settimeout(args.period)
+    fb_sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+
+    link = Bottleneck(args.bottleneck, args.queue) if args.bottleneck > 0 else None
+    losses = LossCounter(*load_strides(args.pkt_tbl)) if args.pkt_tbl else LossCounter()
+    rcv_seq = 0
+    rcv_bytes = 0
+    next_rpt = time.monotonic() + args.period
+
+    print('Receiving on port %d, reporting to %s:%d every %.1f sec'
+          % (args.tlm_port, args.fsw_ip, args.feedback_port, args.period))
+
+    while True:
+
+        try:
+            datagram = tlm_sock.recv(65535)
+            if link is None or link.accept(len(datagram)):
+                rcv_seq += 1
+                rcv_bytes += len(datagram)
+                losses.update(datagram)
+        except socket.timeout:
+            pass
+
+        now = time.monotonic()
+        if now >= next_rpt:
+            fb_sock.sendto(struct.pack(FEEDBACK_FMT, FEEDBACK_MAGIC, rcv_seq & 0xFFFFFFFF,
+                                       losses.loss_cnt & 0xFFFFFFFF),
+                           (args.fsw_ip, args.feedback_port))
+            print('seq %8d  loss %6d  %8.0f bytes/sec%s'
+                  % (rcv_seq, losses.loss_cnt, rcv_bytes / (now - next_rpt + args.period),
+                     '' if link is None else '  link drops %d' % link.drop_cnt))
+            rcv_bytes = 0
+            next_rpt = now + args.period
+
+
+if __name__ == '__main__':
+    main()
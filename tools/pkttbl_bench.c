@@ -0,0 +1,418 @@
+/*
+**  Copyright 2022 bitValence, Inc.
+**  All Rights Reserved.
+**
+**  This program is free software; you can modify and/or redistribute it
+**  under the terms of the GNU Affero General Public License
+**  as published by the Free Software Foundation; version 3 with
+**  attribution addendums as found in the LICENSE.txt
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Affero General Public License for more details.
+**
+**  Purpose:
+**    Host benchmark for the packet table's active index and JSON loader.
+**
+**  Notes:
+**    1. pkttbl.c is included so its static functions can be timed directly.
+**       The cFE, OSAL and INITBL services it calls are replaced by the
+**       minimal host versions below, so the benchmark isn't linked with cFE.
+**    2. For each table size the benchmark times PKTTBL_SetPkt(), hit and
+**       miss PKTTBL_GetPkt() lookups, an ActiveIdx[] traversal compared
+**       with a scan of every slot, PKTTBL_RemovePkt() and a JSON file load.
+**       The JSON file is generated in the table format and is removed when
+**       the benchmark completes.
+**    3. Build from the repo root with the same include paths as the cFS
+**       build. The shim signatures follow cFE 7 and OSAL 6.
+**         gcc -O2 -I<cfs include paths> -Ifsw/src -Ifsw/platform_inc \
+**             -Ifsw/mission_inc -o pkttbl_bench tools/pkttbl_bench.c
+**
+**  Usage:
+**    pkttbl_bench             Default sizes 100, 1000 and 2048
+**    pkttbl_bench 500 2048    Benchmark the listed table sizes
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../fsw/src/pkttbl.c"
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define BENCH_MIN_SECS     0.2    /* Each measurement is repeated for at least this long */
+#define BENCH_MSG_ID_BASE  0x0800 /* Telemetry message IDs with sequential AppIds */
+#define BENCH_MISS_OFFSET  0x1000 /* Added to a message ID to create a lookup miss */
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static PKTTBL_Data_t TblData;
+static uint16        MsgIdList[PKTTBL_MAX_SLOTS];
+static volatile uint32 Sink;      /* Keeps timed loops from being optimized away */
+
+
+/******************************************************************************
+** Host Service Shims
+**
+** Only the behavior pkttbl.c needs for a table load is provided. File I/O is
+** always inline because child task creation fails.
+*/
+
+int32 CFE_EVS_SendEvent(uint16 EventID, uint16 EventType, const char *Spec, ...)
+{
+   va_list Args;
+
+   if (EventType == CFE_EVS_EventType_ERROR)
+   {
+      va_start(Args, Spec);
+      fprintf(stderr, "Event %d: ", EventID);
+      vfprintf(stderr, Spec, Args);
+      fprintf(stderr, "\n");
+      va_end(Args);
+   }
+   return CFE_SUCCESS;
+}
+
+uint32 CFE_ES_CalculateCRC(const void *DataPtr, size_t DataLength, uint32 InputCRC, uint32 TypeCRC)
+{
+   const uint8 *Byte = DataPtr;
+   uint16 Crc = (uint16)InputCRC;
+   uint16 Bit;
+
+   while (DataLength-- > 0)
+   {
+      Crc ^= *Byte++;
+      for (Bit=0; Bit < 8; Bit++) Crc = (Crc & 1) ? ((Crc >> 1) ^ 0xA001) : (Crc >> 1);
+   }
+   return Crc;
+}
+
+int32 CFE_ES_CreateChildTask(CFE_ES_TaskId_t *TaskIdPtr, const char *TaskName, CFE_ES_ChildTaskMainFuncPtr_t FunctionPtr,
+                             CFE_ES_StackPointer_t StackPtr, size_t StackSize, CFE_ES_TaskPriority_Atom_t Priority, uint32 Flags)
+{
+   return CFE_ES_ERR_CHILD_TASK_CREATE;
+}
+
+void CFE_ES_ExitChildTask(void)
+{
+}
+
+int32 CFE_PSP_MemSet(void *Dest, uint8 Value, uint32 Size)
+{
+   memset(Dest, Value, Size);
+   return CFE_PSP_SUCCESS;
+}
+
+CFE_TIME_SysTime_t CFE_TIME_GetTime(void)
+{
+   CFE_TIME_SysTime_t Time = {0, 0};
+   return Time;
+}
+
+CFE_TIME_SysTime_t CFE_TIME_Subtract(CFE_TIME_SysTime_t Time1, CFE_TIME_SysTime_t Time2)
+{
+   CFE_TIME_SysTime_t Result;
+
+   Result.Subseconds = Time1.Subseconds - Time2.Subseconds;
+   Result.Seconds    = Time1.Seconds - Time2.Seconds - ((Result.Subseconds > Time1.Subseconds) ? 1 : 0);
+   return Result;
+}
+
+uint32 CFE_TIME_Sub2MicroSecs(uint32 SubSeconds)
+{
+   return (uint32)(((uint64)SubSeconds * 1000000) >> 32);
+}
+
+void CFE_TIME_Print(char *PrintBuffer, CFE_TIME_SysTime_t TimeToPrint)
+{
+   strcpy(PrintBuffer, "0000-000-00:00:00.00000");
+}
+
+uint32 INITBL_GetIntConfig(INITBL_Class_t *IniTbl, uint16 Param)
+{
+   return 0;
+}
+
+const char *INITBL_GetStrConfig(INITBL_Class_t *IniTbl, uint16 Param)
+{
+   return "";
+}
+
+int32 OS_BinSemCreate(osal_id_t *SemId, const char *SemName, uint32 InitialValue, uint32 Options) { return OS_ERROR; }
+int32 OS_BinSemGive(osal_id_t SemId) { return OS_ERROR; }
+int32 OS_BinSemTake(osal_id_t SemId) { return OS_ERROR; }
+int32 OS_MutSemCreate(osal_id_t *SemId, const char *SemName, uint32 Options) { return OS_ERROR; }
+int32 OS_MutSemGive(osal_id_t SemId) { return OS_SUCCESS; }
+int32 OS_MutSemTake(osal_id_t SemId) { return OS_SUCCESS; }
+
+int32 OS_GetErrorName(int32 ErrorNum, os_err_name_t *ErrName)
+{
+   snprintf(*ErrName, sizeof(*ErrName), "OS_ERROR(%d)", (int)ErrorNum);
+   return OS_SUCCESS;
+}
+
+int32 OS_OpenCreate(osal_id_t *FileDes, const char *Path, int32 Flags, int32 AccessMode)
+{
+   int Fd;
+   int PosixFlags = (AccessMode == OS_READ_ONLY) ? O_RDONLY : O_WRONLY;
+
+   if (Flags & OS_FILE_FLAG_CREATE)   PosixFlags |= O_CREAT;
+   if (Flags & OS_FILE_FLAG_TRUNCATE) PosixFlags |= O_TRUNC;
+
+   Fd = open(Path, PosixFlags, 0644);
+   if (Fd < 0) return OS_ERROR;
+
+   *FileDes = OS_ObjectIdFromInteger(Fd);
+   return OS_SUCCESS;
+}
+
+int32 OS_close(osal_id_t FileDes)
+{
+   return (close(OS_ObjectIdToInteger(FileDes)) == 0) ? OS_SUCCESS : OS_ERROR;
+}
+
+int32 OS_read(osal_id_t FileDes, void *Buffer, size_t NBytes)
+{
+   ssize_t Len = read(OS_ObjectIdToInteger(FileDes), Buffer, NBytes);
+   return (Len < 0) ? OS_ERROR : (int32)Len;
+}
+
+int32 OS_write(osal_id_t FileDes, const void *Buffer, size_t NBytes)
+{
+   ssize_t Len = write(OS_ObjectIdToInteger(FileDes), Buffer, NBytes);
+   return (Len < 0) ? OS_ERROR : (int32)Len;
+}
+
+
+/******************************************************************************
+** Function: ElapsedSecs
+**
+*/
+static double ElapsedSecs(const struct timespec *Start)
+{
+   struct timespec Now;
+
+   clock_gettime(CLOCK_MONOTONIC, &Now);
+   return (Now.tv_sec - Start->tv_sec) + (Now.tv_nsec - Start->tv_nsec)/1e9;
+
+} /* End ElapsedSecs() */
+
+
+/******************************************************************************
+** Function: FillTbl
+**
+** Set the first PktCnt message IDs in MsgIdList[] order.
+*/
+static void FillTbl(uint16 PktCnt)
+{
+   uint16 i;
+   PKTTBL_Pkt_t Pkt;
+
+   PKTTBL_SetTblToUnused(&TblData);
+   PKTTBL_SetPacketToUnused(&Pkt);
+   for (i=0; i < PktCnt; i++)
+   {
+      Pkt.MsgId = MsgIdList[i];
+      PKTTBL_SetPkt(&TblData, &Pkt);
+   }
+
+} /* End FillTbl() */
+
+
+/******************************************************************************
+** Function: WriteJsonTbl
+**
+** Write a JSON table with PktCnt packets in the cpu1_kit_to_pkt_tbl.json
+** format.
+*/
+static bool WriteJsonTbl(const char *Filename, uint16 PktCnt)
+{
+   uint16 i;
+   FILE *File = fopen(Filename, "w");
+
+   if (File == NULL) return false;
+
+   fprintf(File, "{\n   \"name\": \"Benchmark Table\",\n"
+                 "   \"description\": \"Generated by pkttbl_bench with %d packets\",\n"
+                 "   \"packet-array\": [\n", PktCnt);
+   for (i=0; i < PktCnt; i++)
+   {
+      fprintf(File, "      {\"packet\": {\n"
+                    "         \"name\": \"BENCH_TLM_%d\",\n"
+                    "         \"topic-id\": %d,\n"
+                    "         \"priority\": 0,\n"
+                    "         \"reliability\": 0,\n"
+                    "         \"buf-limit\": 4,\n"
+                    "         \"filter\": { \"type\": 2, \"X\": 1, \"N\": 1, \"O\": 0}\n"
+                    "      }}%s\n", i, MsgIdList[i], (i < PktCnt-1) ? "," : "");
+   }
+   fprintf(File, "   ]\n}\n");
+
+   return (fclose(File) == 0);
+
+} /* End WriteJsonTbl() */
+
+
+/******************************************************************************
+** Function: RunBench
+**
+** Each measurement is repeated until BENCH_MIN_SECS have elapsed and the
+** time per operation is reported.
+*/
+static bool RunBench(uint16 PktCnt)
+{
+
+   uint16  i, Slot;
+   uint16  LoadCnt;
+   uint32  Reps;
+   uint32  Sum;
+   double  Secs;
+   char    Filename[] = "/tmp/pkttbl_bench_XXXXXX";
+   struct  timespec Start;
+   int     Fd;
+
+
+   /* SetPkt from an empty table, the time includes the table reset */
+   clock_gettime(CLOCK_MONOTONIC, &Start);
+   for (Reps=0; (Secs = ElapsedSecs(&Start)) < BENCH_MIN_SECS; Reps++) FillTbl(PktCnt);
+   printf("%6d  SetPkt         %10.1f ns/pkt\n", PktCnt, Secs*1e9/((double)Reps*PktCnt));
+
+   /* GetPkt hits and misses */
+   clock_gettime(CLOCK_MONOTONIC, &Start);
+   for (Reps=0, Sum=0; (Secs = ElapsedSecs(&Start)) < BENCH_MIN_SECS; Reps++)
+   {
+      for (i=0; i < PktCnt; i++) Sum += (PKTTBL_GetPkt(&TblData, MsgIdList[i]) != NULL);
+   }
+   Sink = Sum;
+   printf("%6d  GetPkt hit     %10.1f ns/lookup\n", PktCnt, Secs*1e9/((double)Reps*PktCnt));
+
+   clock_gettime(CLOCK_MONOTONIC, &Start);
+   for (Reps=0, Sum=0; (Secs = ElapsedSecs(&Start)) < BENCH_MIN_SECS; Reps++)
+   {
+      for (i=0; i < PktCnt; i++) Sum += (PKTTBL_GetPkt(&TblData, MsgIdList[i] + BENCH_MISS_OFFSET) != NULL);
+   }
+   Sink = Sum;
+   printf("%6d  GetPkt miss    %10.1f ns/lookup\n", PktCnt, Secs*1e9/((double)Reps*PktCnt));
+
+   /* Table-wide traversal using the active index and the full slot scan it replaced */
+   clock_gettime(CLOCK_MONOTONIC, &Start);
+   for (Reps=0, Sum=0; (Secs = ElapsedSecs(&Start)) < BENCH_MIN_SECS; Reps++)
+   {
+      for (i=0; i < TblData.ActiveCnt; i++) Sum += TblData.Pkt[TblData.ActiveIdx[i]].BufLim;
+   }
+   Sink = Sum;
+   printf("%6d  ActiveIdx walk %10.1f ns/table\n", PktCnt, Secs*1e9/Reps);
+
+   clock_gettime(CLOCK_MONOTONIC, &Start);
+   for (Reps=0, Sum=0; (Secs = ElapsedSecs(&Start)) < BENCH_MIN_SECS; Reps++)
+   {
+      for (Slot=0; Slot < PKTTBL_MAX_SLOTS; Slot++)
+      {
+         if (TblData.Pkt[Slot].MsgId != PKTTBL_UNUSED_MSG_ID) Sum += TblData.Pkt[Slot].BufLim;
+      }
+   }
+   Sink = Sum;
+   printf("%6d  Full slot scan %10.1f ns/table\n", PktCnt, Secs*1e9/Reps);
+
+   /* RemovePkt of every entry, the fill isn't timed */
+   Secs = 0.0;
+   for (Reps=0; Secs < BENCH_MIN_SECS; Reps++)
+   {
+      FillTbl(PktCnt);
+      clock_gettime(CLOCK_MONOTONIC, &Start);
+      for (i=0; i < PktCnt; i++) PKTTBL_RemovePkt(&TblData, MsgIdList[i]);
+      Secs += ElapsedSecs(&Start);
+   }
+   printf("%6d  RemovePkt      %10.1f ns/pkt\n", PktCnt, Secs*1e9/((double)Reps*PktCnt));
+
+   /* JSON load into an empty staged table, the reset isn't timed */
+   Fd = mkstemp(Filename);
+   if (Fd < 0) return false;
+   close(Fd);
+   if (!WriteJsonTbl(Filename, PktCnt))
+   {
+      remove(Filename);
+      return false;
+   }
+
+   Secs = 0.0;
+   for (Reps=0; Secs < BENCH_MIN_SECS; Reps++)
+   {
+      PKTTBL_SetTblToUnused(&TblData);
+      clock_gettime(CLOCK_MONOTONIC, &Start);
+      if (!LoadJsonFile(&TblData, Filename, &LoadCnt) || (TblData.ActiveCnt != PktCnt))
+      {
+         fprintf(stderr, "JSON load of %d packets failed, %d loaded\n", PktCnt, TblData.ActiveCnt);
+         remove(Filename);
+         return false;
+      }
+      Secs += ElapsedSecs(&Start);
+   }
+   printf("%6d  JSON load      %10.3f ms/table\n\n", PktCnt, Secs*1e3/Reps);
+
+   remove(Filename);
+
+   return true;
+
+} /* End RunBench() */
+
+
+/******************************************************************************
+** Function: main
+**
+*/
+int main(int argc, char *argv[])
+{
+
+   static const uint16 DefaultCnt[] = { 100, 1000, PKTTBL_MAX_SLOTS };
+   uint16 i, j, Tmp;
+   int    PktCnt;
+   bool   Passed = true;
+
+
+   /* AppIds are shuffled so entries aren't set in sorted order */
+   srand(1);
+   for (i=0; i < PKTTBL_MAX_SLOTS; i++) MsgIdList[i] = BENCH_MSG_ID_BASE + i;
+   for (i=PKTTBL_MAX_SLOTS-1; i > 0; i--)
+   {
+      j = rand() % (i+1);
+      Tmp = MsgIdList[i]; MsgIdList[i] = MsgIdList[j]; MsgIdList[j] = Tmp;
+   }
+
+   printf("Packets  Operation      Time\n");
+
+   if (argc > 1)
+   {
+      for (i=1; i < argc; i++)
+      {
+         PktCnt = atoi(argv[i]);
+         if ((PktCnt < 1) || (PktCnt > PKTTBL_MAX_SLOTS))
+         {
+            fprintf(stderr, "Table size %s must be 1..%d\n", argv[i], PKTTBL_MAX_SLOTS);
+            return 1;
+         }
+         Passed &= RunBench(PktCnt);
+      }
+   }
+   else
+   {
+      for (i=0; i < sizeof(DefaultCnt)/sizeof(DefaultCnt[0]); i++) Passed &= RunBench(DefaultCnt[i]);
+   }
+
+   return Passed ? 0 : 1;
+
+} /* End main() */
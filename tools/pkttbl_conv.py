@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+"""
+    Copyright 2022 bitValence, Inc.
+    All Rights Reserved.
+
+    This program is free software; you can modify and/or redistribute it
+    under the terms of the GNU Affero General Public License
+    as published by the Free Software Foundation; version 3 with
+    attribution addendums as found in the LICENSE.txt.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    Purpose:
+      Convert KIT_TO packet tables between the JSON text format and the
+      binary image format defined by PKTTBL_BinHdr_t and PKTTBL_BinPkt_t
+      in fsw/src/pkttbl.h.
+
+    Notes:
+      1. The conversion direction is determined by the input file extension.
+         A '.bin' input is converted to JSON, anything else is treated as a
+         JSON table and converted to a binary image.
+      2. Binary images use the target's native byte order. Use --big-endian
+         for big endian targets.
+      3. Profile names are stored in the header and each entry has a bit mask
+         of the profiles it belongs to. Entries without a "profiles" list
+         belong to all profiles.
+      4. The CRC matches CFE_ES_CalculateCRC() with the default mission CRC
+         type (CRC-16/ARC). Update crc16() if the mission changes
+         CFE_MISSION_ES_DEFAULT_CRC.
+
+    Usage:
+      pkttbl_conv.py cpu1_kit_to_pkt_tbl.json cpu1_kit_to_pkt_tbl.bin
+      pkttbl_conv.py cpu1_kit_to_pkt_tbl.bin  cpu1_kit_to_pkt_tbl.json
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+BIN_FILE_EXT = '.bin'
+BIN_MAGIC    = 0x5450544B
+BIN_VERSION  = 3
+
+PROFILE_MAX      = 8    # PKTTBL_PROFILE_MAX
+PROFILE_NAME_LEN = 16   # PKTTBL_PROFILE_NAME_LEN
+ALL_PROFILES     = 0xFF
+
+HDR_FMT = 'IHHHHHH%ds' % (PROFILE_MAX*PROFILE_NAME_LEN)  # Magic, Version, EntrySize, EntryCnt, Crc, ProfileCnt, Spare, ProfileName
+PKT_FMT = 'HBBHHHHHBBH'  # MsgId, Priority, Reliability, BufLim, FilterType, N, X, O, ProfileMask, Flags, MaxAge
+FLAG_COALESCE = 0x01     # PKTTBL_BIN_FLAG_COALESCE
+
+MAX_ENTRIES     = 2048  # PKTTBL_MAX_SLOTS
+UNUSED_MSG_ID   = 0
+
+
+def crc16(data):
+    """CRC-16/ARC: reflected polynomial 0xA001, initial value 0"""
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            if crc & 1:
+                crc = (crc >> 1) ^ 0xA001
+            else:
+                crc >>= 1
+    return crc
+
+
+def json_to_bin(json_file, bin_file, endian):
+
+    with open(json_file) as f:
+        tbl = json.load(f)
+
+    profiles = tbl.get('profiles', [])
+    if len(profiles) > PROFILE_MAX or len(set(profiles)) != len(profiles):
+        sys.exit('%s profiles must be unique with a maximum of %d' % (json_file, PROFILE_MAX))
+    for name in profiles:
+        if not 0 < len(name) < PROFILE_NAME_LEN:
+            sys.exit("Profile name '%s' must have 1 to %d characters" % (name, PROFILE_NAME_LEN-1))
+
+    pkt_fmt = endian + PKT_FMT
+    entries = {}
+    for i, item in enumerate(tbl['packet-array']):
+        pkt = item['packet']
+        msg_id = int(pkt['topic-id'])
+        if msg_id == UNUSED_MSG_ID or msg_id > 0xFFFF:
+            sys.exit('packet-array[%d] has invalid topic-id %d' % (i, msg_id))
+        flt = pkt['filter']
+        profile_mask = ALL_PROFILES
+        if 'profiles' in pkt:
+            profile_mask = 0
+            for name in pkt['profiles']:
+                if name not in profiles:
+                    sys.exit("packet-array[%d] references undefined profile '%s'" % (i, name))
+                profile_mask |= 1 << profiles.index(name)
+        # Later definitions replace earlier ones the same way the FSW load does
+        entries[msg_id] = struct.pack(pkt_fmt, msg_id, int(pkt['priority']),
+                                      int(pkt['reliability']), int(pkt['buf-limit']),
+                                      int(flt['type']), int(flt['N']),
+                                      int(flt['X']), int(flt['O']), profile_mask,
+                                      FLAG_COALESCE if int(pkt.get('coalesce', 0)) else 0,
+                                      int(pkt.get('max-age', 0)))
+
+    if not entries:
+        sys.exit('%s has no packets' % json_file)
+    if len(entries) > MAX_ENTRIES:
+        sys.exit('%s has %d packets, maximum is %d' % (json_file, len(entries), MAX_ENTRIES))
+
+    names = b''.join(name.encode().ljust(PROFILE_NAME_LEN, b'\0') for name in profiles)
+    names = names.ljust(PROFILE_MAX*PROFILE_NAME_LEN, b'\0')
+    pkt_data = b''.join(entries[msg_id] for msg_id in sorted(entries))
+    hdr = struct.pack(endian + HDR_FMT, BIN_MAGIC, BIN_VERSION,
+                      struct.calcsize(pkt_fmt), len(entries), crc16(names + pkt_data),
+                      len(profiles), 0, names)
+
+    with open(bin_file, 'wb') as f:
+        f.write(hdr + pkt_data)
+
+    print('Wrote %d packets to %s' % (len(entries), bin_file))
+
+
+def bin_to_json(bin_file, json_file, endian):
+
+    with open(bin_file, 'rb') as f:
+        image = f.read()
+
+    hdr_fmt = endian + HDR_FMT
+    pkt_fmt = endian + PKT_FMT
+    hdr_len = struct.calcsize(hdr_fmt)
+    pkt_len = struct.calcsize(pkt_fmt)
+
+    if len(image) < hdr_len:
+        sys.exit('%s is too short for a table header' % bin_file)
+
+    magic, version, entry_size, entry_cnt, crc, profile_cnt, _, names = struct.unpack_from(hdr_fmt, image)
+    if magic != BIN_MAGIC or version != BIN_VERSION or entry_size != pkt_len:
+        sys.exit('%s header mismatch: magic 0x%08X, version %d, entry size %d'
+                 % (bin_file, magic, version, entry_size))
+    if len(image) != hdr_len + entry_cnt * pkt_len or profile_cnt > PROFILE_MAX:
+        sys.exit('%s length %d inconsistent with %d entries and %d profiles'
+                 % (bin_file, len(image), entry_cnt, profile_cnt))
+
+    pkt_data = image[hdr_len:]
+    if crc16(names + pkt_data) != crc:
+        sys.exit('%s CRC 0x%04X does not match computed 0x%04X' % (bin_file, crc, crc16(names + pkt_data)))
+
+    profiles = [names[i*PROFILE_NAME_LEN:(i+1)*PROFILE_NAME_LEN].split(b'\0')[0].decode()
+                for i in range(profile_cnt)]
+    all_mask = (1 << profile_cnt) - 1
+
+    pkt_array = []
+    for msg_id, priority, reliability, buf_lim, flt_type, n, x, o, profile_mask, flags, max_age in struct.iter_unpack(pkt_fmt, pkt_data):
+        pkt = {'topic-id': msg_id,
+               'priority': priority,
+               'reliability': reliability,
+               'buf-limit': buf_lim}
+        if max_age != 0:
+            pkt['max-age'] = max_age
+        if flags & FLAG_COALESCE:
+            pkt['coalesce'] = 1
+        if profile_mask & all_mask != all_mask:
+            pkt['profiles'] = [name for i, name in enumerate(profiles) if profile_mask & (1 << i)]
+        pkt['filter'] = {'type': flt_type, 'X': x, 'N': n, 'O': o}
+        pkt_array.append({'packet': pkt})
+
+    tbl = {'name': 'Kit Telemetry Output (KIT_TO) Packet Table',
+           'description': 'Converted from %s' % bin_file}
+    if profiles:
+        tbl['profiles'] = profiles
+    tbl['packet-array'] = pkt_array
+
+    with open(json_file, 'w') as f:
+        json.dump(tbl, f, indent=3)
+        f.write('\n')
+
+    print('Wrote %d packets to %s' % (entry_cnt, json_file))
+
+
+if __name__ == '__main__':
+
+    parser = argparse.ArgumentParser(description='Convert KIT_TO packet tables between JSON and binary image formats')
+    parser.add_argument('infile')
+    parser.add_argument('outfile')
+    parser.add_argument('--big-endian', action='store_true', help='Target is big endian')
+    args = parser.parse_args()
+
+    endian = '>' if args.big_endian else '<'
+
+    if args.infile.endswith(BIN_FILE_EXT):
+        bin_to_json(args.infile, args.outfile, endian)
+    else:
+        json_to_bin(args.infile, args.outfile, endian)
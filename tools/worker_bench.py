@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""
+    Copyright 2022 bitValence, Inc.
+    All Rights Reserved.
+
+    This program is free software; you can modify and/or redistribute it
+    under the terms of the GNU Affero General Public License
+    as published by the Free Software Foundation; version 3 with
+    attribution addendums as found in the LICENSE.txt.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    Purpose:
+      Ground side output worker scaling benchmark. It receives KIT_TO
+      telemetry datagrams for a fixed time, reports the received packet and
+      byte rates and checks that each AppId's packets arrived in CCSDS
+      sequence count order.
+
+    Notes:
+      1. The worker count is read from PKTMGR_WORKERS at startup so KIT_TO
+         is restarted for each worker count. Run this once per count with
+         --workers set to the configured value and the same --csv file to
+         build a 1..K scaling table.
+      2. The packet source rate must exceed what one worker can send for the
+         rates to show scaling. KIT_TO's HK WorkerCycleMs and
+         WorkerPktCntMax/Min show the critical path and the AppId balance.
+      3. Output is only in order per AppId. A sequence count that goes
+         backwards is counted as a reorder. Gaps aren't reordering and are
+         reported separately as losses.
+
+    Usage:
+      worker_bench.py --workers 1 --duration 30 --csv bench.csv
+      worker_bench.py --workers 4 --duration 30 --csv bench.csv
+"""
+
+import argparse
+import os
+import socket
+import struct
+import time
+
+CCSDS_HDR_LEN   = 6
+APP_ID_MASK     = 0x07FF
+SEQ_CNT_MASK    = 0x3FFF
+SEQ_CNT_MOD     = 0x4000
+
+
+class OrderChecker:
+    """Count per-AppId sequence count reorders and gaps"""
+
+    def __init__(self):
+        self.last_seq = {}
+        self.reorder_cnt = 0
+        self.gap_cnt = 0
+
+    def update(self, datagram):
+        if len(datagram) < CCSDS_HDR_LEN:
+            return
+        stream_id, seq, _ = struct.unpack_from('>HHH', datagram)
+        app_id = stream_id & APP_ID_MASK
+        seq &= SEQ_CNT_MASK
+        if app_id in self.last_seq:
+            delta = (seq - self.last_seq[app_id]) % SEQ_CNT_MOD
+            if delta >= SEQ_CNT_MOD // 2:
+                self.reorder_cnt += 1
+                return
+            if delta > 1:
+                self.gap_cnt += 1
+        self.last_seq[app_id] = seq
+
+
+def main():
+
+    parser = argparse.ArgumentParser(description='KIT_TO output worker scaling benchmark')
+    parser.add_argument('--tlm-port', type=int, default=1235, help='KIT_TO telemetry UDP port (PKTMGR_UDP_TLM_PORT)')
+    parser.add_argument('--workers', type=int, required=True, help='PKTMGR_WORKERS value KIT_TO is running with')
+    parser.add_argument('--duration', type=float, default=30.0, help='Seconds to measure after the first datagram')
+    parser.add_argument('--csv', default='', help='Append a result row to this file')
+    args = parser.parse_args()
+
+    tlm_sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    tlm_sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4*1024*1024)
+    tlm_sock.bind(('', args.tlm_port))
+    tlm_sock.settimeout(1.0)
+
+    checker = OrderChecker()
+    rcv_cnt = 0
+    rcv_bytes = 0
+    start = None
+
+    print('Waiting for telemetry on port %d' % args.tlm_port)
+
+    while start is None or time.monotonic() - start < args.duration:
+        try:
+            datagram = tlm_sock.recv(65535)
+        except socket.timeout:
+            continue
+        if start is None:
+            start = time.monotonic()
+        rcv_cnt += 1
+        rcv_bytes += len(datagram)
+        checker.update(datagram)
+
+    elapsed = time.monotonic() - start
+    pkts_per_sec = rcv_cnt / elapsed
+    bytes_per_sec = rcv_bytes / elapsed
+
+    print('workers %d  %8.0f pkts/sec  %10.0f bytes/sec  AppIds %d  reorders %d  gaps %d'
+          % (args.workers, pkts_per_sec, bytes_per_sec, len(checker.last_seq),
+             checker.reorder_cnt, checker.gap_cnt))
+
+    if args.csv:
+        new_file = not os.path.exists(args.csv)
+        with open(args.csv, 'a') as csv:
+            if new_file:
+                csv.write('workers,pkts_per_sec,bytes_per_sec,app_ids,reorders,gaps\n')
+            csv.write('%d,%.0f,%.0f,%d,%d,%d\n' % (args.workers, pkts_per_sec, bytes_per_sec,
+                                                  len(checker.last_seq), checker.reorder_cnt,
+                                                  checker.gap_cnt))
+
+
+if __name__ == '__main__':
+    main()